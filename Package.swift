@@ -2,6 +2,25 @@
 // The swift-tools-version declares the minimum version of Swift required to build this package.
 
 import PackageDescription
+import Foundation
+
+/// Whether to support Zstandard-compressed archives.
+///
+/// Set `FSM_NO_ZSTD` in the environment to build without
+/// libzstd.  Reading or writing `.tar.zst` and `.tzst`
+/// archives then throws `FSMError.compressionUnavailable`.
+let usesZstd = ProcessInfo.processInfo.environment["FSM_NO_ZSTD"] == nil
+
+/// The libzstd module, unless building without it.
+let zstdTargets: [Target] = usesZstd ? [
+    .systemLibrary(name: "CZstd", pkgConfig: "libzstd", providers: [
+        .apt(["libzstd-dev"]),
+        .brew(["zstd"]),
+    ]),
+] : []
+
+/// The dependency of FSM on libzstd, unless building without it.
+let zstdDependencies: [Target.Dependency] = usesZstd ? ["CZstd"] : []
 
 let package = Package(
     name: "FSM",
@@ -11,19 +30,21 @@ let package = Package(
     products: [
         .library(name: "FSM", targets: ["FSM"]),
         .executable(name: "fsmconvert", targets: ["fsmconvert"]),
+        .executable(name: "fsmfuzz", targets: ["fsmfuzz"]),
     ],
     dependencies: [
         .package(url: "https://github.com/apple/swift-argument-parser", from: "1.2.0"),
         .package(url: "https://github.com/apple/swift-system", from: "1.2.0"),
     ],
-    targets: [
+    targets: zstdTargets + [
         .target(name: "FSM", dependencies: [
             .product(name: "SystemPackage", package: "swift-system"),
-        ]),
+        ] + zstdDependencies),
         .executableTarget(name: "fsmconvert", dependencies: [
             .product(name: "ArgumentParser", package: "swift-argument-parser"),
             "FSM"
         ]),
+        .executableTarget(name: "fsmfuzz", dependencies: ["FSM"]),
         .testTarget(name: "FSMTests", dependencies: ["FSM"]),
     ]
 )
@@ -0,0 +1,12 @@
+//
+//  shim.h
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+#ifndef CZSTD_SHIM_H
+#define CZSTD_SHIM_H
+
+#include <zstd.h>
+
+#endif // CZSTD_SHIM_H
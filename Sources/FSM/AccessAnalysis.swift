@@ -0,0 +1,400 @@
+//
+//  AccessAnalysis.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+import Foundation
+
+/// Estimated accesses of a machine to identifiers
+/// other than its own machine and state variables.
+public struct MachineAccesses: Equatable, Hashable {
+    /// Identifiers that are read.
+    public var reads = Set<String>()
+    /// Identifiers that are written (or have their address taken).
+    public var writes = Set<String>()
+    /// Functions that are called.
+    ///
+    /// The effects of calls are not analysed.
+    public var calls = Set<String>()
+
+    /// Designated initialiser.
+    ///
+    /// - Parameters:
+    ///   - reads: The identifiers that are read.
+    ///   - writes: The identifiers that are written.
+    ///   - calls: The functions that are called.
+    @inlinable
+    public init(reads: Set<String> = [], writes: Set<String> = [], calls: Set<String> = []) {
+        self.reads = reads
+        self.writes = writes
+        self.calls = calls
+    }
+
+    /// Merge the given accesses into the receiver.
+    ///
+    /// - Parameter other: The accesses to add.
+    @inlinable
+    public mutating func formUnion(_ other: MachineAccesses) {
+        reads.formUnion(other.reads)
+        writes.formUnion(other.writes)
+        calls.formUnion(other.calls)
+    }
+
+    /// Return the identifiers that conflict with the given accesses.
+    ///
+    /// Two machines conflict if one writes an identifier
+    /// the other one reads or writes.
+    ///
+    /// - Parameter other: The accesses to compare with.
+    /// - Returns: The conflicting identifiers.
+    @inlinable
+    public func conflicts(with other: MachineAccesses) -> Set<String> {
+        writes.intersection(other.reads.union(other.writes)).union(other.writes.intersection(reads))
+    }
+}
+
+/// Conflict between two arrangement instances.
+public struct InstanceConflict: Equatable, Hashable {
+    /// Index of the first instance.
+    public let first: Int
+    /// Index of the second instance.
+    public let second: Int
+    /// The shared identifiers causing the conflict.
+    public let identifiers: Set<String>
+}
+
+/// Read/write-set analysis of the instances of an arrangement.
+///
+/// The analysis estimates which identifiers outside their own
+/// variables the instances read and write in their actions
+/// and transition guards, builds the resulting conflict graph,
+/// and partitions the instances into independent groups
+/// (the connected components of the conflict graph)
+/// that can be executed in parallel.
+public struct AccessAnalysis {
+    /// The names of the analysed instances.
+    public let instances: [String]
+    /// The estimated accesses of each instance.
+    public let accesses: [MachineAccesses]
+    /// The edges of the conflict graph.
+    public let conflicts: [InstanceConflict]
+    /// The partition index of each instance.
+    public let partitions: [Int]
+
+    /// Analyse the given arrangement instances.
+    ///
+    /// - Parameter instances: The names and machines of the instances.
+    public init(instances: [(name: String, machine: Machine)]) {
+        self.instances = instances.map(\.name)
+        let machines = Set(instances.map { "fsm_" + $0.name.lowercased() })
+        accesses = instances.map { instance in
+            var access = instance.machine.externalAccesses
+            if access.writes.remove(anyMachine) != nil { access.writes.formUnion(machines) }
+            if access.reads.remove(anyMachine) != nil { access.reads.formUnion(machines) }
+            return access
+        }
+        // every instance reads and writes its own machine
+        let ownAccesses = instances.map { instance in
+            MachineAccesses(reads: ["fsm_" + instance.name.lowercased()], writes: ["fsm_" + instance.name.lowercased()])
+        }
+        var conflicts = [InstanceConflict]()
+        var parent = Array(instances.indices)
+        func root(_ i: Int) -> Int {
+            var i = i
+            while parent[i] != i { i = parent[i] }
+            return i
+        }
+        for i in accesses.indices {
+            for j in accesses.indices where j > i {
+                var (a, b) = (accesses[i], accesses[j])
+                a.formUnion(ownAccesses[i])
+                b.formUnion(ownAccesses[j])
+                let identifiers = a.conflicts(with: b)
+                guard !identifiers.isEmpty else { continue }
+                conflicts.append(InstanceConflict(first: i, second: j, identifiers: identifiers))
+                let (ri, rj) = (root(i), root(j))
+                parent[max(ri, rj)] = min(ri, rj)
+            }
+        }
+        self.conflicts = conflicts
+        var groups = [Int : Int]()
+        partitions = accesses.indices.map { i in
+            let r = root(i)
+            if let group = groups[r] { return group }
+            groups[r] = groups.count
+            return groups.count - 1
+        }
+    }
+
+    /// The number of independent groups.
+    @inlinable public var numberOfPartitions: Int {
+        (partitions.max() ?? -1) + 1
+    }
+
+    /// The instance indices of each independent group.
+    @inlinable public var groups: [[Int]] {
+        (0..<numberOfPartitions).map { group in
+            partitions.indices.filter { partitions[$0] == group }
+        }
+    }
+
+    /// Human-readable report of the analysis.
+    public var report: String {
+        let sorted = { (identifiers: Set<String>) in identifiers.sorted().joined(separator: ", ") }
+        let instanceReports = zip(instances, accesses).map { name, access in
+            "  \(name):\n" +
+            "    reads:  " + sorted(access.reads) + "\n" +
+            "    writes: " + sorted(access.writes) + "\n" +
+            "    calls:  " + sorted(access.calls) + "\n"
+        }
+        let conflictReports = conflicts.map {
+            "  \(instances[$0.first]) <-> \(instances[$0.second]): " + sorted($0.identifiers) + "\n"
+        }
+        let groupReports = groups.enumerated().map { i, group in
+            "  \(i): " + group.map { instances[$0] }.joined(separator: ", ") + "\n"
+        }
+        return "Accesses to external identifiers (estimated, calls are not analysed):\n" + instanceReports.joined() +
+        "Conflicts:\n" + (conflictReports.isEmpty ? "  (none)\n" : conflictReports.joined()) +
+        "Independent groups: \(numberOfPartitions)\n" + groupReports.joined()
+    }
+}
+
+public extension Machine {
+    /// Estimated accesses to identifiers other than
+    /// the machine's own machine and state variables.
+    ///
+    /// This scans the state actions and transition guards.
+    var externalAccesses: MachineAccesses {
+        let stateBoilerplates = llfsm.states.compactMap { stateBoilerplate[$0] }
+        let locals = stateBoilerplates.reduce(declaredIdentifiers(in: boilerplate.getSection(named: "variables"))) {
+            $0.union(declaredIdentifiers(in: $1.getSection(named: "variables")))
+        }
+        let actionNames = StateActivityName.allCases.map(\.rawValue)
+        var result = MachineAccesses()
+        for state in stateBoilerplates {
+            for action in actionNames {
+                result.formUnion(accesses(in: state.getSection(named: action), locals: locals))
+            }
+        }
+        for transition in llfsm.transitions.compactMap({ llfsm.transitionMap[$0] }) {
+            result.formUnion(accesses(in: transition.label, locals: locals))
+        }
+        return result
+    }
+}
+
+/// Lexical token of C-like code.
+enum CToken: Equatable {
+    /// An identifier or keyword.
+    case identifier(String)
+    /// An operator or punctuator.
+    case punctuation(String)
+    /// A numeric literal.
+    case number
+}
+
+/// Operators and punctuators, longest first.
+private let cPunctuators = ["<<=", ">>=", "->", "++", "--", "==", "!=", "<=", ">=", "&&", "||", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "<<", ">>"]
+
+/// Assignment operators.
+private let cAssignments: Set<String> = ["=", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "<<=", ">>="]
+
+/// Keywords that name types or qualifiers.
+private let cTypeKeywords: Set<String> = ["auto", "bool", "char", "const", "double", "enum", "extern", "float", "inline", "int", "long", "register", "restrict", "short", "signed", "static", "struct", "typedef", "union", "unsigned", "void", "volatile", "_Atomic", "_Bool"]
+
+/// Keywords that do not start a declaration.
+private let cStatementKeywords: Set<String> = ["break", "case", "continue", "default", "do", "else", "false", "for", "goto", "if", "return", "sizeof", "switch", "true", "while", "NULL", "machine", "state"]
+
+/// Macros that change the state of the given machine.
+private let cMachineControlMacros: Set<String> = ["SUSPEND", "RESUME", "RESTART"]
+
+/// Macros that query the state of the given machine.
+private let cMachineQueryMacros: Set<String> = ["IS_SUSPENSIBLE", "IS_SUSPENDED", "IS_IDLE"]
+
+/// Macros that change the state of all machines.
+private let cAllMachinesMacros: Set<String> = ["SUSPEND_ALL", "RESUME_ALL", "RESTART_ALL"]
+
+/// Pseudo identifier standing for any machine of the arrangement.
+let anyMachine = "fsm_*"
+
+/// Return the machine a macro argument refers to.
+///
+/// The machine is the last `fsm_<instance>` or
+/// `static_fsm_<instance>` identifier of the argument,
+/// e.g., `&static_fsm_sensor` or `arrangement->fsm_sensor`.
+///
+/// - Parameters:
+///   - tokens: The tokens of the code.
+///   - start: The index of the first token of the macro arguments.
+/// - Returns: `fsm_<instance>`, `machine` for the machine itself, or `anyMachine` if unknown.
+func machineReference(in tokens: [CToken], arguments start: Int) -> String {
+    var identifiers = [String]()
+    var depth = 1
+    var j = start
+    while j < tokens.count {
+        switch tokens[j] {
+        case .punctuation("("): depth += 1
+        case .punctuation(")"): depth -= 1
+        case .identifier(let name): identifiers.append(name)
+        default: break
+        }
+        if depth == 0 { break }
+        j += 1
+    }
+    if identifiers == ["machine"] { return "machine" }
+    guard let machine = identifiers.last(where: { $0.hasPrefix("fsm_") || $0.hasPrefix("static_fsm_") }) else { return anyMachine }
+    return machine.hasPrefix("static_") ? String(machine.dropFirst(7)) : machine
+}
+
+/// Split C code into tokens, skipping comments, string and character literals.
+///
+/// - Parameter code: The code to tokenise.
+/// - Returns: The tokens of the code.
+func cTokens(of code: String) -> [CToken] {
+    let chars = Array(code.unicodeScalars)
+    var tokens = [CToken]()
+    var i = 0
+    func isIdentifier(_ c: Unicode.Scalar) -> Bool { c == "_" || c.properties.isAlphabetic || ("0"..."9").contains(c) }
+    while i < chars.count {
+        let c = chars[i]
+        if c.properties.isWhitespace {
+            i += 1
+        } else if c == "/" && i + 1 < chars.count && chars[i+1] == "/" {
+            while i < chars.count && chars[i] != "\n" { i += 1 }
+        } else if c == "/" && i + 1 < chars.count && chars[i+1] == "*" {
+            i += 2
+            while i + 1 < chars.count && !(chars[i] == "*" && chars[i+1] == "/") { i += 1 }
+            i += 2
+        } else if c == "\"" || c == "'" {
+            i += 1
+            while i < chars.count && chars[i] != c { i += chars[i] == "\\" ? 2 : 1 }
+            i += 1
+        } else if c == "#" {
+            while i < chars.count && chars[i] != "\n" { i += 1 }
+        } else if ("0"..."9").contains(c) {
+            while i < chars.count && (isIdentifier(chars[i]) || chars[i] == ".") { i += 1 }
+            tokens.append(.number)
+        } else if isIdentifier(c) {
+            let start = i
+            while i < chars.count && isIdentifier(chars[i]) { i += 1 }
+            tokens.append(.identifier(String(String.UnicodeScalarView(chars[start..<i]))))
+        } else {
+            let rest = String(String.UnicodeScalarView(chars[i..<min(i + 3, chars.count)]))
+            let punctuator = cPunctuators.first { rest.hasPrefix($0) } ?? String(c)
+            tokens.append(.punctuation(punctuator))
+            i += punctuator.unicodeScalars.count
+        }
+    }
+    return tokens
+}
+
+/// Return the identifiers declared in the given variable declarations.
+///
+/// - Parameter declarations: The C declarations to examine.
+/// - Returns: The declared identifiers.
+func declaredIdentifiers(in declarations: String) -> Set<String> {
+    var identifiers = Set<String>()
+    var candidate: String?
+    var depth = 0
+    var isInitialiser = false
+    for token in cTokens(of: declarations) {
+        switch token {
+        case .punctuation("["), .punctuation("("), .punctuation("{"):
+            depth += 1
+        case .punctuation("]"), .punctuation(")"), .punctuation("}"):
+            depth -= 1
+        case .punctuation("=") where depth == 0:
+            isInitialiser = true
+        case .punctuation(";") where depth <= 0, .punctuation(",") where depth == 0:
+            if let candidate { identifiers.insert(candidate) }
+            candidate = nil
+            isInitialiser = false
+            depth = 0
+        case .identifier(let name) where !isInitialiser && depth == 0 && !cTypeKeywords.contains(name):
+            candidate = name
+        default:
+            break
+        }
+    }
+    return identifiers
+}
+
+/// Estimate the external accesses of the given code.
+///
+/// Identifiers are considered external unless they are declared
+/// locally, accessed as a struct member, all upper case (macros),
+/// or end in `_t` (type names).
+/// An identifier followed by an assignment, incremented,
+/// decremented, or having its address taken counts as a write.
+/// Machines controlled by `SUSPEND()`, `RESUME()`, or `RESTART()`
+/// count as written (as `fsm_<instance>`), machines queried through
+/// `IS_SUSPENDED()` and friends as read.  The `*_ALL()` macros and
+/// machines that cannot be resolved count as `fsm_*` (any machine).
+///
+/// - Parameters:
+///   - code: The action or guard code to examine.
+///   - locals: The identifiers local to the machine.
+/// - Returns: The estimated accesses.
+func accesses(in code: String, locals: Set<String>) -> MachineAccesses {
+    let tokens = cTokens(of: code)
+    var locals = locals
+    var result = MachineAccesses()
+    for (i, token) in tokens.enumerated() {
+        guard case .identifier(let name) = token,
+              !cTypeKeywords.contains(name), !cStatementKeywords.contains(name) else { continue }
+        let previous = i > 0 ? tokens[i-1] : nil
+        if previous == .punctuation(".") || previous == .punctuation("->") { continue }
+        if case .identifier(let type)? = previous, !cStatementKeywords.contains(type) {
+            locals.insert(name)
+            continue
+        }
+        if i + 1 < tokens.count && tokens[i+1] == .punctuation("(") {
+            if cMachineControlMacros.contains(name) || cMachineQueryMacros.contains(name) {
+                let machine = machineReference(in: tokens, arguments: i + 2)
+                guard machine != "machine" else { continue }
+                if cMachineControlMacros.contains(name) { result.writes.insert(machine) }
+                result.reads.insert(machine)
+            } else if cAllMachinesMacros.contains(name) {
+                result.writes.insert(anyMachine)
+                result.reads.insert(anyMachine)
+            } else {
+                result.calls.insert(name)
+            }
+            continue
+        }
+        guard !locals.contains(name), name.uppercased() != name, !name.hasSuffix("_t") else { continue }
+        let variable = name.hasPrefix("static_fsm_") ? String(name.dropFirst(7)) : name
+        var j = i + 1
+        chain: while j < tokens.count {
+            switch tokens[j] {
+            case .punctuation("."), .punctuation("->"):
+                j += 2
+            case .punctuation("["):
+                var depth = 0
+                repeat {
+                    if tokens[j] == .punctuation("[") { depth += 1 }
+                    if tokens[j] == .punctuation("]") { depth -= 1 }
+                    j += 1
+                } while depth > 0 && j < tokens.count
+            default:
+                break chain
+            }
+        }
+        let next = j < tokens.count ? tokens[j] : nil
+        let increments: [CToken?] = [.punctuation("++"), .punctuation("--")]
+        let isIncrement = increments.contains(previous) || increments.contains(next)
+        let isAssignment: Bool
+        if case .punctuation(let op)? = next { isAssignment = cAssignments.contains(op) } else { isAssignment = false }
+        let isUnary: Bool
+        if i < 2 { isUnary = true } else if case .punctuation(let op) = tokens[i-2] { isUnary = op != ")" && op != "]" } else { isUnary = false }
+        let isAddressTaken = previous == .punctuation("&") && isUnary
+        if isIncrement || isAssignment || isAddressTaken {
+            result.writes.insert(variable)
+        }
+        if !isAssignment || next != .punctuation("=") {
+            result.reads.insert(variable)
+        }
+    }
+    return result
+}
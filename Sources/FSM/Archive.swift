@@ -0,0 +1,614 @@
+//
+//  Archive.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+import Foundation
+#if canImport(CZstd)
+import CZstd
+#endif
+
+/// Archive formats for machines and arrangements.
+public enum ArchiveFormat: String, CaseIterable {
+    /// Uncompressed (POSIX ustar) tar archive.
+    case tar = ".tar"
+    /// Zstandard-compressed tar archive.
+    case zstdTar = ".tar.zst"
+    /// Zstandard-compressed tar archive (short extension).
+    case tzst = ".tzst"
+
+    /// Whether the tar stream is Zstandard-compressed.
+    public var isCompressed: Bool { self != .tar }
+
+#if canImport(CZstd)
+    /// Whether Zstandard-compressed archives can be read and written.
+    public static let isCompressionAvailable = true
+#else
+    /// Whether Zstandard-compressed archives can be read and written.
+    ///
+    /// This is `false`, as FSM was built without libzstd.
+    public static let isCompressionAvailable = false
+#endif
+
+    /// Determine the archive format of the given URL.
+    ///
+    /// - Parameter url: The URL whose extension to examine.
+    /// - Returns: The archive format, or `nil` if the URL does not denote an archive.
+    public init?(url: URL) {
+        let file = url.lastPathComponent.lowercased()
+        guard let format = ArchiveFormat.allCases.first(where: { file.hasSuffix($0.rawValue) && file.count > $0.rawValue.count }) else { return nil }
+        self = format
+    }
+
+    /// Return the name of the directory stored in an archive.
+    ///
+    /// - Parameter url: The URL of the archive.
+    /// - Returns: The last path component of the URL without the archive extension.
+    public static func directoryName(of url: URL) -> Filename {
+        let file = url.lastPathComponent
+        guard let format = ArchiveFormat(url: url) else { return file }
+        return String(file.dropLast(format.rawValue.count))
+    }
+}
+
+/// Streaming writer for POSIX (ustar) tar archives.
+///
+/// Entries are buffered and handed to the sink in large chunks,
+/// so the archive can be written (and compressed) without ever
+/// holding the whole archive in memory.
+@usableFromInline
+struct TarWriter {
+    /// The size of a tar block.
+    @usableFromInline static let blockSize = 512
+    /// The number of bytes to buffer before passing them to the sink.
+    @usableFromInline static let chunkSize = 1 << 20
+    /// The destination of the archive data.
+    @usableFromInline let sink: (Data) throws -> Void
+    /// The modification time to record for all entries.
+    @usableFromInline let modificationTime: Int
+    /// The data not yet passed to the sink.
+    @usableFromInline var buffer = Data()
+
+    /// Create a tar writer.
+    ///
+    /// - Parameters:
+    ///   - modificationTime: The modification time (in seconds since 1970) to record.
+    ///   - sink: The destination of the archive data.
+    @usableFromInline
+    init(modificationTime: Int = Int(Date().timeIntervalSince1970), sink: @escaping (Data) throws -> Void) {
+        self.modificationTime = modificationTime
+        self.sink = sink
+        buffer.reserveCapacity(TarWriter.chunkSize + TarWriter.blockSize)
+    }
+
+    /// Append a directory entry.
+    ///
+    /// - Parameter path: The path of the directory within the archive.
+    @usableFromInline
+    mutating func append(directory path: String) throws {
+        try appendEntry(path: path.hasSuffix("/") ? path : path + "/", type: "5", mode: 0o755, contents: Data())
+    }
+
+    /// Append a regular file entry.
+    ///
+    /// - Parameters:
+    ///   - path: The path of the file within the archive.
+    ///   - contents: The content of the file.
+    @usableFromInline
+    mutating func append(file path: String, contents: Data) throws {
+        try appendEntry(path: path, type: "0", mode: 0o644, contents: contents)
+    }
+
+    /// Append the given file wrapper (recursively).
+    ///
+    /// Children are archived in name order, so the
+    /// same tree always results in the same archive.
+    /// Symbolic links are skipped.
+    ///
+    /// - Parameters:
+    ///   - fileWrapper: The file wrapper to archive.
+    ///   - path: The path of the file wrapper within the archive.
+    @usableFromInline
+    mutating func append(_ fileWrapper: FileWrapper, at path: String) throws {
+        if fileWrapper.isDirectory {
+            try append(directory: path)
+            for (file, child) in (fileWrapper.fileWrappers ?? [:]).sorted(by: { $0.key < $1.key }) {
+                try append(child, at: path + "/" + file)
+            }
+        } else if fileWrapper.isRegularFile {
+            try append(file: path, contents: fileWrapper.regularFileContents ?? Data())
+        }
+    }
+
+    /// Finish the archive.
+    ///
+    /// This appends the two terminating zero blocks
+    /// and passes any buffered data to the sink.
+    @usableFromInline
+    mutating func finish() throws {
+        buffer.append(Data(count: 2 * TarWriter.blockSize))
+        try sink(buffer)
+        buffer.removeAll()
+    }
+
+    /// Append an entry, using a pax header for long paths.
+    ///
+    /// - Parameters:
+    ///   - path: The path of the entry.
+    ///   - type: The tar type flag.
+    ///   - mode: The permissions of the entry.
+    ///   - contents: The content of the entry.
+    @usableFromInline
+    mutating func appendEntry(path: String, type: Character, mode: Int, contents: Data) throws {
+        let names = TarWriter.split(path: path)
+        if names == nil {
+            let record = TarWriter.paxRecord(key: "path", value: path)
+            appendHeader(name: "PaxHeaders/" + TarWriter.suffix(of: path, length: 80), prefix: "", type: "x", mode: 0o644, size: record.count)
+            appendPadded(record)
+        }
+        appendHeader(name: names?.name ?? TarWriter.suffix(of: path, length: 100), prefix: names?.prefix ?? "", type: type, mode: mode, size: contents.count)
+        appendPadded(contents)
+        if buffer.count >= TarWriter.chunkSize {
+            try sink(buffer)
+            buffer.removeAll(keepingCapacity: true)
+        }
+    }
+
+    /// Append a header block.
+    ///
+    /// - Parameters:
+    ///   - name: The name field (at most 100 bytes).
+    ///   - prefix: The prefix field (at most 155 bytes).
+    ///   - type: The tar type flag.
+    ///   - mode: The permissions of the entry.
+    ///   - size: The size of the entry content.
+    @usableFromInline
+    mutating func appendHeader(name: String, prefix: String, type: Character, mode: Int, size: Int) {
+        var header = [UInt8](repeating: 0, count: TarWriter.blockSize)
+        func set(_ offset: Int, _ length: Int, _ string: String) {
+            for (i, byte) in string.utf8.prefix(length).enumerated() { header[offset + i] = byte }
+        }
+        func octal(_ offset: Int, _ length: Int, _ value: Int) {
+            let digits = String(value, radix: 8)
+            set(offset, length - 1, String(repeating: "0", count: max(0, length - 1 - digits.count)) + digits)
+        }
+        set(0, 100, name)
+        octal(100, 8, mode)
+        octal(108, 8, 0)
+        octal(116, 8, 0)
+        octal(124, 12, size)
+        octal(136, 12, modificationTime)
+        set(148, 8, "        ")
+        set(156, 1, String(type))
+        set(257, 6, "ustar")
+        set(263, 2, "00")
+        set(345, 155, prefix)
+        let checksum = header.reduce(0) { $0 + Int($1) }
+        set(148, 8, String(repeating: "0", count: max(0, 6 - String(checksum, radix: 8).count)) + String(checksum, radix: 8) + "\0 ")
+        buffer.append(contentsOf: header)
+    }
+
+    /// Append the given data, padded to a multiple of the block size.
+    ///
+    /// - Parameter data: The data to append.
+    @usableFromInline
+    mutating func appendPadded(_ data: Data) {
+        buffer.append(data)
+        let remainder = data.count % TarWriter.blockSize
+        if remainder != 0 { buffer.append(Data(count: TarWriter.blockSize - remainder)) }
+    }
+
+    /// Split a path into the ustar prefix and name fields.
+    ///
+    /// - Parameter path: The path to split.
+    /// - Returns: The prefix and name, or `nil` if the path needs a pax header.
+    @usableFromInline
+    static func split(path: String) -> (prefix: String, name: String)? {
+        let bytes = Array(path.utf8)
+        guard bytes.count > 100 else { return ("", path) }
+        guard bytes.count <= 256 else { return nil }
+        for i in bytes.indices.reversed() where bytes[i] == UInt8(ascii: "/") && i <= 155 {
+            guard bytes.count - i - 1 <= 100 else { return nil }
+            guard i > 0, i < bytes.count - 1 else { continue }
+            return (String(decoding: bytes[..<i], as: UTF8.self), String(decoding: bytes[(i + 1)...], as: UTF8.self))
+        }
+        return nil
+    }
+
+    /// Return the longest suffix of a path that fits into a header field.
+    ///
+    /// The suffix starts at a Unicode scalar boundary,
+    /// so the field does not contain partial UTF-8 sequences.
+    ///
+    /// - Parameters:
+    ///   - path: The path to truncate.
+    ///   - length: The maximum length in UTF-8 bytes.
+    /// - Returns: The truncated path.
+    @usableFromInline
+    static func suffix(of path: String, length: Int) -> String {
+        let scalars = path.unicodeScalars
+        var start = scalars.endIndex
+        var count = 0
+        while start > scalars.startIndex {
+            let previous = scalars.index(before: start)
+            count += UTF8.width(scalars[previous])
+            guard count <= length else { break }
+            start = previous
+        }
+        return String(scalars[start...])
+    }
+
+    /// Return a pax extended header record.
+    ///
+    /// The record has the form `<length> <key>=<value>\n`,
+    /// where the length includes its own digits.
+    ///
+    /// - Parameters:
+    ///   - key: The keyword of the record.
+    ///   - value: The value of the record.
+    /// - Returns: The encoded record.
+    @usableFromInline
+    static func paxRecord(key: String, value: String) -> Data {
+        let body = " " + key + "=" + value + "\n"
+        var length = body.utf8.count + 1
+        while String(length).count + body.utf8.count != length { length = String(length).count + body.utf8.count }
+        return Data((String(length) + body).utf8)
+    }
+}
+
+/// Read the entries of a tar archive into a file wrapper tree.
+///
+/// This understands ustar prefixes, pax `path` records, and
+/// GNU long names.  Absolute paths and `..` components are
+/// ignored, so an archive cannot escape its root.
+/// Symbolic and hard links are rejected, as machines
+/// and arrangements only consist of regular files.
+///
+/// - Parameter data: The (uncompressed) tar archive.
+/// - Throws: `FSMError.invalidArchive` if the archive is malformed or contains links.
+/// - Returns: The top-level file wrappers by file name.
+@usableFromInline
+func tarFileWrappers(from data: Data) throws -> [String : FileWrapper] {
+    let bytes = [UInt8](data)
+    let blockSize = TarWriter.blockSize
+    var root = TarDirectory()
+    var offset = 0
+    var longName: String?
+    let ustarMagic = Array("ustar\0".utf8)
+    func field(_ start: Int, _ length: Int) -> String {
+        let slice = bytes[(offset + start)..<(offset + start + length)]
+        return String(decoding: slice.prefix { $0 != 0 }, as: UTF8.self)
+    }
+    while offset + blockSize <= bytes.count {
+        guard bytes[offset..<(offset + blockSize)].contains(where: { $0 != 0 }) else { break }
+        let sizeField = field(124, 12).trimmingCharacters(in: .whitespaces)
+        guard let size = Int(sizeField.isEmpty ? "0" : sizeField, radix: 8), size >= 0 else { throw FSMError.invalidArchive }
+        let type = bytes[offset + 156]
+        // GNU headers ("ustar  ") store the access time where ustar stores the prefix
+        let prefix = bytes[(offset + 257)..<(offset + 263)].elementsEqual(ustarMagic) ? field(345, 155) : ""
+        let headerName = prefix.isEmpty ? field(0, 100) : prefix + "/" + field(0, 100)
+        let start = offset + blockSize
+        guard start + size <= bytes.count else { throw FSMError.invalidArchive }
+        let contents = Data(bytes[start..<(start + size)])
+        offset = start + (size + blockSize - 1) / blockSize * blockSize
+        switch type {
+        case UInt8(ascii: "x"):
+            longName = paxPath(in: contents) ?? longName
+            continue
+        case UInt8(ascii: "L"):
+            longName = String(decoding: contents.prefix { $0 != 0 }, as: UTF8.self)
+            continue
+        case UInt8(ascii: "g"):
+            continue
+        case UInt8(ascii: "1"), UInt8(ascii: "2"):
+            throw FSMError.invalidArchive
+        default:
+            break
+        }
+        let path = longName ?? headerName
+        longName = nil
+        let components = path.split(separator: "/").map(String.init).filter { $0 != "." && $0 != ".." }
+        guard !components.isEmpty else { continue }
+        if type == UInt8(ascii: "5") {
+            root.insert(directory: components)
+        } else if type == UInt8(ascii: "0") || type == 0 {
+            root.insert(file: components, contents: contents)
+        }
+    }
+    return root.fileWrappers
+}
+
+/// Return the path contained in pax extended header records.
+///
+/// - Parameter data: The records of a pax extended header.
+/// - Returns: The value of the `path` record, if any.
+@usableFromInline
+func paxPath(in data: Data) -> String? {
+    var path: String?
+    var records = Substring(String(decoding: data, as: UTF8.self))
+    while let space = records.firstIndex(of: " "), let length = Int(records[..<space]), length > 0,
+          let end = records.utf8.index(records.startIndex, offsetBy: length, limitedBy: records.endIndex) {
+        let record = records[records.index(after: space)..<end].dropLast()
+        if let equals = record.firstIndex(of: "="), record[..<equals] == "path" {
+            path = String(record[record.index(after: equals)...])
+        }
+        records = records[end...]
+    }
+    return path
+}
+
+/// Directory tree under construction while reading an archive.
+@usableFromInline
+struct TarDirectory {
+    /// The files in this directory.
+    @usableFromInline var files = [String : Data]()
+    /// The subdirectories of this directory.
+    @usableFromInline var directories = [String : TarDirectory]()
+
+    @usableFromInline init() {}
+
+    /// Insert a directory.
+    ///
+    /// - Parameter components: The path components of the directory.
+    @usableFromInline
+    mutating func insert(directory components: ArraySlice<String>) {
+        guard let first = components.first else { return }
+        directories[first, default: TarDirectory()].insert(directory: components.dropFirst())
+    }
+
+    /// Insert a directory.
+    ///
+    /// - Parameter components: The path components of the directory.
+    @usableFromInline
+    mutating func insert(directory components: [String]) {
+        insert(directory: components[...])
+    }
+
+    /// Insert a regular file.
+    ///
+    /// - Parameters:
+    ///   - components: The path components of the file.
+    ///   - contents: The content of the file.
+    @usableFromInline
+    mutating func insert(file components: [String], contents: Data) {
+        guard let last = components.last else { return }
+        insert(file: last, contents: contents, in: components.dropLast())
+    }
+
+    /// Insert a regular file into a subdirectory.
+    ///
+    /// - Parameters:
+    ///   - name: The name of the file.
+    ///   - contents: The content of the file.
+    ///   - components: The path components of the directory containing the file.
+    @usableFromInline
+    mutating func insert(file name: String, contents: Data, in components: ArraySlice<String>) {
+        guard let first = components.first else {
+            files[name] = contents
+            return
+        }
+        directories[first, default: TarDirectory()].insert(file: name, contents: contents, in: components.dropFirst())
+    }
+
+    /// The file wrappers for the content of this directory.
+    @usableFromInline
+    var fileWrappers: [String : FileWrapper] {
+        var children = [String : FileWrapper]()
+        for (name, contents) in files {
+            children[name] = fileWrapper(named: name, from: contents)
+        }
+        for (name, directory) in directories {
+            let child = FileWrapper(directoryWithFileWrappers: directory.fileWrappers)
+            child.preferredFilename = name
+            children[name] = child
+        }
+        return children
+    }
+}
+
+#if canImport(CZstd)
+/// Streaming Zstandard compressor.
+@usableFromInline
+final class ZstdCompressor {
+    /// The compression context.
+    @usableFromInline let context: OpaquePointer
+    /// The destination of the compressed data.
+    @usableFromInline let sink: (Data) throws -> Void
+    /// The output buffer.
+    @usableFromInline var output: [UInt8]
+
+    /// Create a compressor.
+    ///
+    /// - Parameters:
+    ///   - level: The compression level.
+    ///   - sink: The destination of the compressed data.
+    /// - Throws: `FSMError.compressionFailed` if the compressor cannot be created.
+    @usableFromInline
+    init(level: Int32 = 3, sink: @escaping (Data) throws -> Void) throws {
+        guard let context = ZSTD_createCCtx() else { throw FSMError.compressionFailed }
+        self.context = context
+        self.sink = sink
+        output = [UInt8](repeating: 0, count: ZSTD_CStreamOutSize())
+        guard ZSTD_isError(ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, level)) == 0 else {
+            throw FSMError.compressionFailed
+        }
+    }
+
+    deinit {
+        ZSTD_freeCCtx(context)
+    }
+
+    /// Compress the given data.
+    ///
+    /// - Parameter data: The data to compress.
+    @usableFromInline
+    func write(_ data: Data) throws {
+        try compress(data, directive: ZSTD_e_continue)
+    }
+
+    /// Finish the compressed frame.
+    @usableFromInline
+    func finish() throws {
+        try compress(Data(), directive: ZSTD_e_end)
+    }
+
+    /// Compress the given data and pass the output to the sink.
+    ///
+    /// - Parameters:
+    ///   - data: The data to compress.
+    ///   - directive: Whether to continue or end the frame.
+    @usableFromInline
+    func compress(_ data: Data, directive: ZSTD_EndDirective) throws {
+        try data.withUnsafeBytes { raw in
+            var input = ZSTD_inBuffer(src: raw.baseAddress, size: raw.count, pos: 0)
+            var isDone = false
+            repeat {
+                var produced = 0
+                let remaining = try output.withUnsafeMutableBytes { out -> Int in
+                    var buffer = ZSTD_outBuffer(dst: out.baseAddress, size: out.count, pos: 0)
+                    let result = ZSTD_compressStream2(context, &buffer, &input, directive)
+                    guard ZSTD_isError(result) == 0 else { throw FSMError.compressionFailed }
+                    produced = buffer.pos
+                    return result
+                }
+                if produced > 0 { try sink(Data(output[..<produced])) }
+                isDone = directive == ZSTD_e_end ? remaining == 0 : input.pos == input.size
+            } while !isDone
+        }
+    }
+}
+
+/// Decompress Zstandard-compressed data.
+///
+/// - Parameter data: The compressed data (one or more frames).
+/// - Throws: `FSMError.compressionFailed` if the data cannot be decompressed,
+///           `FSMError.invalidArchive` if the last frame is truncated.
+/// - Returns: The decompressed data.
+@usableFromInline
+func zstdDecompress(_ data: Data) throws -> Data {
+    guard let context = ZSTD_createDCtx() else { throw FSMError.compressionFailed }
+    defer { ZSTD_freeDCtx(context) }
+    var result = Data()
+    var output = [UInt8](repeating: 0, count: ZSTD_DStreamOutSize())
+    try data.withUnsafeBytes { raw in
+        var input = ZSTD_inBuffer(src: raw.baseAddress, size: raw.count, pos: 0)
+        var produced = 0
+        var remaining = 0
+        repeat {
+            produced = try output.withUnsafeMutableBytes { out -> Int in
+                var buffer = ZSTD_outBuffer(dst: out.baseAddress, size: out.count, pos: 0)
+                remaining = ZSTD_decompressStream(context, &buffer, &input)
+                guard ZSTD_isError(remaining) == 0 else { throw FSMError.compressionFailed }
+                return buffer.pos
+            }
+            result.append(contentsOf: output[..<produced])
+        } while input.pos < input.size || produced == output.count
+        // A non-zero hint means the decoder expects more input.
+        guard remaining == 0 else { throw FSMError.invalidArchive }
+    }
+    return result
+}
+#else
+/// Placeholder for the Zstandard compressor.
+///
+/// FSM was built without libzstd, so this always fails.
+@usableFromInline
+final class ZstdCompressor {
+    /// Fail to create a compressor.
+    ///
+    /// - Parameters:
+    ///   - level: The compression level.
+    ///   - sink: The destination of the compressed data.
+    /// - Throws: `FSMError.compressionUnavailable`.
+    @usableFromInline
+    init(level: Int32 = 3, sink: @escaping (Data) throws -> Void) throws {
+        throw FSMError.compressionUnavailable
+    }
+
+    /// Compress the given data.
+    ///
+    /// - Parameter data: The data to compress.
+    @usableFromInline
+    func write(_ data: Data) throws {}
+
+    /// Finish the compressed frame.
+    @usableFromInline
+    func finish() throws {}
+}
+
+/// Fail to decompress Zstandard-compressed data.
+///
+/// - Parameter data: The compressed data.
+/// - Throws: `FSMError.compressionUnavailable`, as FSM was built without libzstd.
+/// - Returns: Never.
+@usableFromInline
+func zstdDecompress(_ data: Data) throws -> Data {
+    throw FSMError.compressionUnavailable
+}
+#endif
+
+extension FileWrapper {
+    /// Write the file wrapper to a (possibly compressed) tar archive.
+    ///
+    /// The tree is streamed into the archive (and compressor),
+    /// rather than written as individual files.
+    ///
+    /// - Parameters:
+    ///   - url: The URL of the archive to create.
+    ///   - format: The archive format.
+    ///   - name: The name of the top-level directory inside the archive.
+    /// - Throws: Any compression or file system error,
+    ///           in which case no (partial) archive is left behind.
+    @usableFromInline
+    func writeArchive(to url: URL, format: ArchiveFormat, named name: Filename) throws {
+        var output: FileHandle?
+        let compressor: ZstdCompressor?
+        if format.isCompressed {
+            compressor = try ZstdCompressor { try output?.write(contentsOf: $0) }
+        } else {
+            compressor = nil
+        }
+        guard FileManager.default.createFile(atPath: url.path, contents: nil) else {
+            throw POSIXError(.EACCES)
+        }
+        do {
+            let handle = try FileHandle(forWritingTo: url)
+            output = handle
+            defer { try? handle.close() }
+            var writer = TarWriter { data in
+                if let compressor { try compressor.write(data) } else { try handle.write(contentsOf: data) }
+            }
+            try writer.append(self, at: name)
+            try writer.finish()
+            try compressor?.finish()
+        } catch {
+            try? FileManager.default.removeItem(at: url)
+            throw error
+        }
+    }
+}
+
+/// Read the content of a machine or arrangement directory.
+///
+/// For an archive, this returns the top-level directory
+/// inside the archive (or the whole archive content, if
+/// it does not consist of a single directory).
+///
+/// - Parameters:
+///   - url: The URL of the directory or archive.
+///   - options: The reading options to use.
+/// - Returns: The name and the children of the directory.
+@usableFromInline
+func directoryContents(at url: URL, options: FileWrapper.ReadingOptions = []) throws -> (name: Filename, children: [String : FileWrapper]) {
+    guard let format = ArchiveFormat(url: url) else {
+        let wrapper = try FileWrapper(url: url, options: options)
+        return (url.lastPathComponent, wrapper.fileWrappers ?? [:])
+    }
+    let data = try Data(contentsOf: url, options: .mappedIfSafe)
+    let children = try tarFileWrappers(from: format.isCompressed ? zstdDecompress(data) : data)
+    if children.count == 1, let child = children.first, child.value.isDirectory {
+        return (child.key, child.value.fileWrappers ?? [:])
+    }
+    return (ArchiveFormat.directoryName(of: url), children)
+}
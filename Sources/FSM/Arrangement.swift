@@ -10,12 +10,21 @@ import Foundation
 public struct Arrangement {
     /// The FSMs in this arrangement.
     public var machines: [Machine]
+    /// The message channels between machine instances.
+    public var channels: [Channel]
+    /// The snapshot variables to record or replay.
+    public var snapshotVariables: [SnapshotVariable]
 
     /// Designated initialiser.
-    /// - Parameter machines: The machines in this arrangement.
+    /// - Parameters:
+    ///   - machines: The machines in this arrangement.
+    ///   - channels: The channels connecting the machine instances.
+    ///   - snapshotVariables: The machine variables captured by `TAKE_SNAPSHOT()`.
     @inlinable
-    public init(machines: [Machine]) {
+    public init(machines: [Machine], channels: [Channel] = [], snapshotVariables: [SnapshotVariable] = []) {
         self.machines = machines
+        self.channels = channels
+        self.snapshotVariables = snapshotVariables
     }
     /// Add the arrangement to the given `ArrangementWrapper`.
     ///
@@ -30,6 +39,21 @@ public struct Arrangement {
     /// - Returns: The filenames of the machines for adding to the arrangement.
     @inlinable
     public func add(to wrapper: ArrangementWrapper, language: any OutputLanguage, machineNames: [String], isSuspensible: Bool = true) throws -> [Filename] {
+        let instances = try self.instances(machineNames: machineNames)
+        try add(instances: instances, to: wrapper, language: language, isSuspensible: isSuspensible)
+        return machineFilenames(of: instances)
+    }
+    /// Return the validated instances of the arrangement.
+    ///
+    /// This method assigns unique instance names to the
+    /// machines and checks that the channels and snapshot
+    /// variables refer to existing instances.
+    ///
+    /// - Parameter machineNames: The names associated with the FSMs.
+    /// - Throws: `FSMError.invalidChannel` or `FSMError.invalidSnapshotVariable`.
+    /// - Returns: The machine instances of the arrangement.
+    @inlinable
+    public func instances(machineNames: [String]) throws -> [Instance] {
         var instanceMappings = [ String : (String, Machine) ]()
         let instances = zip(machines, machineNames).map {
             let machine = $0.0
@@ -50,12 +74,52 @@ public struct Arrangement {
             instanceMappings[uniqueName] = (resolvedFile, resolvedMachine)
             return Instance(name: uniqueName, typeFile: resolvedFile, fsm: resolvedMachine.llfsm)
         }
-        let machineFiles = instances.map(\.typeFile)
-        try language.addLanguage(to: wrapper)
-        try language.addArrangementInterface(for: instances, to: wrapper, isSuspensible: isSuspensible)
-        try language.addArrangementCode(for: instances, to: wrapper, isSuspensible: isSuspensible)
-        try language.addArrangementCMakeFile(for: instances, to: wrapper, isSuspensible: isSuspensible)
-        return machineFiles.map {
+        let instanceNames = Set(instances.map(\.name))
+        guard channels.allSatisfy({ instanceNames.contains($0.producer) && instanceNames.contains($0.consumer) }),
+              Set(channels.map(\.name)).count == channels.count else {
+            throw FSMError.invalidChannel
+        }
+        guard snapshotVariables.allSatisfy({ instanceNames.contains($0.instance) }),
+              Set(snapshotVariables.map { $0.instance + "." + $0.name }).count == snapshotVariables.count else {
+            throw FSMError.invalidSnapshotVariable
+        }
+        return instances
+    }
+    /// Add the arrangement-level files for the given instances.
+    ///
+    /// - Parameters:
+    ///   - instances: The validated machine instances.
+    ///   - wrapper: The output `ArrangementWrapper` to add to.
+    ///   - language: The output language format to use.
+    ///   - isSuspensible: Whether the output FSMs should be suspensible.
+    @inlinable
+    public func add(instances: [Instance], to wrapper: ArrangementWrapper, language: any OutputLanguage, isSuspensible: Bool = true) throws {
+        try wrapper.buildFileWrappers { wrapper in
+            try language.addLanguage(to: wrapper)
+            try language.addArrangementInterface(for: instances, to: wrapper, isSuspensible: isSuspensible)
+            try language.addArrangementCode(for: instances, to: wrapper, isSuspensible: isSuspensible)
+            try language.addArrangementCMakeFile(for: instances, to: wrapper, isSuspensible: isSuspensible)
+        }
+    }
+    /// Return the machines of the given instances by type file.
+    ///
+    /// The instances are created in the order of `machines`,
+    /// so each instance gets matched with the machine at
+    /// the same position, keyed by its type file.
+    ///
+    /// - Parameter instances: The validated machine instances.
+    /// - Returns: The machine of each type file.
+    @inlinable
+    public func machineTypes(of instances: [Instance]) -> [Filename : Machine] {
+        Dictionary(zip(instances, machines).map { ($0.typeFile, $1) }, uniquingKeysWith: { a, _ in a })
+    }
+    /// Return the machine filenames of the given instances.
+    ///
+    /// - Parameter instances: The machine instances.
+    /// - Returns: The filenames of the machines for adding to the arrangement.
+    @inlinable
+    public func machineFilenames(of instances: [Instance]) -> [Filename] {
+        instances.map(\.typeFile).map {
             $0.hasSuffix(".machine") ? $0 : ($0 + ".machine")
         }
     }
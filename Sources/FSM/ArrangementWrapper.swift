@@ -15,6 +15,40 @@ open class ArrangementWrapper: DirectoryWrapper {
     public var language: any LanguageBinding
     /// Whether or onot the arrangement supports suspension
     public var isSuspensible = true
+    /// Whether or not to generate static introspection tables
+    public var isIntrospectable = false
+    /// Whether or not to generate a table-driven executor
+    /// instead of functions for each state
+    public var isTableDriven = false
+    /// Whether or not to place USDT probes for tracing
+    public var isTraceable = false
+    /// Whether or not to inline guards and actions
+    /// instead of including them
+    public var isInlined = false
+    /// Whether or not to export machine states to shared memory
+    /// and generate a live monitor
+    public var isExportable = false
+    /// Whether or not to support reloading machines at runtime
+    public var isReloadable = false
+    /// Whether or not to generate checkpoint and restore functions
+    public var isCheckpointable = false
+    /// Whether or not to generate a reachable-configuration explorer
+    /// (this implies re-entrant contexts and checkpoints)
+    public var isExplorable = false
+    /// Whether or not to generate re-entrant contexts
+    /// and a Monte-Carlo simulation driver
+    public var isSimulatable = false
+    /// Whether or not to generate the instance partition
+    /// of the read/write-set analysis
+    public var isPartitioned = false
+    /// Whether or not to generate an executor benchmark
+    /// (this implies checkpoints)
+    public var isBenchmarkable = false
+    /// Whether or not checkpoint and restore functions
+    /// get generated (directly or as implied by another option)
+    @inlinable public var hasCheckpoints: Bool {
+        isCheckpointable || isExplorable || isBenchmarkable
+    }
 
     /// Create a file wrapper for a directory with the given children.
     /// - Parameters:
@@ -40,33 +74,131 @@ open class ArrangementWrapper: DirectoryWrapper {
     /// Write the content of the arrangement to the specified location.
     ///
     /// Recursively writes the entire arrangement to the specified location.
+    /// The machines are generated and written concurrently (bounded
+    /// by the number of cores), in parallel with the arrangement-level
+    /// files, as they do not depend on each other.
+    /// If the URL has a `.tar`, `.tar.zst`, or `.tzst` extension,
+    /// nothing is written until the whole arrangement has been
+    /// generated, which is then streamed into a single archive.
+    /// Machine wrappers that are not an instance of the
+    /// arrangement are rejected in either case.
     ///
     /// - Note: This requires that the `language` is a valid output language.
     /// - Parameters:
     ///   - url: The URL of the location to write to.
     ///   - options: The writing options to use.
     ///   - originalContentsURL: The original URL of the file wrapper.
+    /// - Throws: `ArrangementError` listing each machine that could not be written
+    ///           (`FSMError.unknownMachine` for wrappers without an instance).
     override open func write(to url: URL, options: FileWrapper.WritingOptions = [], originalContentsURL: URL? = nil) throws {
         guard let destination = language as? (any OutputLanguage) else {
             throw FSMError.unsupportedOutputFormat
         }
-        preferredFilename = url.lastPathComponent
+        let format = ArchiveFormat(url: url)
+        preferredFilename = ArchiveFormat.directoryName(of: url)
         let wrapperNames = fileWrappers?.keys.map {$0} ?? []
         let wrappersAndNames: [(MachineWrapper, Filename)] = wrapperNames.compactMap {
             guard let wrapper = fileWrappers?[$0] as? MachineWrapper else { return nil }
             wrapper.language = language
+            wrapper.isIntrospectable = isIntrospectable
+            wrapper.isTableDriven = isTableDriven
+            wrapper.isTraceable = isTraceable
+            wrapper.isInlined = isInlined
             return (wrapper, $0)
         }
         let names = wrappersAndNames.map { $0.1 }
-        let fsmNames: [String] = try arrangement.add(to: self, language: destination, machineNames: names, isSuspensible: isSuspensible)
-        let wrappers = wrappersAndNames.map { $0.0 }
-        try zip(wrappers, fsmNames).forEach {
-            let machineWrapper = $0.0
-            let machineName = $0.1
-            machineWrapper.preferredFilename = machineName
-            try machineWrapper.machine.add(to: machineWrapper, language: destination, isSuspensible: isSuspensible)
+        let instances = try arrangement.instances(machineNames: names)
+        let fsmNames = arrangement.machineFilenames(of: instances)
+        let machines = wrappersAndNames.enumerated().map { ($1, $0 < fsmNames.count ? fsmNames[$0] : nil) }
+        if format == nil {
+            try FileManager.default.createDirectory(at: url, withIntermediateDirectories: true)
+        }
+        var errors = [(any Error)?](repeating: nil, count: machines.count + 1)
+        errors.withUnsafeMutableBufferPointer { errors in
+            DispatchQueue.concurrentPerform(iterations: machines.count + 1) { i in
+                do {
+                    guard i > 0 else {
+                        try arrangement.add(instances: instances, to: self, language: destination, isSuspensible: isSuspensible)
+                        guard format == nil else { return }
+                        try writeArrangementFiles(to: url, options: options, originalContentsURL: originalContentsURL)
+                        return
+                    }
+                    let ((machineWrapper, file), machineName) = machines[i - 1]
+                    guard let machineName else { throw FSMError.unknownMachine }
+                    machineWrapper.preferredFilename = machineName
+                    guard format == nil else {
+                        machineWrapper.directoryName = file
+                        try machineWrapper.machine.add(to: machineWrapper, language: destination, isSuspensible: isSuspensible)
+                        return
+                    }
+                    try machineWrapper.write(to: url.appendingPathComponent(file, isDirectory: true), options: options, originalContentsURL: originalContentsURL?.appendingPathComponent(file, isDirectory: true))
+                } catch {
+                    errors[i] = error
+                }
+            }
+        }
+        let failures = zip([preferredFilename ?? url.lastPathComponent] + machines.map { $0.0.1 }, errors).compactMap { file, error in
+            error.map { (filename: file, error: $0) }
+        }
+        guard failures.isEmpty else { throw ArrangementError(errors: failures) }
+        if let format, let name = preferredFilename {
+            try writeArchive(to: url, format: format, named: name)
         }
-        try super.write(to: url, options: options, originalContentsURL: originalContentsURL)
         filename = url.lastPathComponent
+        if format == nil && options.contains(.withNameUpdating) {
+            preferredFilename = url.lastPathComponent
+        }
+    }
+
+    /// Write the arrangement-level files.
+    ///
+    /// This writes all children except the machines
+    /// to the arrangement directory at the given URL.
+    /// As the arrangement directory is not written as a
+    /// whole, this updates the names of the children if
+    /// the options contain `.withNameUpdating`.
+    ///
+    /// - Parameters:
+    ///   - url: The URL of the arrangement directory.
+    ///   - options: The writing options to use.
+    ///   - originalContentsURL: The original URL of the file wrapper.
+    func writeArrangementFiles(to url: URL, options: FileWrapper.WritingOptions, originalContentsURL: URL?) throws {
+        for (file, fileWrapper) in fileWrappers ?? [:] where !(fileWrapper is MachineWrapper) {
+            try fileWrapper.write(to: url.appendingPathComponent(file, isDirectory: fileWrapper.isDirectory), options: options, originalContentsURL: originalContentsURL?.appendingPathComponent(file, isDirectory: fileWrapper.isDirectory))
+            if options.contains(.withNameUpdating) {
+                fileWrapper.filename = file
+            }
+        }
+    }
+
+    /// Add generated arrangement-level children in bulk.
+    ///
+    /// This runs the given body against an empty staging
+    /// wrapper for the same arrangement, name, and options,
+    /// then commits all staged children to the receiver in
+    /// a single update.
+    ///
+    /// - Parameter body: The body adding children to the staging wrapper.
+    /// - Returns: The result of the body.
+    @inlinable
+    public func buildFileWrappers<Result>(_ body: (ArrangementWrapper) throws -> Result) rethrows -> Result {
+        let staging = ArrangementWrapper(for: arrangement, named: preferredFilename, language: language)
+        staging.filename = filename
+        staging._preferredDirectoryName = _preferredDirectoryName
+        staging.isSuspensible = isSuspensible
+        staging.isIntrospectable = isIntrospectable
+        staging.isTableDriven = isTableDriven
+        staging.isTraceable = isTraceable
+        staging.isInlined = isInlined
+        staging.isExportable = isExportable
+        staging.isReloadable = isReloadable
+        staging.isCheckpointable = isCheckpointable
+        staging.isExplorable = isExplorable
+        staging.isSimulatable = isSimulatable
+        staging.isPartitioned = isPartitioned
+        staging.isBenchmarkable = isBenchmarkable
+        let result = try body(staging)
+        replaceFileWrappers(staging.fileWrappers ?? [:])
+        return result
     }
 }
@@ -53,4 +53,13 @@ public extension Boilerplate {
     func getSection(named sectionName: String) -> BoilerplateCode {
         SectionName(rawValue: sectionName).flatMap { sections[$0] } ?? ""
     }
+    /// Raw value section mutator.
+    /// - Parameters:
+    ///   - sectionName: The name of the section to set (ignored if unknown).
+    ///   - code: The boilerplate code for the given section.
+    @inlinable
+    mutating func setSection(named sectionName: String, to code: BoilerplateCode) {
+        guard let section = SectionName(rawValue: sectionName) else { return }
+        sections[section] = code
+    }
 }
@@ -25,6 +25,9 @@ public func cArrangementInterface(for instances: [Instance], named name: String,
         "#include <stdbool.h>"
         ""
         "#define ARRANGEMENT_\(upperName)_NUMBER_OF_INSTANCES \(instances.count)"
+        if isSuspensible {
+            "#define ARRANGEMENT_\(upperName)_ACTIVE_WORDS ((ARRANGEMENT_\(upperName)_NUMBER_OF_INSTANCES + 63) / 64)"
+        }
         ""
         "struct LLFSMachine;"
         "struct LLFSMArrangement;"
@@ -47,6 +50,14 @@ public func cArrangementInterface(for instances: [Instance], named name: String,
                     }
                 } + ";"
             } + ";"
+            if isSuspensible {
+                "/// Bitmap of the machines that are not idling in their suspend state."
+                "uint64_t active_machines[ARRANGEMENT_\(upperName)_ACTIVE_WORDS];"
+                "/// The activity epoch `active_machines` was last synchronised with."
+                "uintptr_t activity_epoch;"
+                "/// The number of ringlets executed, for periodic resynchronisation."
+                "uintptr_t ringlets;"
+            }
         } + ";"
         ""
         "/// Initialise the \(name) LLFSM arrangement."
@@ -106,6 +117,9 @@ public func cArrangementCode(for instances: [Instance], named name: String, isSu
                 let lowerType = instance.typeName.lowercased()
                 "fsm_" + lowerType + "_init(arrangement->fsm_" + lowerInstance + ");"
             }
+            if isSuspensible {
+                "fsm_arrangement_update_active((struct LLFSMArrangement *)arrangement);"
+            }
         }
         ""
         "/// Validate the \(name) LLFSM arrangement."
@@ -176,6 +190,15 @@ public func cStaticArrangementInterface(for instances: [Instance], named name: S
         }
         "/// Static instantiation of the \(name) LLFSM Arrangement."
         "extern struct Arrangement_" + name + " static_arrangement_" + lowerName + ";"
+        ""
+        "/// Run a ringlet of the static \(name) LLFSM arrangement using direct calls."
+        "void arrangement_" + lowerName + "_execute_once(void);"
+        ""
+        "#ifdef LLFSM_GENERIC_EXECUTOR"
+        "#define STATIC_ARRANGEMENT_\(upperName)_EXECUTE_ONCE() fsm_arrangement_execute_once((struct LLFSMArrangement *)&static_arrangement_" + lowerName + ")"
+        "#else"
+        "#define STATIC_ARRANGEMENT_\(upperName)_EXECUTE_ONCE() arrangement_" + lowerName + "_execute_once()"
+        "#endif"
     }
 }
 
@@ -185,8 +208,10 @@ public func cStaticArrangementInterface(for instances: [Instance], named name: S
 ///   - instances: The instances to arrange.
 ///   - name: The name of the arrangement
 ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+///   - isTableDriven: Indicates whether the machines use the table-driven executor.
+///   - isTraceable: Indicates whether the executor fires USDT probes.
 /// - Returns: The LLFSM arrangement interface code.
-public func cStaticArrangementCode(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+public func cStaticArrangementCode(for instances: [Instance], named name: String, isSuspensible: Bool, isTableDriven: Bool = false, isTraceable: Bool = false) -> Code {
     let machines = Dictionary(instances.map { ($0.typeName, $0) }, uniquingKeysWith: { a,_ in a })
     return """
     //
@@ -243,9 +268,9 @@ public func cStaticArrangementCode(for instances: [Instance], named name: String
                 }
             } + ";"
             ""
-            Code.forEach(instance.fsm.states.compactMap {
+            Code.enumerating(array: instance.fsm.states.compactMap {
                 instance.fsm.stateMap[$0]
-            }) { state in
+            }) { i, state in
                 let lowerState = state.name.lowercased()
                 "/// Static instantiation of the \(machineName) LLFSM state \(state.name)."
                 "struct FSM" + machineName + "_State_" + state.name + " static_" + lowerInstance + "_state_\(state.name) = "
@@ -253,10 +278,13 @@ public func cStaticArrangementCode(for instances: [Instance], named name: String
                     ".check_transitions = (struct LLFSMState *(*)(const struct LLFSMachine *, const struct LLFSMState *)) fsm_" + lowerMachine + "_" + lowerState + "_check_transitions,"
                     ".on_entry = (void (*)(struct LLFSMachine *, struct LLFSMState *)) fsm_" + lowerMachine + "_" + lowerState + "_on_entry,"
                     ".on_exit = (void (*)(struct LLFSMachine *, struct LLFSMState *)) fsm_" + lowerMachine + "_" + lowerState + "_on_exit,"
-                    ".internal = (void (*)(struct LLFSMachine *, struct LLFSMState *)) fsm_" + lowerMachine + "_" + lowerState + "_internal" + (isSuspensible ? "," : "")
+                    ".internal = (void (*)(struct LLFSMachine *, struct LLFSMState *)) fsm_" + lowerMachine + "_" + lowerState + "_internal" + (isSuspensible || isTableDriven ? "," : "")
                     if isSuspensible {
                         ".on_suspend = (void (*)(struct LLFSMachine *, struct LLFSMState *)) fsm_" + lowerMachine + "_" + lowerState + "_on_suspend,"
-                        ".on_resume = (void (*)(struct LLFSMachine *, struct LLFSMState *)) fsm_" + lowerMachine + "_" + lowerState + "_on_resume"
+                        ".on_resume = (void (*)(struct LLFSMachine *, struct LLFSMState *)) fsm_" + lowerMachine + "_" + lowerState + "_on_resume" + (isTableDriven ? "," : "")
+                    }
+                    if isTableDriven {
+                        ".state_index = \(i)"
                     }
                 } + ";"
             }
@@ -272,30 +300,39 @@ public func cStaticArrangementCode(for instances: [Instance], named name: String
                     (i < instances.count - 1 ? "," : "")
                 }
             } + ","
+            if isSuspensible {
+                ".activity_epoch = LLFSM_ACTIVITY_EPOCH_INVALID"
+            }
         } + ";"
         ""
+        cStaticArrangementExecuteCode(for: instances, named: name, isSuspensible: isSuspensible, isTableDriven: isTableDriven, isTraceable: isTraceable)
     }
 }
 
 
-/// Return the interface for a C-language LLFSM.
+/// Return the arrangement-independent interface shared by machines.
+///
+/// This holds the macros and generic structures that machine
+/// code can see through `Machine_Common.h`.  It does not depend
+/// on the name, instances, or channels of an arrangement, so
+/// machine packages can hash it and be reused across arrangements.
 ///
 /// - Parameters:
-///   - instances: The instances to arrange.
-///   - name: The name of the arrangement
 ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
-/// - Returns: The LLFSM arrangement interface code.
-public func cArrangementMachineInterface(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+///   - isTraceable: Indicates whether the executor fires USDT probes.
+/// - Returns: The `Machine_Macros.h` code.
+public func cArrangementMacroInterface(isSuspensible: Bool, isTraceable: Bool = false) -> Code {
     """
     //
-    // Machine_Common.h
+    // Machine_Macros.h
     //
     // Automatically created using fsmconvert -- do not change manually!
     //
 
-    """ + .includeFile(named: "LLFSM_ARRANGEMENT_COMMON_H") {
+    """ + .includeFile(named: "LLFSM_ARRANGEMENT_MACROS_H") {
         "#include <inttypes.h>"
         "#include <stdbool.h>"
+        "#include <stddef.h>"
         ""
         "#ifdef INCLUDE_MACHINE_CUSTOM"
         "#include \"Machine_Custom.h\""
@@ -307,44 +344,95 @@ public func cArrangementMachineInterface(for instances: [Instance], named name:
         "#pragma clang diagnostic push"
         "#pragma clang diagnostic ignored \"-Wunused-macros\""
         ""
+        "// Storage class of the activity epoch and the channels: the explorer"
+        "// and simulation drivers run a separate context per thread."
+        "#ifndef LLFSM_THREAD_LOCAL"
+        "#if defined(LLFSM_EXPLORE) || defined(LLFSM_SIMULATE)"
+        "#define LLFSM_THREAD_LOCAL _Thread_local"
+        "#else"
+        "#define LLFSM_THREAD_LOCAL"
+        "#endif"
+        "#endif"
+        ""
         if isSuspensible {
+            "#define LLFSM_ACTIVITY_EPOCH_INVALID (~(uintptr_t)0)"
+            ""
+            "#ifndef LLFSM_POLL_SUSPENDED"
+            "#define LLFSM_POLL_SUSPENDED 1"
+            "#endif"
+            "#ifndef LLFSM_CTZ"
+            "#define LLFSM_CTZ(x) __builtin_ctzll(x)"
+            "#endif"
+            "// Ringlets after which idle machines get re-checked, even without an"
+            "// activity change (a power of two, `0` disables the resynchronisation)."
+            "#ifndef LLFSM_ACTIVITY_RESYNC_INTERVAL"
+            "#define LLFSM_ACTIVITY_RESYNC_INTERVAL 64"
+            "#endif"
+            "#ifndef LLFSM_ACTIVITY_CHANGED"
+            "#define LLFSM_ACTIVITY_CHANGED() (++llfsm_activity_epoch, true)"
+            "#endif"
             "#ifndef IS_SUSPENSIBLE"
             "#define IS_SUSPENSIBLE(m) (!!(m)->suspend_state)"
             "#endif"
             "#ifndef IS_SUSPENDED"
             "#define IS_SUSPENDED(m) ((m)->suspend_state == (m)->current_state)"
             "#endif"
+            "#ifndef IS_IDLE"
+            "#define IS_IDLE(m) ((m)->current_state == (m)->suspend_state && (m)->previous_state == (m)->current_state)"
+            "#endif"
             "#ifndef SUSPEND"
-            "#define SUSPEND(m) ((m)->suspend_state && ((m)->resume_state = (m)->current_state == (m)->suspend_state ? (m)->resume_state : (m)->current_state) && ((m)->previous_state = (m)->current_state) && ((m)->current_state = (m)->suspend_state))"
+            "#define SUSPEND(m) ((m)->suspend_state && ((m)->resume_state = (m)->current_state == (m)->suspend_state ? (m)->resume_state : (m)->current_state) && ((m)->previous_state = (m)->current_state) && ((m)->current_state = (m)->suspend_state) && LLFSM_ACTIVITY_CHANGED())"
             "#endif"
             "#ifndef RESUME"
-            "#define RESUME(m)  ((m)->suspend_state && (m)->current_state == (m)->suspend_state && ((m)->current_state = (m)->resume_state ? (m)->resume_state : ((m)->previous_state && (m)->previous_state != (m)->suspend_state ? (m)->previous_state : (m)->states[0])) && ((m)->previous_state = (m)->suspend_state))"
+            "#define RESUME(m)  ((m)->suspend_state && (m)->current_state == (m)->suspend_state && ((m)->current_state = (m)->resume_state ? (m)->resume_state : ((m)->previous_state && (m)->previous_state != (m)->suspend_state ? (m)->previous_state : (m)->states[0])) && ((m)->previous_state = (m)->suspend_state) && LLFSM_ACTIVITY_CHANGED())"
+            "#endif"
+            "#ifndef RESTART"
+            "#define RESTART(m) (((m)->previous_state = (m)->current_state) && ((m)->current_state = (m)->states[0]) && LLFSM_ACTIVITY_CHANGED())"
             "#endif"
         } else {
             "#define IS_SUSPENSIBLE(m) false"
             "#define IS_SUSPENDED(m)   false"
+            "#ifndef RESTART"
+            "#define RESTART(m) (((m)->previous_state = (m)->current_state) && ((m)->current_state = (m)->states[0]))"
+            "#endif"
         }
-        "#ifndef RESTART"
-        "#define RESTART(m) (((m)->previous_state = (m)->current_state) && ((m)->current_state = (m)->states[0]))"
-        "#endif"
         "#ifndef GET_TIME"
         "#define GET_TIME() (machine->state_time + 1)"
         "#endif"
         "#ifndef TAKE_SNAPSHOT"
         "#define TAKE_SNAPSHOT()"
         "#endif"
+        if isTraceable {
+            cTraceProbeMacros()
+        }
         ""
         "struct LLFSMState;"
         "struct LLFSMachine;"
         ""
-        "/// A generic LLFSM Arrangement."
-        "struct LLFSMArrangement"
-        Code.bracedBlock {
-            "/// The number of instances in this arrangement."
-            "uintptr_t number_of_instances;"
-            "struct LLFSMachine *machines[\(instances.count)];"
-        } + ";"
+        "#ifndef LLFSM_SNAPSHOT"
+        "#if defined(LLFSM_EXPLORE) || defined(LLFSM_SIMULATE)"
+        "#define LLFSM_SNAPSHOT(m) ((void)(m))"
+        "#elif defined(LLFSM_REPLAY)"
+        "void llfsm_replay_snapshot(struct LLFSMachine * const machine);"
+        "#define LLFSM_SNAPSHOT(m) llfsm_replay_snapshot(m)"
+        "#elif defined(LLFSM_RECORD)"
+        "void llfsm_record_snapshot(const struct LLFSMachine * const machine);"
+        "#define LLFSM_SNAPSHOT(m) do { TAKE_SNAPSHOT(); llfsm_record_snapshot(m); } while (0)"
+        "#else"
+        "#define LLFSM_SNAPSHOT(m) TAKE_SNAPSHOT()"
+        "#endif"
+        "#endif"
         ""
+        if isSuspensible {
+            "/// Activity epoch, incremented by every `SUSPEND`, `RESUME`, and `RESTART`."
+            "///"
+            "/// The epoch is not atomic, so these macros need to be used"
+            "/// by the thread executing the arrangement.  Machines resumed"
+            "/// by other means (e.g. by assigning `current_state`) get picked"
+            "/// up within `LLFSM_ACTIVITY_RESYNC_INTERVAL` ringlets."
+            "extern LLFSM_THREAD_LOCAL uintptr_t llfsm_activity_epoch;"
+            ""
+        }
         "#ifndef STRUCT_LLFSMACHINE_"
         "#define STRUCT_LLFSMACHINE_"
         "/// A generic LLFSM."
@@ -375,6 +463,69 @@ public func cArrangementMachineInterface(for instances: [Instance], named name:
             }
         } + ";"
         "#endif // STRUCT_LLFSMSTATE_"
+        ""
+        "#pragma clang diagnostic pop"
+        "#pragma GCC diagnostic pop"
+        ""
+    }
+}
+
+/// Return the interface for a C-language LLFSM.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+///   - channels: The message channels between the instances.
+///   - isCheckpointable: Indicates whether checkpoint and restore functions get generated.
+/// - Returns: The LLFSM arrangement interface code.
+public func cArrangementMachineInterface(for instances: [Instance], named name: String, isSuspensible: Bool, channels: [Channel] = [], isCheckpointable: Bool = false) -> Code {
+    """
+    //
+    // Machine_Common.h
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+
+    """ + .includeFile(named: "LLFSM_ARRANGEMENT_COMMON_H") {
+        "#include <inttypes.h>"
+        "#include <stdbool.h>"
+        "#include <stddef.h>"
+        if !channels.isEmpty {
+            "#include <stdatomic.h>"
+        }
+        "#include \"Machine_Macros.h\""
+        ""
+        "#pragma GCC diagnostic push"
+        "#pragma GCC diagnostic ignored \"-Wunknown-pragmas\""
+        ""
+        "#pragma clang diagnostic push"
+        "#pragma clang diagnostic ignored \"-Wunused-macros\""
+        ""
+        if isSuspensible {
+            "#define LLFSM_ARRANGEMENT_ACTIVE_WORDS ((\(instances.count) + 63) / 64)"
+            ""
+        }
+        "/// A generic LLFSM Arrangement."
+        "struct LLFSMArrangement"
+        Code.bracedBlock {
+            "/// The number of instances in this arrangement."
+            "uintptr_t number_of_instances;"
+            "struct LLFSMachine *machines[\(instances.count)];"
+            if isSuspensible {
+                "/// Bitmap of the machines that are not idling in their suspend state."
+                "uint64_t active_machines[LLFSM_ARRANGEMENT_ACTIVE_WORDS];"
+                "/// The activity epoch `active_machines` was last synchronised with."
+                "uintptr_t activity_epoch;"
+                "/// The number of ringlets executed, for periodic resynchronisation."
+                "uintptr_t ringlets;"
+            }
+        } + ";"
+        ""
+        if !channels.isEmpty {
+            ""
+            cChannelInterface(for: channels)
+        }
         //        "/// Validate an LLFSM arrangement."
         //        "///"
         //        "/// - Parameter arrangement: The machine arrangement to validate."
@@ -388,6 +539,14 @@ public func cArrangementMachineInterface(for instances: [Instance], named name:
         "void fsm_arrangement_execute_once(struct LLFSMArrangement * const arrangement);"
         ""
         if isSuspensible {
+            "/// Synchronise the active machine bitmap of an arrangement."
+            "///"
+            "/// This marks every machine that is not idling"
+            "/// in its suspend state as active."
+            "///"
+            "/// - Parameter arrangement: The machine arrangement to update."
+            "void fsm_arrangement_update_active(struct LLFSMArrangement * const arrangement);"
+            ""
             "/// Suspend all machines except for the first one."
             "///"
             "/// This suspends all LLFSMs in the given arrangement,"
@@ -448,6 +607,34 @@ public func cArrangementMachineInterface(for instances: [Instance], named name:
         "/// - Parameter machine: The machine arrangement to initialise."
         "void llfsm_execute_once(struct LLFSMachine * const machine);"
         ""
+        if isCheckpointable {
+            "/// Return the size of a checkpoint of the arrangement."
+            "///"
+            "/// - Returns: The number of bytes required for a checkpoint."
+            "size_t fsm_arrangement_checkpoint_size(void);"
+            ""
+            "/// Checkpoint the runtime state of the arrangement."
+            "///"
+            "/// This serialises the state indices, state times,"
+            "/// and machine and state variables of all machines."
+            "///"
+            "/// - Parameters:"
+            "///   - arrangement: The arrangement to checkpoint."
+            "///   - buffer: The buffer to write the checkpoint to."
+            "///   - size: The size of the buffer in bytes."
+            "/// - Returns: The size of the checkpoint or `0` if the buffer is too small."
+            "size_t fsm_arrangement_checkpoint(const struct LLFSMArrangement * const arrangement, void * const buffer, size_t size);"
+            ""
+            "/// Restore the runtime state of the arrangement."
+            "///"
+            "/// - Parameters:"
+            "///   - arrangement: The arrangement to restore."
+            "///   - buffer: The buffer containing the checkpoint."
+            "///   - size: The size of the checkpoint in bytes."
+            "/// - Returns: `true` iff the checkpoint matched this build and was restored."
+            "bool fsm_arrangement_restore(struct LLFSMArrangement * const arrangement, const void * const buffer, size_t size);"
+            ""
+        }
         "#pragma clang diagnostic pop"
         "#pragma GCC diagnostic pop"
         ""
@@ -460,9 +647,14 @@ public func cArrangementMachineInterface(for instances: [Instance], named name:
 ///   - instances: The instances to arrange.
 ///   - name: The name of the arrangement
 ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+///   - channels: The message channels between the instances.
+///   - isTraceable: Indicates whether the executor fires USDT probes.
 /// - Returns: The LLFSM arrangement implementation code.
-public func cArrangementMachineCode(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
-    """
+public func cArrangementMachineCode(for instances: [Instance], named name: String, isSuspensible: Bool, channels: [Channel] = [], isTraceable: Bool = false) -> Code {
+    let pollableMachines = instances.enumerated().compactMap { i, instance in
+        instance.fsm.suspendState.flatMap { instance.fsm.transitionsFrom($0).isEmpty ? nil : i }
+    }
+    return """
     //
     // Machine_Common.c
     //
@@ -479,6 +671,42 @@ public func cArrangementMachineCode(for instances: [Instance], named name: Strin
     #endif
 
     """ + .block {
+        Code.forEach(channels) { channel in
+            "/// Channel `\(channel.name)` from `\(channel.producer)` to `\(channel.consumer)`."
+            "LLFSM_THREAD_LOCAL struct llfsm_channel_\(channel.name) llfsm_channel_\(channel.name);"
+            ""
+        }
+        if isSuspensible {
+            "/// Activity epoch, incremented by every `SUSPEND`, `RESUME`, and `RESTART`."
+            "LLFSM_THREAD_LOCAL uintptr_t llfsm_activity_epoch;"
+            ""
+            "/// Bitmap of the machines whose suspend state has outgoing transitions."
+            "static const uint64_t llfsm_pollable_machines[LLFSM_ARRANGEMENT_ACTIVE_WORDS] ="
+            Code.bracedBlock {
+                bitmapWords(for: pollableMachines, count: instances.count).map {
+                    "UINT64_C(0x" + String($0, radix: 16) + ")"
+                }.joined(separator: ",\n")
+            } + ";"
+            ""
+            "/// Poll the resume guards of an idle, suspended LLFSM."
+            "///"
+            "/// This evaluates the transitions of the suspend state"
+            "/// without re-running its internal action."
+            "///"
+            "/// - Parameter machine: The suspended machine to poll."
+            "static void llfsm_poll_suspended(struct LLFSMachine * const machine)"
+            Code.bracedBlock {
+                "struct LLFSMState * const current_state = machine->current_state;"
+                "LLFSM_SNAPSHOT(machine);"
+                "struct LLFSMState * const target_state = current_state->check_transitions(machine, current_state);"
+                "if (target_state)"
+                Code.bracedBlock {
+                    "current_state->on_exit(machine, current_state);"
+                    "machine->current_state = target_state;"
+                }
+            }
+            ""
+        }
         //        "/// Validate an LLFSM arrangement."
         //        "///"
         //        "/// - Parameter arrangement: The machine arrangement to validate."
@@ -499,17 +727,73 @@ public func cArrangementMachineCode(for instances: [Instance], named name: Strin
         "///"
         "/// - Parameter arrangement: The machine arrangement to run a ringlet over."
         "void fsm_arrangement_execute_once(struct LLFSMArrangement * const arrangement)"
-        Code.bracedBlock {
-            "const uintptr_t n = arrangement->number_of_instances;"
-            "unsigned i;"
-            "for (i = 0; i < n; i++)"
+        if isSuspensible {
             Code.bracedBlock {
-                "struct LLFSMachine * const machine = arrangement->machines[i];"
-                "llfsm_execute_once(machine);"
+                "const uintptr_t ringlet = ++arrangement->ringlets;"
+                "uintptr_t w;"
+                "if (arrangement->activity_epoch != llfsm_activity_epoch ||"
+                "    (LLFSM_ACTIVITY_RESYNC_INTERVAL && !(ringlet & (LLFSM_ACTIVITY_RESYNC_INTERVAL - 1))))"
+                "    fsm_arrangement_update_active(arrangement); // activity changed or periodic re-check"
+                "for (w = 0; w < LLFSM_ARRANGEMENT_ACTIVE_WORDS; w++)"
+                Code.bracedBlock {
+                    "uint64_t pending = arrangement->active_machines[w];"
+                    "#if LLFSM_POLL_SUSPENDED"
+                    "pending |= llfsm_pollable_machines[w];"
+                    "#endif"
+                    "while (pending)"
+                    Code.bracedBlock {
+                        "const unsigned b = (unsigned)LLFSM_CTZ(pending);"
+                        "const uint64_t bit = UINT64_C(1) << b;"
+                        "const uintptr_t epoch = llfsm_activity_epoch;"
+                        "struct LLFSMachine * const machine = arrangement->machines[w * 64 + b];"
+                        "pending &= pending - 1;"
+                        "if (arrangement->active_machines[w] & bit) llfsm_execute_once(machine);"
+                        "else llfsm_poll_suspended(machine);"
+                        "if (IS_IDLE(machine)) arrangement->active_machines[w] &= ~bit;"
+                        "else arrangement->active_machines[w] |= bit;"
+                        "if (epoch != llfsm_activity_epoch)"
+                        Code.bracedBlock {
+                            "// another machine got suspended, resumed, or restarted"
+                            "fsm_arrangement_update_active(arrangement);"
+                            "pending = arrangement->active_machines[w] & (~UINT64_C(1) << b);"
+                            "#if LLFSM_POLL_SUSPENDED"
+                            "pending |= llfsm_pollable_machines[w] & (~UINT64_C(1) << b);"
+                            "#endif"
+                        }
+                    }
+                }
+            }
+        } else {
+            Code.bracedBlock {
+                "const uintptr_t n = arrangement->number_of_instances;"
+                "unsigned i;"
+                "for (i = 0; i < n; i++)"
+                Code.bracedBlock {
+                    "struct LLFSMachine * const machine = arrangement->machines[i];"
+                    "llfsm_execute_once(machine);"
+                }
             }
         }
         ""
         if isSuspensible {
+            "/// Synchronise the active machine bitmap of an arrangement."
+            "///"
+            "/// This marks every machine that is not idling"
+            "/// in its suspend state as active."
+            "///"
+            "/// - Parameter arrangement: The machine arrangement to update."
+            "void fsm_arrangement_update_active(struct LLFSMArrangement * const arrangement)"
+            Code.bracedBlock {
+                "const uintptr_t n = arrangement->number_of_instances;"
+                "uintptr_t i;"
+                "for (i = 0; i < LLFSM_ARRANGEMENT_ACTIVE_WORDS; i++) arrangement->active_machines[i] = 0;"
+                "for (i = 0; i < n; i++)"
+                Code.bracedBlock {
+                    "if (!IS_IDLE(arrangement->machines[i])) arrangement->active_machines[i / 64] |= UINT64_C(1) << (i % 64);"
+                }
+                "arrangement->activity_epoch = llfsm_activity_epoch;"
+            }
+            ""
             "/// Suspend all machines except for the first one."
             "///"
             "/// This suspends all LLFSMs in the given arrangement,"
@@ -518,31 +802,34 @@ public func cArrangementMachineCode(for instances: [Instance], named name: Strin
             "/// - Parameter arrangement: The machine arrangement to suspend."
             "void fsm_arrangement_suspend_all(struct LLFSMArrangement * const arrangement)"
             Code.bracedBlock {
-                "const uintptr_t n = arrangement->number_of_instances;"
-                "unsigned i;"
-                "for (i = 1; i < n; i++)"
-                Code.bracedBlock {
-                    "struct LLFSMachine * const machine = arrangement->machines[i];"
-                    "SUSPEND(machine);"
-                }
+                "fsm_arrangement_suspend_all_except(arrangement, arrangement->machines[0]);"
             }
             ""
             "/// Suspend all machines except for the given machine."
             "///"
             "/// This suspends all LLFSMs in the given arrangement,"
             "/// with the exception of machine specified."
+            "/// The active machine bitmap gets resynchronised first,"
+            "/// as machines may have left their suspend state without"
+            "/// an activity change.  Only active machines are visited,"
+            "/// as idle machines are already suspended."
             "///"
             "/// - Parameters:"
             "///   - arrangement: The machine arrangement to suspend."
             "///   - machine: The machine to be excepted from suspension."
             "void fsm_arrangement_suspend_all_except(struct LLFSMArrangement * const arrangement, struct LLFSMachine * const machine)"
             Code.bracedBlock {
-                "const uintptr_t n = arrangement->number_of_instances;"
-                "unsigned i;"
-                "for (i = 1; i < n; i++)"
+                "uintptr_t w;"
+                "fsm_arrangement_update_active(arrangement);"
+                "for (w = 0; w < LLFSM_ARRANGEMENT_ACTIVE_WORDS; w++)"
                 Code.bracedBlock {
-                    "struct LLFSMachine * const m = arrangement->machines[i];"
-                    "if (m != machine) SUSPEND(machine);"
+                    "uint64_t pending = arrangement->active_machines[w] & (w ? ~UINT64_C(0) : ~UINT64_C(1));"
+                    "while (pending)"
+                    Code.bracedBlock {
+                        "struct LLFSMachine * const m = arrangement->machines[w * 64 + (unsigned)LLFSM_CTZ(pending)];"
+                        "pending &= pending - 1;"
+                        "if (m != machine && !IS_SUSPENDED(m)) SUSPEND(m);"
+                    }
                 }
             }
             ""
@@ -578,7 +865,7 @@ public func cArrangementMachineCode(for instances: [Instance], named name: Strin
                 "for (i = 1; i < n; i++)"
                 Code.bracedBlock {
                     "struct LLFSMachine * const m = arrangement->machines[i];"
-                    "if (m != machine) RESUME(machine);"
+                    "if (m != machine) RESUME(m);"
                 }
             }
             ""
@@ -615,7 +902,7 @@ public func cArrangementMachineCode(for instances: [Instance], named name: Strin
             "for (i = 1; i < n; i++)"
             Code.bracedBlock {
                 "struct LLFSMachine * const m = arrangement->machines[i];"
-                "if (m != machine) RESTART(machine);"
+                "if (m != machine) RESTART(m);"
             }
         }
         ""
@@ -626,24 +913,36 @@ public func cArrangementMachineCode(for instances: [Instance], named name: Strin
         Code.bracedBlock {
             "struct LLFSMState * const current_state = machine->current_state;"
             ""
+            if isTraceable {
+                "LLFSM_PROBE_RINGLET_START(machine, current_state);"
+            }
             "if (current_state != machine->previous_state)"
             Code.bracedBlock {
                 "machine->state_time = GET_TIME();"
                 if isSuspensible {
                     "if (current_state == machine->suspend_state)"
                     Code.bracedBlock {
+                        if isTraceable {
+                            "LLFSM_PROBE_SUSPEND(machine, machine->previous_state);"
+                        }
                         "if (machine->previous_state && machine->previous_state->on_suspend) machine->previous_state->on_suspend(machine, machine->previous_state);"
                         "if (current_state->on_suspend) current_state->on_suspend(machine, current_state);"
                     }
                     "else if (machine->previous_state == machine->suspend_state)"
                     Code.bracedBlock {
+                        if isTraceable {
+                            "LLFSM_PROBE_RESUME(machine, current_state);"
+                        }
                         "if (machine->previous_state && machine->previous_state->on_resume) machine->previous_state->on_resume(machine, machine->previous_state);"
                         "if (current_state->on_resume) current_state->on_resume(machine, current_state);"
                     }
                 }
+                if isTraceable {
+                    "LLFSM_PROBE_STATE_ENTRY(machine, current_state, machine->state_time);"
+                }
                 "current_state->on_entry(machine, current_state);"
             }
-            "TAKE_SNAPSHOT();"
+            "LLFSM_SNAPSHOT(machine);"
             "struct LLFSMState * const target_state = current_state->check_transitions(machine, current_state);"
             "machine->previous_state = current_state;"
             "if (target_state)"
@@ -655,6 +954,9 @@ public func cArrangementMachineCode(for instances: [Instance], named name: Strin
             Code.bracedBlock {
                 "current_state->internal(machine, current_state);"
             }
+            if isTraceable {
+                "LLFSM_PROBE_RINGLET_END(machine, machine->current_state);"
+            }
         }
         ""
     }
@@ -667,8 +969,9 @@ public func cArrangementMachineCode(for instances: [Instance], named name: Strin
 ///   - instances: The instances to arrange.
 ///   - name: The name of the arrangement
 ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+///   - isRecordable: Indicates whether snapshots can be recorded and replayed.
 /// - Returns: The LLFSM arrangement implementation code.
-public func cStaticArrangementMainCode(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+public func cStaticArrangementMainCode(for instances: [Instance], named name: String, isSuspensible: Bool, isRecordable: Bool = false) -> Code {
     """
     //
     // main.c for running the static LLFSM arrangement named \(name).
@@ -682,6 +985,17 @@ public func cStaticArrangementMainCode(for instances: [Instance], named name: St
     #include \"Machine_Common.h\"
     #include \"Arrangement_\(name).h\"
     #include \"Static_Arrangement_\(name).h\"
+    #ifdef LLFSM_SHM_EXPORT
+    #include \"Arrangement_\(name)_Export.h\"
+    #endif
+
+    """ + (isRecordable ? """
+    #if defined(LLFSM_RECORD) || defined(LLFSM_REPLAY)
+    #include <time.h>
+    #include \"Arrangement_\(name)_Record.h\"
+    #endif
+
+    """ : "") + """
 
     int main(int argc, char *argv[])
     """ + Code.bracedBlock {
@@ -694,10 +1008,53 @@ public func cStaticArrangementMainCode(for instances: [Instance], named name: St
             "return EXIT_FAILURE;"
         }
         ""
+        "#ifdef LLFSM_SHM_EXPORT"
+        "if (!arrangement_" + lowerName + "_export_open())"
+        Code.bracedBlock {
+            "perror(\"arrangement_" + lowerName + "_export_open\");"
+        }
+        "#endif"
+        if isRecordable {
+            let upperName = name.uppercased()
+            "#if defined(LLFSM_RECORD) || defined(LLFSM_REPLAY)"
+            "const char * const snapshot_log = argc > 2 ? argv[2] : ARRANGEMENT_\(upperName)_SNAPSHOT_LOG;"
+            "if (!arrangement_" + lowerName + "_snapshot_log_open(&static_arrangement_" + lowerName + ", snapshot_log))"
+            Code.bracedBlock {
+                "perror(snapshot_log);"
+                "return EXIT_FAILURE;"
+            }
+            "#endif"
+            "#ifdef LLFSM_REPLAY"
+            "uintptr_t ringlets = 0;"
+            "struct timespec start, end;"
+            "clock_gettime(CLOCK_MONOTONIC, &start);"
+            "while (num_runs-- && !arrangement_" + lowerName + "_snapshot_log_exhausted())"
+            Code.bracedBlock {
+                "STATIC_ARRANGEMENT_" + name.uppercased() + "_EXECUTE_ONCE();"
+                "ringlets++;"
+            }
+            "clock_gettime(CLOCK_MONOTONIC, &end);"
+            "const double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;"
+            "fprintf(stderr, \"%ju ringlets in %.6f s: %.0f ringlets/s, %.1f ns/ringlet\\n\", (uintmax_t)ringlets, seconds,"
+            "        seconds > 0 ? (double)ringlets / seconds : 0.0, ringlets ? seconds * 1e9 / (double)ringlets : 0.0);"
+            "#else"
+        }
         "while (num_runs--)"
         Code.bracedBlock {
-            "fsm_arrangement_execute_once((struct LLFSMArrangement *)&static_arrangement_" + lowerName + ");"
+            "STATIC_ARRANGEMENT_" + name.uppercased() + "_EXECUTE_ONCE();"
+            "#ifdef LLFSM_SHM_EXPORT"
+            "arrangement_" + lowerName + "_export(&static_arrangement_" + lowerName + ");"
+            "#endif"
+        }
+        if isRecordable {
+            "#endif"
+            "#if defined(LLFSM_RECORD) || defined(LLFSM_REPLAY)"
+            "arrangement_" + lowerName + "_snapshot_log_close();"
+            "#endif"
         }
+        "#ifdef LLFSM_SHM_EXPORT"
+        "arrangement_" + lowerName + "_export_close();"
+        "#endif"
         ""
         "return EXIT_SUCCESS;"
     } + "\n"
@@ -709,13 +1066,33 @@ public func cStaticArrangementMainCode(for instances: [Instance], named name: St
 ///   - instances: The instances to arrange.
 ///   - name: The name of the arrangement
 ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+///   - isIntrospectable: Indicates whether introspection tables should be compiled.
+///   - isRecordable: Indicates whether the snapshot log should be compiled.
+///   - isExportable: Indicates whether the shared-memory export should be compiled.
+///   - isCheckpointable: Indicates whether checkpoint and restore functions should be compiled.
+///   - hasContexts: Indicates whether re-entrant arrangement contexts should be compiled.
 /// - Returns: The CMakeLists.txt code.
-public func cArrangementCMakeFragment(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+public func cArrangementCMakeFragment(for instances: [Instance], named name: String, isSuspensible: Bool, isIntrospectable: Bool = false, isRecordable: Bool = false, isExportable: Bool = false, isCheckpointable: Bool = false, hasContexts: Bool = false) -> Code {
     let machines = Array(Set(instances.map(\.typeName)))
     return .block {
         "# Sources for the \(name) LLFSM arrangement."
         "set(\(name)_ARRANGEMENT_SOURCES"
         "    Arrangement_\(name).c"
+        if isCheckpointable {
+            "    Arrangement_\(name)_Checkpoint.c"
+        }
+        if hasContexts {
+            "    Arrangement_\(name)_Context.c"
+        }
+        if isExportable {
+            "    Arrangement_\(name)_Export.c"
+        }
+        if isIntrospectable {
+            "    Arrangement_\(name)_Introspection.c"
+        }
+        if isRecordable {
+            "    Arrangement_\(name)_Record.c"
+        }
         "    Machine_Common.c"
         ")"
         ""
@@ -761,14 +1138,26 @@ public func cArrangementCMakeFragment(for instances: [Instance], named name: Str
         }
         ")"
         ""
+        "option(\(name)_PREBUILT_FSMS \"Link installed machine packages matching the \(name) machine sources\" ON)"
+        ""
         Code.forEach(machines) { machine in
             let directory = machine + ".machine"
             "include(${CMAKE_CURRENT_LIST_DIR}/" + directory + "/project.cmake)"
-            "foreach(src ${\(machine)_FSM_SOURCES})"
-            "  list(APPEND \(name)_ARRANGEMENT_FSMS \"\(machine)\")"
-            "  list(APPEND \(name)_ARRANGEMENT_FSM_\(machine)_SOURCES \(directory)/${src})"
-            "  list(APPEND \(name)_ARRANGEMENT_SOURCES \(directory)/${src})"
-            "endforeach()"
+            "if(\(name)_PREBUILT_FSMS)"
+            "  find_package(\(machine) CONFIG QUIET)"
+            "endif()"
+            "if(\(name)_PREBUILT_FSMS AND \(machine)_FOUND AND \"${\(machine)_FSM_PACKAGE_HASH}\" STREQUAL \"${\(machine)_FSM_CONTENT_HASH}\")"
+            "  list(APPEND \(name)_ARRANGEMENT_PREBUILT_FSMS \"\(machine)\")"
+            "  list(APPEND \(name)_ARRANGEMENT_PREBUILT_LIBRARIES \(machine)::\(machine)_fsm)"
+            "  list(APPEND \(name)_ARRANGEMENT_FSM_LIBRARIES \(machine)::\(machine)_fsm)"
+            "else()"
+            "  list(APPEND \(name)_ARRANGEMENT_FSM_LIBRARIES \(machine)_fsm)"
+            "  foreach(src ${\(machine)_FSM_SOURCES})"
+            "    list(APPEND \(name)_ARRANGEMENT_FSMS \"\(machine)\")"
+            "    list(APPEND \(name)_ARRANGEMENT_FSM_\(machine)_SOURCES \(directory)/${src})"
+            "    list(APPEND \(name)_ARRANGEMENT_SOURCES \(directory)/${src})"
+            "  endforeach()"
+            "endif()"
         }
     }
 }
@@ -780,19 +1169,58 @@ public func cArrangementCMakeFragment(for instances: [Instance], named name: Str
 ///   - instances: The instances to arrange.
 ///   - name: The name of the arrangement
 ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+///   - channels: The message channels between the instances.
+///   - isRecordable: Indicates whether snapshots can be recorded and replayed.
+///   - isTraceable: Indicates whether the executor fires USDT probes.
+///   - isExportable: Indicates whether the shared-memory export and monitor can be built.
+///   - isReloadable: Indicates whether machines can be reloaded at runtime.
+///   - isExplorable: Indicates whether the reachable-configuration explorer can be built.
+///   - isSimulatable: Indicates whether the Monte-Carlo simulation driver can be built.
+///   - isBenchmarkable: Indicates whether the executor benchmark can be built.
 /// - Returns: The CMakeLists.txt code.
-public func cArrangementCMakeLists(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+public func cArrangementCMakeLists(for instances: [Instance], named name: String, isSuspensible: Bool, channels: [Channel] = [], isRecordable: Bool = false, isTraceable: Bool = false, isExportable: Bool = false, isReloadable: Bool = false, isExplorable: Bool = false, isSimulatable: Bool = false, isBenchmarkable: Bool = false) -> Code {
     let machines = Array(Set(instances.map(\.typeName)))
     return .block {
         "cmake_minimum_required(VERSION 3.21)"
         ""
         "project(\(name) C)"
         ""
+        if !channels.isEmpty {
+            "# Machines need the arrangement channels, so build them from source."
+            "set(\(name)_PREBUILT_FSMS OFF)"
+            ""
+        }
+        if isExportable {
+            "option(\(name)_SHM_EXPORT \"Export the machine states of \(name) to shared memory\" ON)"
+            ""
+        }
+        if isTraceable {
+            "option(\(name)_USDT \"Place USDT probes for tracing \(name)\" ON)"
+            "if(NOT \(name)_USDT)"
+            "  add_compile_definitions(LLFSM_NO_USDT)"
+            "endif()"
+            ""
+        }
+        if !channels.isEmpty {
+            "# Make the arrangement channels visible to all machines."
+            "add_compile_definitions(INCLUDE_MACHINE_COMMON)"
+            "include_directories(${CMAKE_CURRENT_SOURCE_DIR})"
+            ""
+        }
+        if isReloadable {
+            "option(LLFSM_DYNAMIC \"Allow machines to be reloaded at runtime\" ON)"
+            ""
+        }
+        "# Compile definitions need to be set before including the"
+        "# machine fragments, as they are part of their content hashes."
         "include(project.cmake)"
         ""
         "add_library(\(name)_arrangement STATIC ${\(name)_ARRANGEMENT_SOURCES})"
         "add_library(\(name)_static_arrangement STATIC ${\(name)_STATIC_ARRANGEMENT_SOURCES})"
         ""
+        "# Machine code that is not compiled into \(name)_arrangement."
+        "target_link_libraries(\(name)_arrangement PUBLIC ${\(name)_ARRANGEMENT_PREBUILT_LIBRARIES})"
+        ""
         "target_include_directories(\(name)_arrangement PRIVATE "
         "  ${\(name)_ARRANGEMENT_INCDIRS}"
         "  ${\(name)_ARRANGEMENT_INSTALL_INCDIRS}"
@@ -808,17 +1236,195 @@ public func cArrangementCMakeLists(for instances: [Instance], named name: String
         "  ${\(name)_ARRANGEMENT_INCDIRS}"
         "  ${\(name)_ARRANGEMENT_INSTALL_INCDIRS}"
         ")"
-        Code.forEach(Array(Set(instances.map(\.typeName)))) { machine in
-            "add_subdirectory(" + machine + ".machine)"
+        ""
+        if isReloadable {
+            "if(LLFSM_DYNAMIC)"
+            "  target_sources(\(name)_arrangement PRIVATE"
+            "    Arrangement_\(name)_Dynamic.c"
+            Code.forEach(machines) { machine in
+                "    " + machine + ".machine/Machine_" + machine + "_Module.c"
+            }
+            "  )"
+            "  target_compile_definitions(\(name)_arrangement PUBLIC LLFSM_DYNAMIC)"
+            "  target_link_libraries(\(name)_arrangement PUBLIC ${CMAKE_DL_LIBS})"
+            "endif()"
+            ""
+        }
+        if isExportable {
+            "if(\(name)_SHM_EXPORT)"
+            "  target_compile_definitions(\(name)_arrangement PUBLIC LLFSM_SHM_EXPORT)"
+            "  add_executable(monitor_\(name)_arrangement monitor_main.c)"
+            "  target_include_directories(monitor_\(name)_arrangement PRIVATE"
+            "    ${\(name)_ARRANGEMENT_INCDIRS}"
+            "  )"
+            "  if(CMAKE_SYSTEM_NAME STREQUAL \"Linux\")"
+            "    target_link_libraries(\(name)_arrangement PUBLIC rt)"
+            "    target_link_libraries(monitor_\(name)_arrangement rt)"
+            "  endif()"
+            "endif()"
+            ""
+        }
+        if isExplorable {
+            "option(\(name)_EXPLORE \"Build the reachable-configuration explorer for \(name)\" ON)"
+            "if(\(name)_EXPLORE)"
+            "  find_package(Threads REQUIRED)"
+            "  add_executable(explore_\(name)_arrangement explore_main.c ${\(name)_ARRANGEMENT_SOURCES} ${\(name)_STATIC_ARRANGEMENT_SOURCES})"
+            "  target_include_directories(explore_\(name)_arrangement PRIVATE"
+            "    ${\(name)_ARRANGEMENT_INCDIRS}"
+            "  )"
+            "  target_compile_definitions(explore_\(name)_arrangement PRIVATE LLFSM_EXPLORE)"
+            "  target_link_libraries(explore_\(name)_arrangement Threads::Threads ${\(name)_ARRANGEMENT_PREBUILT_LIBRARIES})"
+            "endif()"
+            ""
+        }
+        if isSimulatable {
+            "option(\(name)_SIMULATE \"Build the Monte-Carlo simulation driver for \(name)\" ON)"
+            "if(\(name)_SIMULATE)"
+            "  find_package(Threads REQUIRED)"
+            "  add_executable(simulate_\(name)_arrangement simulate_main.c ${\(name)_ARRANGEMENT_SOURCES} ${\(name)_STATIC_ARRANGEMENT_SOURCES})"
+            "  target_include_directories(simulate_\(name)_arrangement PRIVATE"
+            "    ${\(name)_ARRANGEMENT_INCDIRS}"
+            "  )"
+            "  target_compile_definitions(simulate_\(name)_arrangement PRIVATE LLFSM_SIMULATE)"
+            "  target_link_libraries(simulate_\(name)_arrangement Threads::Threads ${\(name)_ARRANGEMENT_PREBUILT_LIBRARIES})"
+            "endif()"
+            ""
+        }
+        if isBenchmarkable {
+            "option(\(name)_BENCHMARK \"Build the executor benchmark for \(name)\" ON)"
+            "if(\(name)_BENCHMARK)"
+            "  add_executable(benchmark_\(name)_arrangement benchmark_main.c ${\(name)_ARRANGEMENT_SOURCES} ${\(name)_STATIC_ARRANGEMENT_SOURCES})"
+            "  target_include_directories(benchmark_\(name)_arrangement PRIVATE"
+            "    ${\(name)_ARRANGEMENT_INCDIRS}"
+            "  )"
+            "  target_link_libraries(benchmark_\(name)_arrangement ${\(name)_ARRANGEMENT_PREBUILT_LIBRARIES})"
+            "endif()"
+        }
+        if isRecordable {
+            ""
+            "option(\(name)_RECORD \"Record the snapshot variables of \(name)\" OFF)"
+            "option(\(name)_REPLAY \"Replay recorded snapshot variables of \(name)\" OFF)"
+            "if(\(name)_REPLAY)"
+            "  target_compile_definitions(\(name)_arrangement PUBLIC LLFSM_REPLAY)"
+            "elseif(\(name)_RECORD)"
+            "  target_compile_definitions(\(name)_arrangement PUBLIC LLFSM_RECORD)"
+            "endif()"
+        }
+        Code.forEach(machines) { machine in
+            "if(NOT \"\(machine)\" IN_LIST \(name)_ARRANGEMENT_PREBUILT_FSMS)"
+            "  add_subdirectory(" + machine + ".machine)"
+            "endif()"
         }
         "target_link_libraries(run_\(name)_arrangement"
         "    \(name)_static_arrangement"
         "    \(name)_arrangement"
-        Code.enumerating(array: machines) { i, machine in
-            "    \(machine)_fsm"
-        }
+        "    ${\(name)_ARRANGEMENT_FSM_LIBRARIES}"
         ")"
         ""
     }
 }
 
+/// Return the interface for the given arrangement channels.
+///
+/// Each channel is a single-producer/single-consumer ring buffer
+/// whose head and tail live on separate cache lines.
+/// The `CHANNEL_*` macros can be used in `.mm` actions
+/// as well as in `.expr` transition guards.
+///
+/// - Parameter channels: The channels to create the interface for.
+/// - Returns: The channel layout and accessor code.
+public func cChannelInterface(for channels: [Channel]) -> Code {
+    .block {
+        "#ifndef LLFSM_CACHE_LINE_SIZE"
+        "#define LLFSM_CACHE_LINE_SIZE 64"
+        "#endif"
+        ""
+        "/// Send a value through the given channel (`false` if full)."
+        "#define CHANNEL_SEND(ch, value) llfsm_channel_##ch##_send(value)"
+        "/// Receive a value from the given channel into `*ptr` (`false` if empty)."
+        "#define CHANNEL_RECEIVE(ch, ptr) llfsm_channel_##ch##_receive(ptr)"
+        "/// Return whether the given channel has room for another value."
+        "#define CHANNEL_CAN_SEND(ch) llfsm_channel_##ch##_can_send()"
+        "/// Return whether the given channel contains a value."
+        "#define CHANNEL_CAN_RECEIVE(ch) llfsm_channel_##ch##_can_receive()"
+        "/// Return the number of values in the given channel."
+        "#define CHANNEL_COUNT(ch) llfsm_channel_##ch##_count()"
+        ""
+        "#pragma clang diagnostic push"
+        "#pragma clang diagnostic ignored \"-Wpadded\""
+        "#pragma clang diagnostic ignored \"-Wunused-function\""
+        ""
+        Code.forEach(channels) { channel in
+            let c = "llfsm_channel_" + channel.name
+            let mask = "\(channel.capacity - 1)"
+            "#define LLFSM_CHANNEL_\(channel.name.uppercased())_CAPACITY \(channel.capacity)"
+            ""
+            "/// Channel `\(channel.name)` from `\(channel.producer)` to `\(channel.consumer)`."
+            "struct \(c)"
+            Code.bracedBlock {
+                "/// Index of the next element to receive (written by `\(channel.consumer)`)."
+                "_Alignas(LLFSM_CACHE_LINE_SIZE) _Atomic(uintptr_t) head;"
+                "/// Index of the next element to send (written by `\(channel.producer)`)."
+                "_Alignas(LLFSM_CACHE_LINE_SIZE) _Atomic(uintptr_t) tail;"
+                "/// The channel elements."
+                "_Alignas(LLFSM_CACHE_LINE_SIZE) \(channel.elementType) buffer[\(channel.capacity)];"
+            } + ";"
+            ""
+            "extern LLFSM_THREAD_LOCAL struct \(c) \(c);"
+            ""
+            "/// Send a value through `\(channel.name)` (producer only)."
+            "static inline bool \(c)_send(const \(channel.elementType) value)"
+            Code.bracedBlock {
+                "const uintptr_t tail = atomic_load_explicit(&\(c).tail, memory_order_relaxed);"
+                "if (tail - atomic_load_explicit(&\(c).head, memory_order_acquire) >= \(channel.capacity)) return false;"
+                "\(c).buffer[tail & \(mask)] = value;"
+                "atomic_store_explicit(&\(c).tail, tail + 1, memory_order_release);"
+                "return true;"
+            }
+            ""
+            "/// Receive a value from `\(channel.name)` (consumer only)."
+            "static inline bool \(c)_receive(\(channel.elementType) * const value)"
+            Code.bracedBlock {
+                "const uintptr_t head = atomic_load_explicit(&\(c).head, memory_order_relaxed);"
+                "if (head == atomic_load_explicit(&\(c).tail, memory_order_acquire)) return false;"
+                "*value = \(c).buffer[head & \(mask)];"
+                "atomic_store_explicit(&\(c).head, head + 1, memory_order_release);"
+                "return true;"
+            }
+            ""
+            "/// Return whether `\(channel.name)` has room for another value."
+            "static inline bool \(c)_can_send(void)"
+            Code.bracedBlock {
+                "return atomic_load_explicit(&\(c).tail, memory_order_relaxed) - atomic_load_explicit(&\(c).head, memory_order_acquire) < \(channel.capacity);"
+            }
+            ""
+            "/// Return whether `\(channel.name)` contains a value."
+            "static inline bool \(c)_can_receive(void)"
+            Code.bracedBlock {
+                "return atomic_load_explicit(&\(c).head, memory_order_relaxed) != atomic_load_explicit(&\(c).tail, memory_order_acquire);"
+            }
+            ""
+            "/// Return the number of values in `\(channel.name)`."
+            "static inline uintptr_t \(c)_count(void)"
+            Code.bracedBlock {
+                "return atomic_load_explicit(&\(c).tail, memory_order_acquire) - atomic_load_explicit(&\(c).head, memory_order_acquire);"
+            }
+            ""
+        }
+        "#pragma clang diagnostic pop"
+    }
+}
+
+/// Return the 64-bit words of a bitmap.
+///
+/// - Parameters:
+///   - indices: The indices of the bits to set.
+///   - count: The total number of bits in the bitmap.
+/// - Returns: The words making up the bitmap (at least one).
+func bitmapWords(for indices: [Int], count: Int) -> [UInt64] {
+    var words = [UInt64](repeating: 0, count: max(1, (count + 63) / 64))
+    for i in indices {
+        words[i / 64] |= UInt64(1) << UInt64(i % 64)
+    }
+    return words
+}
@@ -0,0 +1,414 @@
+//
+//  CBinding+BatchCode.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+/// Scalar machine variable stored as an array by a batch executor.
+public struct BatchVariable: Equatable, Hashable {
+    /// The arithmetic C type of the variable.
+    public let type: String
+    /// The name of the variable.
+    public let name: String
+
+    /// Designated initialiser.
+    ///
+    /// - Parameters:
+    ///   - type: The arithmetic C type of the variable.
+    ///   - name: The name of the variable.
+    @inlinable
+    public init(type: String, name: String) {
+        self.type = type
+        self.name = name
+    }
+}
+
+/// Arithmetic type keywords that can be stored in batch arrays.
+private let batchTypeKeywords: Set<String> = ["bool", "_Bool", "char", "short", "int", "long", "signed", "unsigned", "float", "double"]
+
+/// Arithmetic type names that can be stored in batch arrays.
+private let batchTypeNames: Set<String> = ["int8_t", "int16_t", "int32_t", "int64_t", "uint8_t", "uint16_t", "uint32_t", "uint64_t", "intptr_t", "uintptr_t", "size_t", "ptrdiff_t"]
+
+/// Operators and punctuators that prevent batch execution.
+private let batchUnsupportedPunctuation: Set<String> = ["[", "]", "{", "}", ".", ","]
+
+/// Operators that prevent a guard from being evaluated for a whole batch.
+private let batchGuardSideEffects: Set<String> = ["=", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "<<=", ">>=", "++", "--", ";"]
+
+/// Return the scalar machine variables declared in the given code.
+///
+/// - Parameter declarations: The machine variable declarations.
+/// - Returns: The variables or `nil` if a declaration is not a plain arithmetic scalar.
+func batchVariables(in declarations: String) -> [BatchVariable]? {
+    var variables = [BatchVariable]()
+    for statement in cTokens(of: declarations).split(separator: .punctuation(";")) {
+        let declarators = statement.split(separator: .punctuation(","), omittingEmptySubsequences: false)
+        let names = declarators.map { declarator in
+            declarator.compactMap { token -> String? in
+                if case .identifier(let name) = token { return name } else { return nil }
+            }
+        }
+        guard let words = names.first, words.count >= 2,
+              zip(declarators, names).allSatisfy({ $0.count == $1.count }),
+              names.dropFirst().allSatisfy({ $0.count == 1 }) else { return nil }
+        let typeWords = words.dropLast()
+        guard typeWords.allSatisfy(batchTypeKeywords.contains) ||
+                (typeWords.count == 1 && batchTypeNames.contains(typeWords[0])) else { return nil }
+        let type = typeWords.joined(separator: " ")
+        variables += names.compactMap(\.last).map { BatchVariable(type: type, name: $0) }
+    }
+    return variables
+}
+
+/// Return whether the given action or guard can be executed as part of a batch.
+///
+/// Batchable code only consists of arithmetic over machine
+/// variables accessed through `machine->`, numeric literals,
+/// and `true` or `false`.  Guards must not have side effects.
+///
+/// - Parameters:
+///   - code: The action or guard code.
+///   - variables: The names of the machine variables.
+///   - isGuard: Set to `true` to check a transition guard.
+/// - Returns: `true` iff the code can be rewritten for batch execution.
+func isBatchable(_ code: String, variables: Set<String>, isGuard: Bool = false) -> Bool {
+    guard !code.contains("#"), !code.contains("\""), !code.contains("'") else { return false }
+    let tokens = cTokens(of: code)
+    for (i, token) in tokens.enumerated() {
+        switch token {
+        case .number:
+            continue
+        case .identifier("machine"):
+            guard i + 2 < tokens.count, tokens[i+1] == .punctuation("->"),
+                  case .identifier(let variable) = tokens[i+2], variables.contains(variable) else { return false }
+        case .identifier(let name):
+            guard (i > 0 && tokens[i-1] == .punctuation("->")) || name == "true" || name == "false" else { return false }
+        case .punctuation(let op):
+            guard !batchUnsupportedPunctuation.contains(op), !isGuard || !batchGuardSideEffects.contains(op) else { return false }
+        }
+    }
+    return true
+}
+
+/// Return whether the given state can be batch executed.
+///
+/// A state can be batch executed if it has no state variables,
+/// and all of its actions and guards are batchable.
+///
+/// - Parameters:
+///   - stateID: The ID of the state to examine.
+///   - llfsm: The finite-state machine containing the state.
+///   - boilerplate: The boilerplate of the state.
+///   - variables: The names of the machine variables.
+/// - Returns: `true` iff the state can be part of a batch.
+func isBatchable(state stateID: StateID, of llfsm: LLFSM, boilerplate: (any Boilerplate)?, variables: Set<String>) -> Bool {
+    let actions: [CBoilerplate.SectionName] = [.onEntry, .onExit, .internal, .onSuspend, .onResume]
+    let transitions = llfsm.transitionsFrom(stateID)
+    guard let boilerplate, transitions.count < Int(UInt8.max),
+          declaredIdentifiers(in: boilerplate.getSection(named: CBoilerplate.SectionName.variables.rawValue)).isEmpty,
+          actions.allSatisfy({ isBatchable(boilerplate.getSection(named: $0.rawValue), variables: variables) }) else { return false }
+    return transitions.allSatisfy {
+        llfsm.transitionMap[$0].map { isBatchable($0.label, variables: variables, isGuard: true) } ?? false
+    }
+}
+
+/// Return the machine variables of a machine that can be batch executed.
+///
+/// A machine can be batch executed if its machine variables are
+/// plain arithmetic scalars, its states have no state variables,
+/// and all of its actions and guards are batchable.
+///
+/// - Parameters:
+///   - llfsm: The finite-state machine to examine.
+///   - boilerplate: The machine boilerplate.
+///   - stateBoilerplate: The boilerplate of each state.
+/// - Returns: The variables to store as arrays or `nil` if the machine cannot be batch executed.
+public func batchVariables(for llfsm: LLFSM, boilerplate: any Boilerplate, stateBoilerplate: [StateID : any Boilerplate]) -> [BatchVariable]? {
+    guard llfsm.states.count < Int(UInt16.max),
+          let variables = batchVariables(in: boilerplate.getSection(named: CBoilerplate.SectionName.variables.rawValue)) else { return nil }
+    let names = Set(variables.map(\.name))
+    guard llfsm.states.allSatisfy({ isBatchable(state: $0, of: llfsm, boilerplate: stateBoilerplate[$0], variables: names) }) else { return nil }
+    return variables
+}
+
+/// Batchability of a machine, cached per state.
+///
+/// This allows incremental updates to only re-examine
+/// the states that were edited, rather than all the
+/// actions and guards of the machine.
+public struct BatchAnalysis {
+    /// The scalar machine variables (`nil` if they cannot be stored as arrays).
+    public let variables: [BatchVariable]?
+    /// The states that cannot be batch executed.
+    public private(set) var unbatchableStates = Set<StateID>()
+
+    /// Examine all states of the given machine.
+    ///
+    /// - Parameters:
+    ///   - llfsm: The finite-state machine to examine.
+    ///   - boilerplate: The machine boilerplate.
+    ///   - stateBoilerplate: The boilerplate of each state.
+    public init(for llfsm: LLFSM, boilerplate: any Boilerplate, stateBoilerplate: [StateID : any Boilerplate]) {
+        variables = batchVariables(in: boilerplate.getSection(named: CBoilerplate.SectionName.variables.rawValue))
+        update(states: llfsm.states, of: llfsm, stateBoilerplate: stateBoilerplate)
+    }
+
+    /// Re-examine the given states.
+    ///
+    /// - Parameters:
+    ///   - stateIDs: The states that were edited.
+    ///   - llfsm: The finite-state machine containing the states.
+    ///   - stateBoilerplate: The boilerplate of (at least) the given states.
+    public mutating func update(states stateIDs: [StateID], of llfsm: LLFSM, stateBoilerplate: [StateID : any Boilerplate]) {
+        guard let variables else { return }
+        let names = Set(variables.map(\.name))
+        for stateID in stateIDs {
+            if llfsm.stateMap[stateID] == nil || isBatchable(state: stateID, of: llfsm, boilerplate: stateBoilerplate[stateID], variables: names) {
+                unbatchableStates.remove(stateID)
+            } else {
+                unbatchableStates.insert(stateID)
+            }
+        }
+    }
+
+    /// Return the variables to store as arrays if the whole machine can be batch executed.
+    ///
+    /// - Parameter llfsm: The finite-state machine that was examined.
+    /// - Returns: The variables or `nil` if the machine cannot be batch executed.
+    public func variables(for llfsm: LLFSM) -> [BatchVariable]? {
+        guard llfsm.states.count < Int(UInt16.max), unbatchableStates.isEmpty else { return nil }
+        return variables
+    }
+}
+
+/// Return the C boilerplate of the states previously added to the given wrapper.
+///
+/// - Parameters:
+///   - llfsm: The finite-state machine whose states to examine.
+///   - wrapper: The `MachineWrapper` containing the state boilerplate.
+///   - states: The states to return the boilerplate for (defaults to all states).
+/// - Returns: The boilerplate of each state.
+@usableFromInline
+func cStateBoilerplate(for llfsm: LLFSM, in wrapper: MachineWrapper, states: [StateID]? = nil) -> [StateID : any Boilerplate] {
+    Dictionary((states ?? llfsm.states).compactMap { stateID in
+        llfsm.stateMap[stateID].map { (stateID, boilerplateofCState($0.name, of: wrapper)) }
+    }, uniquingKeysWith: { a, _ in a })
+}
+
+/// Rewrite batchable code to access the variables of instance `i`.
+///
+/// - Parameter code: The batchable action or guard code.
+/// - Returns: The code accessing the batch arrays.
+func batchCode(for code: String) -> String {
+    code.replacing(#/machine\s*->\s*([A-Za-z_][A-Za-z0-9_]*)/#) { "\($0.1)[i]" }
+}
+
+/// Create the C include file for a batch executor.
+///
+/// The batch executor stores the machine variables of many
+/// instances of the same machine in struct-of-arrays form.
+///
+/// - Parameters:
+///   - llfsm: The finite-state machine to create code for.
+///   - name: The name of the LLFSM.
+///   - isSuspensible: Set to `true` to create an interface that supports suspension.
+///   - variables: The machine variables to store as arrays.
+/// - Returns: The batch executor interface.
+public func cMachineBatchInterface(for llfsm: LLFSM, named name: String, isSuspensible: Bool, variables: [BatchVariable]) -> Code {
+    let upperName = name.uppercased()
+    let lowerName = name.lowercased()
+    return """
+    //
+    // Machine_\(name)_Batch.h
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+
+    """ + .includeFile(named: "LLFSM_MACHINE_" + upperName + "_BATCH_H") {
+        "#include <stdbool.h>"
+        "#include <stddef.h>"
+        "#include <stdint.h>"
+        ""
+        "#define MACHINE_" + upperName + "_BATCH_NUMBER_OF_STATES \(llfsm.states.count)"
+        ""
+        "/// Struct-of-arrays batch of \(name) instances."
+        "///"
+        "/// Each machine variable is stored in its own array,"
+        "/// indexed by instance, so that the guards of a state"
+        "/// can be evaluated for all instances in that state"
+        "/// in a single, vectorisable loop."
+        "struct Machine_" + name + "_Batch"
+        Code.bracketedBlock(openingBracket: "{\n", closingBracket: "};\n") {
+            "size_t    count;           ///< The number of instances."
+            "uint16_t *current_state;   ///< The current state index of each instance."
+            "uint8_t  *needs_entry;     ///< Whether the onEntry action of each instance is due."
+            "uint32_t *order;           ///< Scratch: instance indices grouped by state."
+            "uint8_t  *fired;           ///< Scratch: the transition fired by each grouped instance."
+            Code.forEach(variables) { variable in
+                variable.type + " *" + variable.name + "; ///< The `\(variable.name)` machine variable of each instance."
+            }
+        }
+        "/// Initialise a batch of \(name) instances."
+        "///"
+        "/// All instances start in the initial state"
+        "/// with their machine variables set to zero."
+        "///"
+        "/// - Parameters:"
+        "///   - batch: The batch to initialise."
+        "///   - count: The number of instances."
+        "/// - Returns: `true` iff the batch arrays could be allocated."
+        "bool fsm_" + lowerName + "_batch_init(struct Machine_" + name + "_Batch * const batch, const size_t count);"
+        ""
+        "/// Release the arrays of a batch of \(name) instances."
+        "///"
+        "/// - Parameter batch: The batch to free."
+        "void fsm_" + lowerName + "_batch_free(struct Machine_" + name + "_Batch * const batch);"
+        ""
+        "/// Execute one ringlet of every instance in the batch."
+        "///"
+        "/// Instances are grouped by their current state"
+        "/// and each group is executed state by state."
+        if isSuspensible {
+            "/// Suspension is not supported by the batch executor."
+        }
+        "///"
+        "/// - Parameter batch: The batch to execute."
+        "void fsm_" + lowerName + "_batch_execute_once(struct Machine_" + name + "_Batch * const batch);"
+    }
+}
+
+/// Create the C code for a batch executor.
+///
+/// Each state gets a function that runs the onEntry actions,
+/// evaluates the guards, and runs the onExit or internal actions
+/// for all instances in that state, each in a separate loop
+/// over arrays qualified as `restrict`, so the compiler can
+/// vectorise them (e.g. using SSE, AVX2, or NEON).
+///
+/// - Parameters:
+///   - llfsm: The finite-state machine to create code for.
+///   - name: The name of the LLFSM.
+///   - isSuspensible: Set to `true` to create an interface that supports suspension.
+///   - variables: The machine variables to store as arrays.
+///   - stateBoilerplate: The boilerplate of each state.
+/// - Returns: The batch executor code.
+public func cMachineBatchCode(for llfsm: LLFSM, named name: String, isSuspensible: Bool, variables: [BatchVariable], stateBoilerplate: [StateID : any Boilerplate]) -> Code {
+    let upperName = name.uppercased()
+    let lowerName = name.lowercased()
+    let arrays = ["current_state", "needs_entry", "order", "fired"] + variables.map(\.name)
+    return .block {
+        "//"
+        "// Machine_\(name)_Batch.c"
+        "//"
+        "// Automatically created using fsmconvert -- do not change manually!"
+        "//"
+        "#include <stdlib.h>"
+        "#include <string.h>"
+        "#include \"Machine_\(name)_Batch.h\""
+        ""
+        "bool fsm_" + lowerName + "_batch_init(struct Machine_" + name + "_Batch * const batch, const size_t count)"
+        Code.bracedBlock {
+            "const size_t n = count ? count : 1;"
+            "batch->count = count;"
+            Code.forEach(arrays) { array in
+                "batch->" + array + " = calloc(n, sizeof *batch->" + array + ");"
+            }
+            "if (" + arrays.map { "!batch->" + $0 }.joined(separator: " || ") + ")"
+            Code.bracedBlock {
+                "fsm_" + lowerName + "_batch_free(batch);"
+                "return false;"
+            }
+            "memset(batch->needs_entry, 1, n * sizeof *batch->needs_entry);"
+            "return true;"
+        }
+        ""
+        "void fsm_" + lowerName + "_batch_free(struct Machine_" + name + "_Batch * const batch)"
+        Code.bracedBlock {
+            Code.forEach(arrays) { array in
+                "free(batch->" + array + ");"
+                "batch->" + array + " = NULL;"
+            }
+            "batch->count = 0;"
+        }
+        ""
+        "#pragma GCC diagnostic push"
+        "#pragma GCC diagnostic ignored \"-Wunused-variable\""
+        ""
+        Code.enumerating(array: llfsm.states) { s, stateID in
+            let stateName = llfsm.stateMap[stateID]?.name ?? "State_\(s)"
+            let state = stateBoilerplate[stateID]
+            let section = { (section: CBoilerplate.SectionName) in
+                batchCode(for: state?.getSection(named: section.rawValue).trimmed ?? "")
+            }
+            let transitions = llfsm.transitionsFrom(stateID).compactMap { llfsm.transitionMap[$0] }
+            let targets = transitions.map { transition in llfsm.states.firstIndex(of: transition.target) ?? s } + [s]
+            "/// Execute a ringlet of the instances in the \(stateName) state."
+            "///"
+            "/// - Parameters:"
+            "///   - batch: The batch the instances belong to."
+            "///   - order: The indices of the instances in the \(stateName) state."
+            "///   - fired: Scratch array for the transitions fired."
+            "///   - n: The number of instances in the \(stateName) state."
+            "static void fsm_" + lowerName + "_batch_" + stateName.lowercased() + "(struct Machine_" + name + "_Batch * const batch, const uint32_t * const restrict order, uint8_t * const restrict fired, const size_t n)"
+            Code.bracedBlock {
+                "static const uint16_t targets[\(targets.count)] = { " + targets.map(String.init).joined(separator: ", ") + " };"
+                "uint16_t * const restrict current_state = batch->current_state;"
+                "uint8_t * const restrict needs_entry = batch->needs_entry;"
+                Code.forEach(variables) { variable in
+                    variable.type + " * const restrict " + variable.name + " = batch->" + variable.name + ";"
+                }
+                if !section(.onEntry).isEmpty {
+                    "for (size_t k = 0; k < n; k++)"
+                    Code.bracedBlock {
+                        "const uint32_t i = order[k];"
+                        "if (!needs_entry[i]) continue;"
+                        section(.onEntry)
+                    }
+                }
+                "for (size_t k = 0; k < n; k++)"
+                Code.bracedBlock {
+                    "const uint32_t i = order[k];"
+                    "fired[k] = " + transitions.enumerated().map { t, transition in
+                        "(" + batchCode(for: transition.label.trimmed) + ") ? \(t) : "
+                    }.joined() + "\(transitions.count);"
+                }
+                "for (size_t k = 0; k < n; k++)"
+                Code.bracedBlock {
+                    "const uint32_t i = order[k];"
+                    "const uint16_t target = targets[fired[k]];"
+                    if !transitions.isEmpty {
+                        "if (fired[k] < \(transitions.count))"
+                        Code.bracedBlock {
+                            section(.onExit)
+                        }
+                        "else"
+                    }
+                    Code.bracedBlock {
+                        section(.internal)
+                    }
+                    "needs_entry[i] = target != \(s);"
+                    "current_state[i] = target;"
+                }
+            }
+            ""
+        }
+        "#pragma GCC diagnostic pop"
+        ""
+        "void fsm_" + lowerName + "_batch_execute_once(struct Machine_" + name + "_Batch * const batch)"
+        Code.bracedBlock {
+            "const size_t count = batch->count;"
+            "const uint16_t * const current_state = batch->current_state;"
+            "uint32_t * const order = batch->order;"
+            "size_t offset[MACHINE_\(upperName)_BATCH_NUMBER_OF_STATES + 1] = { 0 };"
+            "size_t fill[MACHINE_\(upperName)_BATCH_NUMBER_OF_STATES];"
+            "for (size_t i = 0; i < count; i++) offset[current_state[i] + 1]++;"
+            "for (size_t s = 0; s < MACHINE_\(upperName)_BATCH_NUMBER_OF_STATES; s++) offset[s + 1] += offset[s];"
+            "memcpy(fill, offset, sizeof fill);"
+            "for (size_t i = 0; i < count; i++) order[fill[current_state[i]]++] = (uint32_t)i;"
+            Code.enumerating(array: llfsm.states) { s, stateID in
+                let stateName = llfsm.stateMap[stateID]?.name ?? "State_\(s)"
+                "fsm_" + lowerName + "_batch_" + stateName.lowercased() + "(batch, order + offset[\(s)], batch->fired + offset[\(s)], offset[\(s + 1)] - offset[\(s)]);"
+            }
+        }
+    } + "\n"
+}
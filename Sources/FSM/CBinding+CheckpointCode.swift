@@ -0,0 +1,351 @@
+//
+//  CBinding+CheckpointCode.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+/// Return the checkpoint and restore code for a C-language LLFSM arrangement.
+///
+/// The generated checkpoint is a versioned binary blob containing,
+/// for every machine, the indices of its current, previous,
+/// (suspend and resume) states, its `state_time`, as well as the
+/// variable blocks of the machine and each of its states,
+/// followed by the contents of every channel in order.
+/// A layout hash combining the arrangement structure and the
+/// variable declarations with the sizes and offsets of the
+/// generated C structs protects against restoring a checkpoint
+/// created by a different build.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+///   - variables: The variable declarations of each machine type (see `variableDeclarations(of:)`).
+///   - channels: The message channels between the instances.
+/// - Returns: The LLFSM arrangement checkpoint code.
+public func cArrangementCheckpointCode(for instances: [Instance], named name: String, isSuspensible: Bool, variables: [Substring : String] = [:], channels: [Channel] = []) -> Code {
+    let machines = Dictionary(instances.map { ($0.typeName, $0) }, uniquingKeysWith: { a,_ in a })
+        .sorted { $0.key < $1.key }
+    let lastFunction = isSuspensible ? "on_resume" : "internal"
+    let numberOfIndices = isSuspensible ? 4 : 2
+    let structure = ([name, isSuspensible ? "suspensible" : "non-suspensible"] + instances.map { instance in
+        instance.name + ":" + instance.typeName + ":" + instance.fsm.states.compactMap { instance.fsm.stateMap[$0]?.name }.joined(separator: ",")
+    } + machines.map { machine, _ in
+        String(machine) + ":\n" + (variables[machine] ?? "")
+    } + channels.map { channel in
+        "channel " + channel.name + ":" + channel.elementType + "[\(channel.capacity)]"
+    }).joined(separator: "\n")
+    return """
+    //
+    // Arrangement_\(name)_Checkpoint.c
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+    #include <stddef.h>
+    #include <string.h>
+    #include \"Machine_Common.h\"
+    #include \"Arrangement_\(name).h\"
+
+    """ + Code.forEach(machines) { (machine, instance) in
+        "#include \"" + machine + ".machine/Machine_" + machine + ".h\""
+        Code.forEach(instance.fsm.states.compactMap {
+            instance.fsm.stateMap[$0]
+        }) { state in
+            "#include \"" + machine + ".machine/State_" + state.name + ".h\""
+        }
+    } + "\n\n" + """
+    #pragma clang diagnostic push
+    #pragma clang diagnostic ignored \"-Wunused-macros\"
+    #pragma clang diagnostic ignored \"-Wcast-align\"
+
+    #ifndef NULL
+    #define NULL ((void*)0)
+    #endif
+
+    """ + .block {
+        "#define CHECKPOINT_MAGIC UINT32_C(0x4b434c4c)"
+        "#define CHECKPOINT_VERSION 1"
+        "#define CHECKPOINT_NO_STATE UINT32_MAX"
+        "#define CHECKPOINT_STRUCTURE_HASH UINT64_C(0x" + String(fnv1aHash(of: structure), radix: 16) + ")"
+        ""
+        "/// Offset of the variables following the given struct member."
+        "#define VARIABLES_OFFSET(type, member) (offsetof(type, member) + sizeof(((type *)0)->member))"
+        "/// Size of the variables following the given struct member."
+        "#define VARIABLES_SIZE(type, member) (sizeof(type) - VARIABLES_OFFSET(type, member))"
+        ""
+        "/// Checkpoint header."
+        "struct llfsm_checkpoint_header"
+        Code.bracedBlock {
+            "uint32_t magic;"
+            "uint32_t version;"
+            "uint64_t layout_hash;"
+            "uint64_t size;"
+        } + ";"
+        ""
+        Code.forEach(machines) { (machine, instance) in
+            let upperMachine = machine.uppercased()
+            let states = instance.fsm.states.compactMap { instance.fsm.stateMap[$0] }
+            "/// Size of the checkpoint of a \(machine) LLFSM."
+            "#define CHECKPOINT_SIZE_\(upperMachine) (sizeof(uint32_t[\(numberOfIndices)]) + sizeof(uint64_t) + VARIABLES_SIZE(struct Machine_\(machine), states) \\"
+            Code.forEach(states) { state in
+                "    + VARIABLES_SIZE(struct FSM\(machine)_State_\(state.name), \(lastFunction)) \\"
+            }
+            ")"
+            ""
+        }
+        if !channels.isEmpty {
+            "/// Size of the checkpoint of all channels."
+            "#define CHECKPOINT_SIZE_CHANNELS (0 \\"
+            Code.forEach(channels) { channel in
+                "    + sizeof(uint64_t) + sizeof(llfsm_channel_\(channel.name).buffer) \\"
+            }
+            ")"
+            ""
+        }
+        "/// Sizes and offsets of the checkpointed structs."
+        "static const uint64_t checkpoint_layout[] ="
+        Code.bracedBlock {
+            Code.forEach(machines) { (machine, instance) in
+                "sizeof(struct Machine_\(machine)), VARIABLES_OFFSET(struct Machine_\(machine), states),"
+                Code.forEach(instance.fsm.states.compactMap { instance.fsm.stateMap[$0] }) { state in
+                    "sizeof(struct FSM\(machine)_State_\(state.name)), VARIABLES_OFFSET(struct FSM\(machine)_State_\(state.name), \(lastFunction)),"
+                }
+            }
+            "0"
+        } + ";"
+        ""
+        "/// Return the hash of the checkpoint layout."
+        "///"
+        "/// - Returns: The FNV-1a hash of the arrangement structure and struct layout."
+        "static uint64_t checkpoint_layout_hash(void)"
+        Code.bracedBlock {
+            "const unsigned char * const layout = (const unsigned char *)checkpoint_layout;"
+            "uint64_t hash = CHECKPOINT_STRUCTURE_HASH;"
+            "size_t i;"
+            "for (i = 0; i < sizeof(checkpoint_layout); i++)"
+            Code.bracedBlock {
+                "hash ^= layout[i];"
+                "hash *= UINT64_C(0x100000001b3);"
+            }
+            "return hash;"
+        }
+        ""
+        "/// Return the index of the given state."
+        "///"
+        "/// - Parameters:"
+        "///   - states: The states of the machine."
+        "///   - n: The number of states."
+        "///   - state: The state to look up."
+        "/// - Returns: The index of the state or `CHECKPOINT_NO_STATE`."
+        "static uint32_t checkpoint_state_index(struct LLFSMState * const *states, uint32_t n, const struct LLFSMState *state)"
+        Code.bracedBlock {
+            "uint32_t i;"
+            "if (!state) return CHECKPOINT_NO_STATE;"
+            "for (i = 0; i < n; i++) if (states[i] == state) return i;"
+            "return CHECKPOINT_NO_STATE;"
+        }
+        ""
+        Code.forEach(machines) { (machine, instance) in
+            let lowerMachine = machine.lowercased()
+            let upperMachine = machine.uppercased()
+            let states = instance.fsm.states.compactMap { instance.fsm.stateMap[$0] }
+            "/// Checkpoint a \(machine) LLFSM."
+            "///"
+            "/// - Parameters:"
+            "///   - machine: The machine to checkpoint."
+            "///   - p: The buffer position to write to."
+            "/// - Returns: The buffer position following the checkpoint."
+            "static unsigned char *checkpoint_\(lowerMachine)(const struct Machine_\(machine) * const machine, unsigned char *p)"
+            Code.bracedBlock {
+                "const uint32_t n = MACHINE_\(upperMachine)_NUMBER_OF_STATES;"
+                "const uint32_t indices[\(numberOfIndices)] ="
+                Code.bracedBlock {
+                    "checkpoint_state_index(machine->states, n, machine->current_state),"
+                    "checkpoint_state_index(machine->states, n, machine->previous_state)" + (isSuspensible ? "," : "")
+                    if isSuspensible {
+                        "checkpoint_state_index(machine->states, n, machine->suspend_state),"
+                        "checkpoint_state_index(machine->states, n, machine->resume_state)"
+                    }
+                } + ";"
+                "const uint64_t state_time = machine->state_time;"
+                "memcpy(p, indices, sizeof(indices));"
+                "p += sizeof(indices);"
+                "memcpy(p, &state_time, sizeof(state_time));"
+                "p += sizeof(state_time);"
+                "memcpy(p, (const unsigned char *)machine + VARIABLES_OFFSET(struct Machine_\(machine), states), VARIABLES_SIZE(struct Machine_\(machine), states));"
+                "p += VARIABLES_SIZE(struct Machine_\(machine), states);"
+                Code.enumerating(array: states) { i, state in
+                    let type = "struct FSM\(machine)_State_\(state.name)"
+                    "memcpy(p, (const unsigned char *)machine->states[\(i)] + VARIABLES_OFFSET(\(type), \(lastFunction)), VARIABLES_SIZE(\(type), \(lastFunction)));"
+                    "p += VARIABLES_SIZE(\(type), \(lastFunction));"
+                }
+                "return p;"
+            }
+            ""
+            "/// Restore a \(machine) LLFSM."
+            "///"
+            "/// - Parameters:"
+            "///   - machine: The machine to restore."
+            "///   - p: The buffer position to read from."
+            "/// - Returns: The buffer position following the checkpoint."
+            "static const unsigned char *restore_\(lowerMachine)(struct Machine_\(machine) * const machine, const unsigned char *p)"
+            Code.bracedBlock {
+                "const uint32_t n = MACHINE_\(upperMachine)_NUMBER_OF_STATES;"
+                "uint32_t indices[\(numberOfIndices)];"
+                "uint64_t state_time;"
+                "memcpy(indices, p, sizeof(indices));"
+                "p += sizeof(indices);"
+                "memcpy(&state_time, p, sizeof(state_time));"
+                "p += sizeof(state_time);"
+                "machine->current_state = indices[0] < n ? machine->states[indices[0]] : machine->states[0];"
+                "machine->previous_state = indices[1] < n ? machine->states[indices[1]] : NULL;"
+                if isSuspensible {
+                    "machine->suspend_state = indices[2] < n ? machine->states[indices[2]] : NULL;"
+                    "machine->resume_state = indices[3] < n ? machine->states[indices[3]] : NULL;"
+                }
+                "machine->state_time = (uintptr_t)state_time;"
+                "memcpy((unsigned char *)machine + VARIABLES_OFFSET(struct Machine_\(machine), states), p, VARIABLES_SIZE(struct Machine_\(machine), states));"
+                "p += VARIABLES_SIZE(struct Machine_\(machine), states);"
+                Code.enumerating(array: states) { i, state in
+                    let type = "struct FSM\(machine)_State_\(state.name)"
+                    "memcpy((unsigned char *)machine->states[\(i)] + VARIABLES_OFFSET(\(type), \(lastFunction)), p, VARIABLES_SIZE(\(type), \(lastFunction)));"
+                    "p += VARIABLES_SIZE(\(type), \(lastFunction));"
+                }
+                "return p;"
+            }
+            ""
+        }
+        Code.forEach(channels) { channel in
+            let c = "llfsm_channel_" + channel.name
+            "/// Checkpoint the `\(channel.name)` channel of the calling thread."
+            "///"
+            "/// The values get stored in order, starting at the head,"
+            "/// so equal channel contents yield equal checkpoints."
+            "///"
+            "/// - Parameter p: The buffer position to write to."
+            "/// - Returns: The buffer position following the checkpoint."
+            "static unsigned char *checkpoint_channel_\(channel.name)(unsigned char *p)"
+            Code.bracedBlock {
+                "const uintptr_t head = atomic_load_explicit(&\(c).head, memory_order_acquire);"
+                "const uint64_t count = atomic_load_explicit(&\(c).tail, memory_order_acquire) - head;"
+                "uint64_t i;"
+                "memcpy(p, &count, sizeof(count));"
+                "p += sizeof(count);"
+                "memset(p, 0, sizeof(\(c).buffer));"
+                "for (i = 0; i < count; i++) memcpy(p + i * sizeof(\(c).buffer[0]), &\(c).buffer[(head + i) & \(channel.capacity - 1)], sizeof(\(c).buffer[0]));"
+                "return p + sizeof(\(c).buffer);"
+            }
+            ""
+            "/// Restore the `\(channel.name)` channel of the calling thread."
+            "///"
+            "/// - Parameter p: The buffer position to read from."
+            "/// - Returns: The buffer position following the checkpoint."
+            "static const unsigned char *restore_channel_\(channel.name)(const unsigned char *p)"
+            Code.bracedBlock {
+                "uint64_t count;"
+                "memcpy(&count, p, sizeof(count));"
+                "p += sizeof(count);"
+                "if (count > \(channel.capacity)) count = \(channel.capacity);"
+                "memcpy(\(c).buffer, p, sizeof(\(c).buffer));"
+                "atomic_store_explicit(&\(c).head, 0, memory_order_relaxed);"
+                "atomic_store_explicit(&\(c).tail, (uintptr_t)count, memory_order_release);"
+                "return p + sizeof(\(c).buffer);"
+            }
+            ""
+        }
+        "/// Return the size of a checkpoint of the \(name) arrangement."
+        "///"
+        "/// - Returns: The number of bytes required for a checkpoint."
+        "size_t fsm_arrangement_checkpoint_size(void)"
+        Code.bracedBlock {
+            "return sizeof(struct llfsm_checkpoint_header)"
+            Code.forEach(instances) { instance in
+                "    + CHECKPOINT_SIZE_\(instance.typeName.uppercased())"
+            }
+            if !channels.isEmpty {
+                "    + CHECKPOINT_SIZE_CHANNELS"
+            }
+            "    ;"
+        }
+        ""
+        "/// Checkpoint the runtime state of the \(name) arrangement."
+        "///"
+        "/// - Parameters:"
+        "///   - arrangement: The arrangement to checkpoint."
+        "///   - buffer: The buffer to write the checkpoint to."
+        "///   - size: The size of the buffer in bytes."
+        "/// - Returns: The size of the checkpoint or `0` if the buffer is too small."
+        "size_t fsm_arrangement_checkpoint(const struct LLFSMArrangement * const arrangement, void * const buffer, size_t size)"
+        Code.bracedBlock {
+            "const struct Arrangement_\(name) * const a = (const struct Arrangement_\(name) *)arrangement;"
+            "const size_t checkpoint_size = fsm_arrangement_checkpoint_size();"
+            "if (size < checkpoint_size) return 0;"
+            "const struct llfsm_checkpoint_header header = { CHECKPOINT_MAGIC, CHECKPOINT_VERSION, checkpoint_layout_hash(), checkpoint_size };"
+            "unsigned char *p = buffer;"
+            "memcpy(p, &header, sizeof(header));"
+            "p += sizeof(header);"
+            Code.forEach(instances) { instance in
+                "p = checkpoint_\(instance.typeName.lowercased())(a->fsm_\(instance.name.lowercased()), p);"
+            }
+            Code.forEach(channels) { channel in
+                "p = checkpoint_channel_\(channel.name)(p);"
+            }
+            "return checkpoint_size;"
+        }
+        ""
+        "/// Restore the runtime state of the \(name) arrangement."
+        "///"
+        "/// - Parameters:"
+        "///   - arrangement: The arrangement to restore."
+        "///   - buffer: The buffer containing the checkpoint."
+        "///   - size: The size of the checkpoint in bytes."
+        "/// - Returns: `true` iff the checkpoint matched this build and was restored."
+        "bool fsm_arrangement_restore(struct LLFSMArrangement * const arrangement, const void * const buffer, size_t size)"
+        Code.bracedBlock {
+            "struct Arrangement_\(name) * const a = (struct Arrangement_\(name) *)arrangement;"
+            "const size_t checkpoint_size = fsm_arrangement_checkpoint_size();"
+            "struct llfsm_checkpoint_header header;"
+            "if (size != checkpoint_size) return false;"
+            "memcpy(&header, buffer, sizeof(header));"
+            "if (header.magic != CHECKPOINT_MAGIC || header.version != CHECKPOINT_VERSION ||"
+            "    header.size != checkpoint_size || header.layout_hash != checkpoint_layout_hash()) return false;"
+            "const unsigned char *p = (const unsigned char *)buffer + sizeof(header);"
+            Code.forEach(instances) { instance in
+                "p = restore_\(instance.typeName.lowercased())(a->fsm_\(instance.name.lowercased()), p);"
+            }
+            Code.forEach(channels) { channel in
+                "p = restore_channel_\(channel.name)(p);"
+            }
+            if isSuspensible {
+                "arrangement->activity_epoch = LLFSM_ACTIVITY_EPOCH_INVALID;"
+            }
+            "return true;"
+        }
+        ""
+        "#pragma clang diagnostic pop"
+    } + "\n"
+}
+
+/// Return the variable declarations of a machine and its states.
+///
+/// The declarations are the trimmed content of the
+/// `_Variables.h` sections of the machine and of
+/// each of its states, in state order.
+///
+/// - Parameter machine: The machine to examine.
+/// - Returns: The variable declarations.
+func variableDeclarations(of machine: Machine) -> String {
+    ([machine.boilerplate.getSection(named: "variables").trimmed] + machine.llfsm.states.compactMap { stateID in
+        machine.llfsm.stateMap[stateID].map { $0.name + ":\n" + (machine.stateBoilerplate[stateID]?.getSection(named: "variables").trimmed ?? "") }
+    }).joined(separator: "\n")
+}
+
+/// Return the 64-bit FNV-1a hash of the given string.
+///
+/// - Parameter string: The string to hash.
+/// - Returns: The hash of the UTF-8 representation of the string.
+func fnv1aHash(of string: String) -> UInt64 {
+    string.utf8.reduce(UInt64(0xcbf29ce484222325)) { hash, byte in
+        (hash ^ UInt64(byte)) &* 0x100000001b3
+    }
+}
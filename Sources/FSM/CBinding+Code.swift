@@ -10,8 +10,9 @@
 ///   - llfsm: The finite-state machine to create code for.
 ///   - name: The name of the LLFSM.
 ///   - isSuspensible: Set to `true` to create an interface that supports suspension.
+///   - isTraceable: Set to `true` to define the USDT probes fired by the machine.
 /// - Returns:
-public func cMachineInterface(for llfsm: LLFSM, named name: String, isSuspensible: Bool) -> Code {
+public func cMachineInterface(for llfsm: LLFSM, named name: String, isSuspensible: Bool, isTraceable: Bool = false) -> Code {
     let upperName = name.uppercased()
     let lowerName = name.lowercased()
     return """
@@ -34,6 +35,10 @@ public func cMachineInterface(for llfsm: LLFSM, named name: String, isSuspensibl
         "#include \"Machine_" + name + "_Custom.h\""
         "#endif"
         ""
+        "#ifdef INCLUDE_MACHINE_COMMON"
+        "#include \"Machine_Common.h\""
+        "#endif"
+        ""
         "#pragma GCC diagnostic push"
         "#pragma GCC diagnostic ignored \"-Wunknown-pragmas\""
         ""
@@ -57,6 +62,29 @@ public func cMachineInterface(for llfsm: LLFSM, named name: String, isSuspensibl
         "#ifndef TAKE_SNAPSHOT"
         "#define TAKE_SNAPSHOT()"
         "#endif"
+        if isTraceable {
+            cTraceProbeMacros()
+        }
+        ""
+        "// Protothread-style coroutines for long-running state actions."
+        "// Locals do not survive a YIELD(), so keep progress in variables."
+        "// Only internal actions can yield: they resume in the next ringlet"
+        "// that does not fire a transition, the other actions run only once."
+        "#ifndef ACTION_BEGIN"
+        "#define ACTION_BEGIN() switch (*llfsm_pt_resume) { case 0:"
+        "#endif"
+        "#ifndef YIELD"
+        "#define YIELD() do { *llfsm_pt_resume = __LINE__; return; case __LINE__:; } while (0)"
+        "#endif"
+        "#ifndef WAIT_UNTIL"
+        "#define WAIT_UNTIL(c) do { *llfsm_pt_resume = __LINE__; case __LINE__: if (!(c)) return; } while (0)"
+        "#endif"
+        "#ifndef ACTION_END"
+        "#define ACTION_END() } *llfsm_pt_resume = 0"
+        "#endif"
+        "#ifndef IS_YIELDED"
+        "#define IS_YIELDED() (state->pt_resume != 0)"
+        "#endif"
         ""
         ""
         "#pragma GCC diagnostic push"
@@ -157,11 +185,13 @@ public func cMachineCode(for llfsm: LLFSM, named name: String, isSuspensible: Bo
 ///   - llfsm: The finite-state machine to create code for.
 ///   - name: The name of the State.
 ///   - isSuspensible: Set to `true` to create an interface that supports suspension.
+///   - isTableDriven: Set to `true` to map the state functions to the table-driven executor.
 /// - Returns: The generated header for the state.
-public func cStateInterface(for state: State, llfsm: LLFSM, named name: String, isSuspensible: Bool) -> Code {
+public func cStateInterface(for state: State, llfsm: LLFSM, named name: String, isSuspensible: Bool, isTableDriven: Bool = false) -> Code {
     let upperName = name.uppercased()
     let lowerName = name.lowercased()
     let lowerState = state.name.lowercased()
+    let stateIndex = llfsm.states.firstIndex(of: state.id) ?? 0
     return """
     //
     // State_\(state.name).h
@@ -171,6 +201,7 @@ public func cStateInterface(for state: State, llfsm: LLFSM, named name: String,
 
     """ + .includeFile(named: "LLFSM_" + name + "_" + state.name + "_h") {
         "#include <stdbool.h>"
+        "#include <stdint.h>"
         "#include \"Machine_\(name)_Includes.h\""
         "#include \"State_\(state.name)_Includes.h\""
         ""
@@ -196,60 +227,85 @@ public func cStateInterface(for state: State, llfsm: LLFSM, named name: String,
                 "void (*on_suspend)(struct LLFSMachine *, struct LLFSMState *);"
                 "void (*on_resume) (struct LLFSMachine *, struct LLFSMState *);"
             }
+            "uintptr_t pt_resume; ///< resumption point of a yielded internal action"
+            if isTableDriven {
+                "uintptr_t state_index; ///< index of the state in the transition table"
+            }
         }
         "#   include \"State_\(state.name)_Variables.h\""
         "};"
         ""
-        "/// Initialise the given state."
-        "///"
-        "/// - Parameter state: The state to initialise."
-        "void fsm_" + lowerName + "_" + lowerState + "_init(struct FSM\(name)_State_\(state.name) * const state);"
-        ""
-        "/// Validate the given state."
-        "///"
-        "/// - Parameter state: The state to initialise."
-        "bool fsm_" + lowerName + "_" + lowerState + "_validate(const struct Machine_" + name + " * const machine, const struct FSM\(name)_State_\(state.name) * const state);"
-        ""
-        "/// Check the sequence of transitions for \(state.name)."
-        "///"
-        "/// - Returns: The state the machine transitions to (`NULL` if no transition fired)."
-        "struct LLFSMState *fsm_" + lowerName + "_" + lowerState + "_check_transitions(const struct Machine_" + name + " * const machine, const struct FSM\(name)_State_\(state.name) * const state);"
-        ""
-        "/// The onEntry function for \(state.name)."
-        "///"
-        "/// - Parameters:"
-        "///   - machine: The machine that entered the state."
-        "///   - state: The state that was entered."
-        "void fsm_" + lowerName + "_" + lowerState + "_on_entry(struct Machine_" + name + " * const machine, struct FSM\(name)_State_\(state.name) * const state);"
-        ""
-        "/// The onExit function for \(state.name)."
-        "///"
-        "/// - Parameters:"
-        "///   - machine: The machine this function belongs to."
-        "///   - state: The state being exited."
-        "void fsm_" + lowerName + "_" + lowerState + "_on_exit(struct Machine_" + name + " * const machine, struct FSM\(name)_State_\(state.name) * const state);"
-        ""
-        "/// The internal action for \(state.name)."
-        "///"
-        "/// - Parameters:"
-        "///   - machine: The machine this function belongs to."
-        "///   - state: The state whose internal action to execute."
-        "void fsm_" + lowerName + "_" + lowerState + "_internal(struct Machine_" + name + " * const machine, struct FSM\(name)_State_\(state.name) * const state);"
-        ""
-        if isSuspensible {
-            "/// The onSuspend function for \(state.name)."
+        if isTableDriven {
+            "// The transitions and actions of all \(name) states are dispatched"
+            "// through the table-driven executor in Machine_\(name)_Table.c."
+            "struct LLFSMState;"
+            "struct Machine_" + name + ";"
+            ""
+            "struct LLFSMState *fsm_" + lowerName + "_table_check_transitions(const struct Machine_" + name + " * const machine, const struct LLFSMState * const state);"
+            Code.forEach(tableActions(isSuspensible: isSuspensible)) { action in
+                "void fsm_" + lowerName + "_table_" + action + "(struct Machine_" + name + " * const machine, struct LLFSMState * const state);"
+            }
+            "void fsm_" + lowerName + "_table_init_state(struct LLFSMState * const state, const uintptr_t index);"
+            "bool fsm_" + lowerName + "_table_validate_state(const struct LLFSMState * const state, const uintptr_t index);"
+            ""
+            "#define fsm_" + lowerName + "_" + lowerState + "_init(s) fsm_" + lowerName + "_table_init_state((struct LLFSMState *)(s), \(stateIndex))"
+            "#define fsm_" + lowerName + "_" + lowerState + "_validate(m, s) ((void)(m), fsm_" + lowerName + "_table_validate_state((const struct LLFSMState *)(s), \(stateIndex)))"
+            "#define fsm_" + lowerName + "_" + lowerState + "_check_transitions fsm_" + lowerName + "_table_check_transitions"
+            Code.forEach(tableActions(isSuspensible: isSuspensible)) { action in
+                "#define fsm_" + lowerName + "_" + lowerState + "_" + action + " fsm_" + lowerName + "_table_" + action
+            }
+        } else {
+            "/// Initialise the given state."
+            "///"
+            "/// - Parameter state: The state to initialise."
+            "void fsm_" + lowerName + "_" + lowerState + "_init(struct FSM\(name)_State_\(state.name) * const state);"
+            ""
+            "/// Validate the given state."
+            "///"
+            "/// - Parameter state: The state to initialise."
+            "bool fsm_" + lowerName + "_" + lowerState + "_validate(const struct Machine_" + name + " * const machine, const struct FSM\(name)_State_\(state.name) * const state);"
+            ""
+            "/// Check the sequence of transitions for \(state.name)."
+            "///"
+            "/// - Returns: The state the machine transitions to (`NULL` if no transition fired)."
+            "struct LLFSMState *fsm_" + lowerName + "_" + lowerState + "_check_transitions(const struct Machine_" + name + " * const machine, const struct FSM\(name)_State_\(state.name) * const state);"
+            ""
+            "/// The onEntry function for \(state.name)."
             "///"
             "/// - Parameters:"
             "///   - machine: The machine that entered the state."
-            "///   - state: The state that was suspended."
-            "void fsm_" + lowerName + "_" + lowerState + "_on_suspend(struct Machine_" + name + " * const machine, struct FSM\(name)_State_\(state.name) * const state);"
+            "///   - state: The state that was entered."
+            "void fsm_" + lowerName + "_" + lowerState + "_on_entry(struct Machine_" + name + " * const machine, struct FSM\(name)_State_\(state.name) * const state);"
             ""
-            "/// The onResume function for \(state.name)."
+            "/// The onExit function for \(state.name)."
             "///"
             "/// - Parameters:"
             "///   - machine: The machine this function belongs to."
-            "///   - state: The state being resumed."
-            "void fsm_" + lowerName + "_" + lowerState + "_on_resume(struct Machine_" + name + " * const machine, struct FSM\(name)_State_\(state.name) * const state);"
+            "///   - state: The state being exited."
+            "void fsm_" + lowerName + "_" + lowerState + "_on_exit(struct Machine_" + name + " * const machine, struct FSM\(name)_State_\(state.name) * const state);"
+            ""
+            "/// The internal action for \(state.name)."
+            "///"
+            "/// - Parameters:"
+            "///   - machine: The machine this function belongs to."
+            "///   - state: The state whose internal action to execute."
+            "void fsm_" + lowerName + "_" + lowerState + "_internal(struct Machine_" + name + " * const machine, struct FSM\(name)_State_\(state.name) * const state);"
+            ""
+            if isSuspensible {
+                "/// The onSuspend function for \(state.name)."
+                "///"
+                "/// - Parameters:"
+                "///   - machine: The machine that entered the state."
+                "///   - state: The state that was suspended."
+                "void fsm_" + lowerName + "_" + lowerState + "_on_suspend(struct Machine_" + name + " * const machine, struct FSM\(name)_State_\(state.name) * const state);"
+                ""
+                "/// The onResume function for \(state.name)."
+                "///"
+                "/// - Parameters:"
+                "///   - machine: The machine this function belongs to."
+                "///   - state: The state being resumed."
+                "void fsm_" + lowerName + "_" + lowerState + "_on_resume(struct Machine_" + name + " * const machine, struct FSM\(name)_State_\(state.name) * const state);"
+            }
         }
         ""
         "#pragma clang diagnostic pop"
@@ -263,9 +319,11 @@ public func cStateInterface(for state: State, llfsm: LLFSM, named name: String,
 ///   - llfsm: The finite-state machine to create code for.
 ///   - state: The name of the state to write the code for.
 ///   - isSuspensible: Set to `true` to create an interface that supports suspension.
+///   - isTraceable: Set to `true` to fire a USDT probe for each transition taken.
+///   - sources: The guard and action sources to inline by file name (`nil` to `#include` them).
 /// - Returns: The generated code for the state.
-public func cStateCode(for state: State, llfsm: LLFSM, named name: String, isSuspensible: Bool) -> Code {
-    .block {
+public func cStateCode(for state: State, llfsm: LLFSM, named name: String, isSuspensible: Bool, isTraceable: Bool = false, inlining sources: [Filename : String]? = nil) -> Code {
+    let code: Code = .block {
         let lowerName = name.lowercased()
         let lowerState = state.name.lowercased()
         "//"
@@ -298,6 +356,7 @@ public func cStateCode(for state: State, llfsm: LLFSM, named name: String, isSus
                 "state->on_suspend = (void (*)(struct LLFSMachine *, struct LLFSMState *))fsm_" + lowerName + "_" + lowerState + "_on_suspend;"
                 "state->on_resume  = (void (*)(struct LLFSMachine *, struct LLFSMState *))fsm_" + lowerName + "_" + lowerState + "_on_resume;"
             }
+            "state->pt_resume  = 0;"
         }
         ""
         "/// Check the validity of the given \(state.name) state."
@@ -327,7 +386,8 @@ public func cStateCode(for state: State, llfsm: LLFSM, named name: String, isSus
         "///   - state: The state that was entered."
         "void fsm_" + lowerName + "_" + lowerState + "_on_entry(struct Machine_" + name + " * const machine, struct FSM\(name)_State_\(state.name) * const state)"
         "{"
-        "#   include \"State_\(state.name)_OnEntry.mm\""
+        "    state->pt_resume = 0;"
+        cSource("State_\(state.name)_OnEntry.mm", inlining: sources)
         "}"
         ""
         "/// The onExit function for \(state.name)."
@@ -337,7 +397,8 @@ public func cStateCode(for state: State, llfsm: LLFSM, named name: String, isSus
         "///   - state: The state being exited."
         "void fsm_" + lowerName + "_" + lowerState + "_on_exit(struct Machine_" + name + " * const machine, struct FSM\(name)_State_\(state.name) * const state)"
         "{"
-        "#   include \"State_\(state.name)_OnExit.mm\""
+        "    state->pt_resume = 0;"
+        cSource("State_\(state.name)_OnExit.mm", inlining: sources)
         "}"
         ""
         "/// The internal action for \(state.name)."
@@ -347,7 +408,9 @@ public func cStateCode(for state: State, llfsm: LLFSM, named name: String, isSus
         "///   - state: The state whose internal action to execute."
         "void fsm_" + lowerName + "_" + lowerState + "_internal(struct Machine_" + name + " * const machine, struct FSM\(name)_State_\(state.name) * const state)"
         "{"
-        "#   include \"State_\(state.name)_Internal.mm\""
+        "    uintptr_t * const llfsm_pt_resume = &state->pt_resume;"
+        "    (void)llfsm_pt_resume;"
+        cSource("State_\(state.name)_Internal.mm", inlining: sources)
         "}"
         ""
         if isSuspensible {
@@ -358,7 +421,7 @@ public func cStateCode(for state: State, llfsm: LLFSM, named name: String, isSus
             "///   - state: The state that was suspended."
             "void fsm_" + lowerName + "_" + lowerState + "_on_suspend(struct Machine_" + name + " * const machine, struct FSM\(name)_State_\(state.name) * const state)"
             "{"
-            "#   include \"State_\(state.name)_OnSuspend.mm\""
+            cSource("State_\(state.name)_OnSuspend.mm", inlining: sources)
             "}"
             ""
             "/// The onResume function for \(state.name)."
@@ -368,7 +431,7 @@ public func cStateCode(for state: State, llfsm: LLFSM, named name: String, isSus
             "///   - state: The state being resumed."
             "void fsm_" + lowerName + "_" + lowerState + "_on_resume(struct Machine_" + name + " * const machine, struct FSM\(name)_State_\(state.name) * const state)"
             "{"
-            "#   include \"State_\(state.name)_OnResume.mm\""
+            cSource("State_\(state.name)_OnResume.mm", inlining: sources)
             "}"
         }
         ""
@@ -384,8 +447,14 @@ public func cStateCode(for state: State, llfsm: LLFSM, named name: String, isSus
                 if let transition = llfsm.transitionMap[transitionID],
                    let targetState = llfsm.stateMap[transition.target] {
                     "if ("
-                    "    #include \"State_\(state.name)_Transition_\(i).expr\""
-                    ") return \(llfsm.states.firstIndex(of: targetState.id).map { "machine->states[\($0)];" } ?? "NULL; // Warning: cannot find \(targetState.name) in machine \(name)")"
+                    cSource("State_\(state.name)_Transition_\(i).expr", directive: "    #include", inlining: sources)
+                    if isTraceable,
+                       let source = llfsm.states.firstIndex(of: state.id),
+                       let target = llfsm.states.firstIndex(of: targetState.id) {
+                        ") { LLFSM_PROBE_TRANSITION(machine, \(source), \(target), \(i)); return machine->states[\(target)]; }"
+                    } else {
+                        ") return \(llfsm.states.firstIndex(of: targetState.id).map { "machine->states[\($0)];" } ?? "NULL; // Warning: cannot find \(targetState.name) in machine \(name)")"
+                    }
                 } else {
                     "// Warning: ignoring incomplete transition \(i) with ID \(transitionID)"
                 }
@@ -393,6 +462,7 @@ public func cStateCode(for state: State, llfsm: LLFSM, named name: String, isSus
             "return NULL; // None of the transitions fired."
         }
     } + "\n"
+    return resolvingLineMarkers(in: code, file: "State_\(state.name).c")
 }
 
 /// Create CMakeList fragment for an FSM.
@@ -401,21 +471,61 @@ public func cStateCode(for state: State, llfsm: LLFSM, named name: String, isSus
 ///   - fsm: The FSM to create the cmake fragment for.
 ///   - name: The name of the Machine
 ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+///   - isIntrospectable: Indicates whether introspection tables should be compiled.
+///   - isTableDriven: Indicates whether the table-driven executor replaces the state code.
 /// - Returns: The CMakeLists.txt code.
-public func cMakeFragment(for fsm: LLFSM, named name: String, isSuspensible: Bool) -> Code {
+public func cMakeFragment(for fsm: LLFSM, named name: String, isSuspensible: Bool, isIntrospectable: Bool = false, isTableDriven: Bool = false) -> Code {
     return .block {
         "# Sources for the \(name) LLFSM."
         "set(\(name)_FSM_SOURCES"
         "    Machine_\(name).c"
-        Code.enumerating(array: fsm.states) { i, stateID in
-            if let state = fsm.stateMap[stateID] {
-                "    State_\(state.name).c"
-            } else {
-                "// Warning: ignoring orphaned state \(i) (\(stateID))"
+        if isIntrospectable {
+            "    Machine_\(name)_Introspection.c"
+        }
+        if isTableDriven {
+            "    Machine_\(name)_Table.c"
+        } else {
+            Code.enumerating(array: fsm.states) { i, stateID in
+                if let state = fsm.stateMap[stateID] {
+                    "    State_\(state.name).c"
+                } else {
+                    "// Warning: ignoring orphaned state \(i) (\(stateID))"
+                }
             }
         }
         ")"
         ""
+        "# Content hash of the \(name) sources for matching prebuilt packages."
+        "file(GLOB \(name)_FSM_HASHED_FILES LIST_DIRECTORIES false RELATIVE ${CMAKE_CURRENT_LIST_DIR}"
+        "  ${CMAKE_CURRENT_LIST_DIR}/*.h"
+        "  ${CMAKE_CURRENT_LIST_DIR}/*.c"
+        "  ${CMAKE_CURRENT_LIST_DIR}/*.mm"
+        "  ${CMAKE_CURRENT_LIST_DIR}/*.expr"
+        ")"
+        "list(SORT \(name)_FSM_HASHED_FILES)"
+        "set(\(name)_FSM_HASH_INPUT \"\")"
+        "foreach(file ${\(name)_FSM_HASHED_FILES})"
+        "  file(SHA256 ${CMAKE_CURRENT_LIST_DIR}/${file} \(name)_FSM_FILE_HASH)"
+        "  string(APPEND \(name)_FSM_HASH_INPUT \"${file}:${\(name)_FSM_FILE_HASH}\\n\")"
+        "endforeach()"
+        "# The machine code also depends on the compile definitions in effect"
+        "# (e.g., LLFSM_NO_USDT).  Only with INCLUDE_MACHINE_COMMON does it see"
+        "# the arrangement headers.  Of these, only Machine_Macros.h is hashed,"
+        "# as it does not depend on the arrangement (arrangements with channels"
+        "# build their machines from source), so a machine hashes the same"
+        "# standalone and in any arrangement."
+        "get_directory_property(\(name)_FSM_DEFINITIONS COMPILE_DEFINITIONS)"
+        "list(SORT \(name)_FSM_DEFINITIONS)"
+        "if(\"INCLUDE_MACHINE_COMMON\" IN_LIST \(name)_FSM_DEFINITIONS AND EXISTS ${CMAKE_CURRENT_LIST_DIR}/../Machine_Macros.h)"
+        "  file(SHA256 ${CMAKE_CURRENT_LIST_DIR}/../Machine_Macros.h \(name)_FSM_FILE_HASH)"
+        "  string(APPEND \(name)_FSM_HASH_INPUT \"../Machine_Macros.h:${\(name)_FSM_FILE_HASH}\\n\")"
+        "endif()"
+        "string(APPEND \(name)_FSM_HASH_INPUT \"definitions:${\(name)_FSM_DEFINITIONS}\\nflags:${CMAKE_C_FLAGS}\\n\")"
+        "if(LLFSM_BATCH)"
+        "  string(APPEND \(name)_FSM_HASH_INPUT \"LLFSM_BATCH\\n\")"
+        "endif()"
+        "string(SHA256 \(name)_FSM_CONTENT_HASH \"${\(name)_FSM_HASH_INPUT}\")"
+        ""
     }
 }
 
@@ -426,8 +536,9 @@ public func cMakeFragment(for fsm: LLFSM, named name: String, isSuspensible: Boo
 ///   - name: The name of the Machine
 ///   - boilerplate: The boilerplate containing the include paths.
 ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+///   - isBatchable: Indicates whether a batch executor was generated.
 /// - Returns: The CMakeLists.txt code.
-public func cMakeLists(for fsm: LLFSM, named name: String, boilerplate: any Boilerplate, isSuspensible: Bool) -> Code {
+public func cMakeLists(for fsm: LLFSM, named name: String, boilerplate: any Boilerplate, isSuspensible: Bool, isBatchable: Bool = false) -> Code {
     .block {
         let includePaths = boilerplate.getSection(named: CBoilerplate.SectionName.includePath.rawValue).split(separator: "\n")
         "cmake_minimum_required(VERSION 3.21)"
@@ -460,6 +571,70 @@ public func cMakeLists(for fsm: LLFSM, named name: String, boilerplate: any Boil
         }
         ")"
         ""
+        "# Dynamically reloadable module for \(name)."
+        "option(LLFSM_DYNAMIC \"Build dynamically reloadable machine modules\" OFF)"
+        "if(LLFSM_DYNAMIC)"
+        "  add_library(\(name)_module MODULE ${\(name)_FSM_SOURCES} Machine_\(name)_Module.c)"
+        "  set_target_properties(\(name)_module PROPERTIES"
+        "    C_VISIBILITY_PRESET hidden"
+        "    POSITION_INDEPENDENT_CODE ON"
+        "    PREFIX \"\""
+        "    OUTPUT_NAME \"\(name)\""
+        "  )"
+        "  target_include_directories(\(name)_module PRIVATE"
+        "    $<TARGET_PROPERTY:\(name)_fsm,INCLUDE_DIRECTORIES>"
+        "  )"
+        "endif()"
+        ""
+        "# Installable \(name) package, so arrangements can link a prebuilt library."
+        "include(GNUInstallDirs)"
+        "configure_file(\(name)Config.cmake.in \(name)Config.cmake @ONLY)"
+        "install(TARGETS \(name)_fsm EXPORT \(name)Targets"
+        "  ARCHIVE DESTINATION ${CMAKE_INSTALL_LIBDIR}"
+        ")"
+        "install(EXPORT \(name)Targets"
+        "  NAMESPACE \(name)::"
+        "  DESTINATION ${CMAKE_INSTALL_LIBDIR}/cmake/\(name)"
+        ")"
+        "install(FILES ${CMAKE_CURRENT_BINARY_DIR}/\(name)Config.cmake"
+        "  DESTINATION ${CMAKE_INSTALL_LIBDIR}/cmake/\(name)"
+        ")"
+        "install(DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}/"
+        "  DESTINATION ${CMAKE_INSTALL_INCLUDEDIR}/fsms/\(name).machine"
+        "  FILES_MATCHING PATTERN \"*.h\" PATTERN \"*.mm\" PATTERN \"*.expr\""
+        ")"
+        ""
+        if isBatchable {
+            "# Struct-of-arrays batch executor for many \(name) instances."
+            "option(LLFSM_BATCH \"Build the batch executor\" OFF)"
+            "if(LLFSM_BATCH)"
+            "  add_library(\(name)_batch STATIC Machine_\(name)_Batch.c)"
+            "  target_compile_options(\(name)_batch PRIVATE $<$<C_COMPILER_ID:GNU,Clang,AppleClang>:-O3>)"
+            "endif()"
+            ""
+        }
+    }
+}
+
+/// Create the CMake package configuration template for an FSM.
+///
+/// The configured `<name>Config.cmake` imports the installed
+/// `<name>::<name>_fsm` library and records the content hash
+/// of the sources it was built from, so arrangements only
+/// link it if their copy of the machine is identical.
+///
+/// - Parameter name: The name of the Machine.
+/// - Returns: The `<name>Config.cmake.in` code.
+public func cMakePackageConfig(named name: String) -> Code {
+    .block {
+        "# \(name)Config.cmake"
+        "#"
+        "# Automatically created using fsmconvert -- do not change manually!"
+        "#"
+        "include(\"${CMAKE_CURRENT_LIST_DIR}/\(name)Targets.cmake\")"
+        ""
+        "# Content hash of the sources the \(name) library was built from."
+        "set(\(name)_FSM_PACKAGE_HASH \"@\(name)_FSM_CONTENT_HASH@\")"
     }
 }
 
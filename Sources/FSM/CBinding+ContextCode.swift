@@ -0,0 +1,350 @@
+//
+//  CBinding+ContextCode.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+/// Return the interface of a re-entrant C-language LLFSM arrangement.
+///
+/// Unlike the static arrangement, which instantiates all
+/// machines and states as global singletons, the context
+/// holds all machine and state storage in a single struct,
+/// so that independent copies can run within one process.
+///
+/// - Note: Channels and the activity epoch are thread-local,
+///         i.e., they are shared by all contexts that run
+///         on the same thread, and get reset by
+///         `arrangement_<name>_context_init()`.
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+/// - Returns: The re-entrant LLFSM arrangement interface code.
+public func cArrangementContextInterface(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+    let upperName = name.uppercased()
+    let lowerName = name.lowercased()
+    let machines = Dictionary(instances.map { ($0.typeName, $0) }, uniquingKeysWith: { a,_ in a })
+        .sorted { $0.key < $1.key }
+    return """
+    //
+    // Arrangement_\(name)_Context.h
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+
+    """ + .includeFile(named: "LLFSM_ARRANGEMENT_" + upperName + "_CONTEXT_H") {
+        "#include \"Arrangement_" + name + ".h\""
+        Code.forEach(machines) { (machine, instance) in
+            "#include \"" + machine + ".machine/Machine_" + machine + ".h\""
+            Code.forEach(instance.fsm.states.compactMap {
+                instance.fsm.stateMap[$0]
+            }) { state in
+                "#include \"" + machine + ".machine/State_" + state.name + ".h\""
+            }
+        }
+        ""
+        "/// A re-entrant \(name) LLFSM Arrangement."
+        "///"
+        "/// All machine and state storage lives in this struct,"
+        "/// so independent copies of the arrangement can run"
+        "/// concurrently within the same process."
+        "struct Arrangement_\(name)_Context"
+        Code.bracedBlock {
+            "/// The arrangement of the machines below."
+            "struct Arrangement_\(name) arrangement;"
+            Code.forEach(instances) { instance in
+                let lowerInstance = instance.name.lowercased()
+                "/// The \(instance.name) instance of the \(instance.typeName) LLFSM."
+                "struct Machine_\(instance.typeName) fsm_\(lowerInstance);"
+                Code.forEach(instance.fsm.states.compactMap { instance.fsm.stateMap[$0] }) { state in
+                    "struct FSM\(instance.typeName)_State_\(state.name) \(lowerInstance)_state_\(state.name);"
+                }
+            }
+        } + ";"
+        ""
+        "/// Initialise a re-entrant \(name) LLFSM arrangement."
+        "///"
+        "/// This also empties the channels of the calling thread."
+        "///"
+        "/// - Parameter context: The zero-initialised context to set up."
+        "void arrangement_" + lowerName + "_context_init(struct Arrangement_" + name + "_Context * const context);"
+        ""
+    }
+}
+
+/// Return the implementation of a re-entrant C-language LLFSM arrangement.
+///
+/// Initialising a context empties the channels and resets
+/// the activity epoch of the calling thread, so that each
+/// context starts from the same configuration.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+///   - channels: The message channels between the instances.
+/// - Returns: The re-entrant LLFSM arrangement implementation code.
+public func cArrangementContextCode(for instances: [Instance], named name: String, isSuspensible: Bool, channels: [Channel] = []) -> Code {
+    let lowerName = name.lowercased()
+    return """
+    //
+    // Arrangement_\(name)_Context.c
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+    #include \"Machine_Common.h\"
+    #include \"Arrangement_\(name)_Context.h\"
+
+    """ + .block {
+        ""
+        "/// Initialise a re-entrant \(name) LLFSM arrangement."
+        "///"
+        "/// This also empties the channels of the calling thread."
+        "///"
+        "/// - Parameter context: The zero-initialised context to set up."
+        "void arrangement_" + lowerName + "_context_init(struct Arrangement_" + name + "_Context * const context)"
+        Code.bracedBlock {
+            "struct LLFSMState **states;"
+            Code.forEach(channels) { channel in
+                "atomic_store_explicit(&llfsm_channel_\(channel.name).head, 0, memory_order_relaxed);"
+                "atomic_store_explicit(&llfsm_channel_\(channel.name).tail, 0, memory_order_relaxed);"
+            }
+            if isSuspensible {
+                "llfsm_activity_epoch = 0;"
+            }
+            Code.forEach(instances) { instance in
+                let lowerInstance = instance.name.lowercased()
+                let lowerMachine = instance.typeName.lowercased()
+                let states = instance.fsm.states.compactMap { instance.fsm.stateMap[$0] }
+                let initialIndex = instance.fsm.states.firstIndex(of: instance.fsm.initialState) ?? 0
+                "states = (struct LLFSMState **)(void *)context->fsm_\(lowerInstance).states;"
+                Code.enumerating(array: states) { i, state in
+                    "states[\(i)] = (struct LLFSMState *)&context->\(lowerInstance)_state_\(state.name);"
+                    "fsm_\(lowerMachine)_\(state.name.lowercased())_init(&context->\(lowerInstance)_state_\(state.name));"
+                }
+                "fsm_\(lowerMachine)_init(&context->fsm_\(lowerInstance));"
+                "context->fsm_\(lowerInstance).current_state = states[\(initialIndex)];"
+                "context->arrangement.fsm_\(lowerInstance) = &context->fsm_\(lowerInstance);"
+            }
+            "context->arrangement.number_of_instances = \(instances.count);"
+            if isSuspensible {
+                "context->arrangement.activity_epoch = LLFSM_ACTIVITY_EPOCH_INVALID;"
+            }
+        }
+    } + "\n"
+}
+
+/// Return a Monte-Carlo simulation driver for a C-language LLFSM arrangement.
+///
+/// The driver runs independent replicas of the arrangement,
+/// each in its own re-entrant context, across worker threads.
+/// Before every ringlet, the snapshot variables that have a
+/// finite input domain are set to uniformly distributed values
+/// drawn from a per-replica SplitMix64 generator seeded from the
+/// base seed and the replica number, so results are reproducible
+/// regardless of the number of threads.  Each worker accumulates
+/// how many ringlets every state was current for and how many
+/// replicas visited it; the totals are aggregated after all
+/// workers have finished.
+///
+/// - Note: Actions must not depend on global state.
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+///   - inputs: The snapshot variables to randomise.
+/// - Returns: The LLFSM arrangement simulation driver code.
+public func cArrangementSimulateCode(for instances: [Instance], named name: String, isSuspensible: Bool, inputs: [SnapshotVariable] = []) -> Code {
+    let lowerName = name.lowercased()
+    let domains = inputs.compactMap { input in
+        input.domain.map { (instance: input.instance.lowercased(), variable: input.name, domain: $0) }
+    }
+    let offsets = instances.reduce(into: [0]) { $0.append($0.last! + $1.fsm.states.count) }
+    let stateNames = instances.flatMap { instance in
+        instance.fsm.states.map { instance.name + "." + (instance.fsm.stateMap[$0]?.name ?? "Orphaned") }
+    }
+    return """
+    //
+    // simulate_main.c for Monte-Carlo simulation of the LLFSM arrangement named \(name).
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+    #ifndef _POSIX_C_SOURCE
+    #define _POSIX_C_SOURCE 200809L
+    #endif
+    #include <pthread.h>
+    #include <stdatomic.h>
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <string.h>
+    #include <unistd.h>
+
+    #include \"Machine_Common.h\"
+    #include \"Arrangement_\(name)_Context.h\"
+
+    #pragma clang diagnostic push
+    #pragma clang diagnostic ignored \"-Wunused-macros\"
+    #pragma clang diagnostic ignored \"-Wpadded\"
+
+    """ + .block {
+        "#ifndef SIMULATE_MAX_THREADS"
+        "#define SIMULATE_MAX_THREADS 64"
+        "#endif"
+        "#ifndef SIMULATE_EXTRA_INPUTS"
+        "#define SIMULATE_EXTRA_INPUTS(context, rng) ((void)(context), (void)(rng))"
+        "#endif"
+        "#define SIMULATE_NUMBER_OF_STATES \(max(stateNames.count, 1))"
+        ""
+        "/// The names of all states, as `instance.state`."
+        "static const char * const simulate_state_names[SIMULATE_NUMBER_OF_STATES] ="
+        Code.bracedBlock {
+            if stateNames.isEmpty {
+                "\"\""
+            } else {
+                Code.enumerating(array: stateNames) { i, stateName in
+                    stateName.cStringLiteral + (i < stateNames.count - 1 ? "," : "")
+                }
+            }
+        } + ";"
+        ""
+        "/// A worker thread running replicas of the arrangement."
+        "struct simulate_worker"
+        Code.bracedBlock {
+            "/// The thread running the replicas."
+            "pthread_t thread;"
+            "/// The number of ringlets each state was current for."
+            "uint64_t visits[SIMULATE_NUMBER_OF_STATES];"
+            "/// The number of replicas that visited each state."
+            "uint64_t replicas[SIMULATE_NUMBER_OF_STATES];"
+            "/// Whether the current replica has visited each state."
+            "bool visited[SIMULATE_NUMBER_OF_STATES];"
+            "/// The private context of the current replica."
+            "struct Arrangement_\(name)_Context context;"
+        } + ";"
+        ""
+        "/// Index of the next replica to run."
+        "static _Atomic(uint64_t) next_replica;"
+        "/// The number of replicas to run."
+        "static uint64_t number_of_replicas;"
+        "/// The number of ringlets per replica."
+        "static uint64_t ringlets_per_replica;"
+        "/// The base seed of the random number generators."
+        "static uint64_t base_seed;"
+        ""
+        "/// Return the next SplitMix64 pseudo-random number."
+        "///"
+        "/// - Parameter rng: The state of the random number generator."
+        "/// - Returns: A uniformly distributed 64-bit number."
+        "static uint64_t simulate_random(uint64_t * const rng)"
+        Code.bracedBlock {
+            "uint64_t z = (*rng += UINT64_C(0x9e3779b97f4a7c15));"
+            "z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);"
+            "z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);"
+            "return z ^ (z >> 31);"
+        }
+        ""
+        "/// Set the randomised inputs of the given context."
+        "///"
+        "/// - Parameters:"
+        "///   - context: The context to set the snapshot variables of."
+        "///   - rng: The random number generator of the replica."
+        "static void simulate_set_inputs(struct Arrangement_\(name)_Context * const context, uint64_t * const rng)"
+        Code.bracedBlock {
+            Code.forEach(domains) { input in
+                "context->fsm_\(input.instance).\(input.variable) = \(input.domain.lowerBound) + (long long)(simulate_random(rng) % UINT64_C(\(input.domain.count)));"
+            }
+            "SIMULATE_EXTRA_INPUTS(context, rng);"
+        }
+        ""
+        "/// Record the current state of every machine."
+        "///"
+        "/// - Parameter worker: The worker whose statistics to update."
+        "static void simulate_record(struct simulate_worker * const worker)"
+        Code.bracedBlock {
+            "const struct Arrangement_\(name)_Context * const context = &worker->context;"
+            "uintptr_t s;"
+            Code.enumerating(array: instances) { i, instance in
+                let fsm = "context->fsm_" + instance.name.lowercased()
+                "for (s = 0; s < \(instance.fsm.states.count); s++) if (\(fsm).current_state == \(fsm).states[s])"
+                Code.bracedBlock {
+                    "worker->visits[\(offsets[i]) + s]++;"
+                    "worker->visited[\(offsets[i]) + s] = true;"
+                    "break;"
+                }
+            }
+        }
+        ""
+        "/// Run replicas until all have been simulated."
+        "///"
+        "/// - Parameter arg: The worker to run."
+        "/// - Returns: `NULL`."
+        "static void *simulate_worker_run(void *arg)"
+        Code.bracedBlock {
+            "struct simulate_worker * const worker = arg;"
+            "struct LLFSMArrangement * const arrangement = (struct LLFSMArrangement *)&worker->context.arrangement;"
+            "for (;;)"
+            Code.bracedBlock {
+                "const uint64_t replica = atomic_fetch_add_explicit(&next_replica, 1, memory_order_relaxed);"
+                "uint64_t rng = base_seed ^ (replica * UINT64_C(0xd1342543de82ef95));"
+                "uint64_t ringlet;"
+                "size_t s;"
+                "if (replica >= number_of_replicas) break;"
+                "memset(&worker->context, 0, sizeof(worker->context));"
+                "memset(worker->visited, 0, sizeof(worker->visited));"
+                "arrangement_" + lowerName + "_context_init(&worker->context);"
+                "simulate_record(worker);"
+                "for (ringlet = 0; ringlet < ringlets_per_replica; ringlet++)"
+                Code.bracedBlock {
+                    "simulate_set_inputs(&worker->context, &rng);"
+                    "fsm_arrangement_execute_once(arrangement);"
+                    "simulate_record(worker);"
+                }
+                "for (s = 0; s < SIMULATE_NUMBER_OF_STATES; s++) worker->replicas[s] += worker->visited[s];"
+            }
+            "return NULL;"
+        }
+        ""
+        "int main(int argc, char *argv[])"
+        Code.bracedBlock {
+            "long threads = argc > 4 ? strtol(argv[4], NULL, 10) : sysconf(_SC_NPROCESSORS_ONLN);"
+            "struct simulate_worker *workers;"
+            "uint64_t visits[SIMULATE_NUMBER_OF_STATES] = {0};"
+            "uint64_t replicas[SIMULATE_NUMBER_OF_STATES] = {0};"
+            "uint64_t total;"
+            "size_t s;"
+            "long t;"
+            ""
+            "number_of_replicas = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000;"
+            "ringlets_per_replica = argc > 2 ? strtoull(argv[2], NULL, 10) : 1000;"
+            "base_seed = argc > 3 ? strtoull(argv[3], NULL, 10) : 1;"
+            "total = number_of_replicas * (ringlets_per_replica + 1);"
+            "if (threads < 1) threads = 1;"
+            "if (threads > SIMULATE_MAX_THREADS) threads = SIMULATE_MAX_THREADS;"
+            "workers = calloc((size_t)threads, sizeof(*workers));"
+            "if (!workers)"
+            Code.bracedBlock {
+                "perror(\"simulate_\(lowerName)\");"
+                "return EXIT_FAILURE;"
+            }
+            "for (t = 1; t < threads; t++) if (pthread_create(&workers[t].thread, NULL, simulate_worker_run, &workers[t])) break;"
+            "simulate_worker_run(&workers[0]);"
+            "while (--t > 0) pthread_join(workers[t].thread, NULL);"
+            "for (t = 0; t < threads; t++) for (s = 0; s < SIMULATE_NUMBER_OF_STATES; s++)"
+            Code.bracedBlock {
+                "visits[s] += workers[t].visits[s];"
+                "replicas[s] += workers[t].replicas[s];"
+            }
+            "printf(\"\(name): %ju replicas of %ju ringlets, seed %ju\\n\", (uintmax_t)number_of_replicas, (uintmax_t)ringlets_per_replica, (uintmax_t)base_seed);"
+            "for (s = 0; s < \(stateNames.count); s++)"
+            "    printf(\"%-40s %8.6f of ringlets, %8.6f of replicas\\n\", simulate_state_names[s],"
+            "           total ? (double)visits[s] / (double)total : 0.0,"
+            "           number_of_replicas ? (double)replicas[s] / (double)number_of_replicas : 0.0);"
+            ""
+            "free(workers);"
+            ""
+            "return EXIT_SUCCESS;"
+        }
+        ""
+        "#pragma clang diagnostic pop"
+    } + "\n"
+}
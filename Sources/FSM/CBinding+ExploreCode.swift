@@ -0,0 +1,272 @@
+//
+//  CBinding+ExploreCode.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+/// Return a reachable-configuration explorer for a C-language LLFSM arrangement.
+///
+/// The explorer performs a multi-threaded breadth-first search
+/// over the configurations of the arrangement, where a configuration
+/// is the checkpoint of all machines, their variables, and the
+/// contents of all channels.
+/// Every configuration gets expanded by one ringlet for each valuation
+/// of the snapshot variables that have a finite input domain.
+/// Visited configurations are kept as 64-bit hashes in a lock-free,
+/// open-addressing set shared by all worker threads.
+///
+/// - Note: Each worker thread runs its own re-entrant context
+///         of the arrangement, with thread-local channels and
+///         activity epoch, so actions must not depend on other
+///         global state.  State entry times are abstracted away.
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+///   - inputs: The snapshot variables to explore.
+/// - Returns: The LLFSM arrangement explorer code.
+public func cArrangementExploreCode(for instances: [Instance], named name: String, isSuspensible: Bool, inputs: [SnapshotVariable] = []) -> Code {
+    let domains = inputs.compactMap { input in
+        input.domain.map { (instance: input.instance.lowercased(), variable: input.name, domain: $0) }
+    }
+    let numberOfValuations = domains.reduce(1) { product, input in
+        let (result, overflow) = product.multipliedReportingOverflow(by: input.domain.count)
+        return overflow ? Int.max : result
+    }
+    return """
+    //
+    // explore_main.c for exploring the reachable configurations of the LLFSM arrangement named \(name).
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+    #ifndef _POSIX_C_SOURCE
+    #define _POSIX_C_SOURCE 200809L
+    #endif
+    #include <pthread.h>
+    #include <stdatomic.h>
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <string.h>
+    #include <time.h>
+    #include <unistd.h>
+
+    #include \"Machine_Common.h\"
+    #include \"Arrangement_\(name)_Context.h\"
+
+    #pragma clang diagnostic push
+    #pragma clang diagnostic ignored \"-Wunused-macros\"
+    #pragma clang diagnostic ignored \"-Wpadded\"
+
+    """ + .block {
+        "#ifndef EXPLORE_VISITED_CAPACITY"
+        "#define EXPLORE_VISITED_CAPACITY ((size_t)1 << 22) // needs to be a power of two"
+        "#endif"
+        "#ifndef EXPLORE_FRONTIER_CAPACITY"
+        "#define EXPLORE_FRONTIER_CAPACITY ((size_t)1 << 16)"
+        "#endif"
+        "#ifndef EXPLORE_MAX_THREADS"
+        "#define EXPLORE_MAX_THREADS 64"
+        "#endif"
+        "#ifndef EXPLORE_COST_BUDGET_NS"
+        "#define EXPLORE_COST_BUDGET_NS 1000000"
+        "#endif"
+        "#define EXPLORE_NUMBER_OF_VALUATIONS UINT64_C(\(numberOfValuations))"
+        ""
+        "/// Hashes of the visited configurations (`0` denotes an empty slot)."
+        "static _Atomic(uint64_t) *visited;"
+        "/// The configurations to expand at the current depth."
+        "static unsigned char *frontier;"
+        "/// The configurations discovered at the next depth."
+        "static unsigned char *next_frontier;"
+        "/// The number of configurations in `frontier`."
+        "static size_t frontier_count;"
+        "/// The number of configurations added to `next_frontier`."
+        "static _Atomic(size_t) next_count;"
+        "/// Index of the next frontier configuration to expand."
+        "static _Atomic(size_t) cursor;"
+        "/// The number of ringlets executed."
+        "static _Atomic(uint64_t) ringlets;"
+        "/// The number of ringlets that exceeded the cost budget."
+        "static _Atomic(uint64_t) over_budget;"
+        "/// The highest ringlet cost in nanoseconds."
+        "static _Atomic(uint64_t) max_cost;"
+        "/// Set if the visited set or the frontier ran out of space."
+        "static _Atomic(bool) overflow;"
+        "/// The size of a configuration in bytes."
+        "static size_t configuration_size;"
+        "/// The ringlet cost budget in nanoseconds."
+        "static uint64_t cost_budget;"
+        ""
+        "/// Set the explored inputs of the given world."
+        "///"
+        "/// - Parameters:"
+        "///   - world: The world to set the snapshot variables of."
+        "///   - valuation: The index of the input valuation."
+        "static void explore_set_inputs(struct Arrangement_\(name)_Context * const world, uint64_t valuation)"
+        Code.bracedBlock {
+            if domains.isEmpty {
+                "(void)world;"
+                "(void)valuation;"
+            } else {
+                Code.forEach(domains) { input in
+                    "world->fsm_\(input.instance).\(input.variable) = \(input.domain.lowerBound) + (long long)(valuation % \(input.domain.count));"
+                    "valuation /= \(input.domain.count);"
+                }
+            }
+        }
+        ""
+        "/// Checkpoint the given world as a configuration."
+        "///"
+        "/// - Parameters:"
+        "///   - world: The world to checkpoint."
+        "///   - configuration: The buffer to write the configuration to."
+        "static void explore_checkpoint(struct Arrangement_\(name)_Context * const world, unsigned char * const configuration)"
+        Code.bracedBlock {
+            Code.forEach(instances) { instance in
+                "world->fsm_\(instance.name.lowercased()).state_time = 0;"
+            }
+            "fsm_arrangement_checkpoint((const struct LLFSMArrangement *)&world->arrangement, configuration, configuration_size);"
+        }
+        ""
+        "/// Return the hash of a configuration."
+        "///"
+        "/// - Parameter configuration: The configuration to hash."
+        "/// - Returns: The non-zero FNV-1a hash of the configuration."
+        "static uint64_t explore_hash(const unsigned char * const configuration)"
+        Code.bracedBlock {
+            "uint64_t hash = UINT64_C(0xcbf29ce484222325);"
+            "size_t i;"
+            "for (i = 0; i < configuration_size; i++)"
+            Code.bracedBlock {
+                "hash ^= configuration[i];"
+                "hash *= UINT64_C(0x100000001b3);"
+            }
+            "return hash ? hash : 1;"
+        }
+        ""
+        "/// Add a configuration hash to the visited set."
+        "///"
+        "/// - Parameter hash: The non-zero hash to add."
+        "/// - Returns: `true` iff the configuration had not been visited before."
+        "static bool explore_visit(const uint64_t hash)"
+        Code.bracedBlock {
+            "size_t i = (size_t)hash & (EXPLORE_VISITED_CAPACITY - 1);"
+            "size_t n;"
+            "for (n = 0; n < EXPLORE_VISITED_CAPACITY; n++, i = (i + 1) & (EXPLORE_VISITED_CAPACITY - 1))"
+            Code.bracedBlock {
+                "uint64_t slot = atomic_load_explicit(&visited[i], memory_order_relaxed);"
+                "if (!slot && atomic_compare_exchange_strong_explicit(&visited[i], &slot, hash, memory_order_relaxed, memory_order_relaxed)) return true;"
+                "if (slot == hash) return false;"
+            }
+            "atomic_store(&overflow, true);"
+            "return false;"
+        }
+        ""
+        "/// Expand frontier configurations until the frontier is exhausted."
+        "///"
+        "/// - Parameter arg: The world of the worker thread."
+        "/// - Returns: `NULL`."
+        "static void *explore_worker(void *arg)"
+        Code.bracedBlock {
+            "struct Arrangement_\(name)_Context * const world = arg;"
+            "struct LLFSMArrangement * const arrangement = (struct LLFSMArrangement *)&world->arrangement;"
+            "unsigned char * const configuration = malloc(configuration_size);"
+            "if (!configuration)"
+            Code.bracedBlock {
+                "atomic_store(&overflow, true);"
+                "return NULL;"
+            }
+            "for (;;)"
+            Code.bracedBlock {
+                "const size_t i = atomic_fetch_add_explicit(&cursor, 1, memory_order_relaxed);"
+                "uint64_t valuation;"
+                "if (i >= frontier_count) break;"
+                "for (valuation = 0; valuation < EXPLORE_NUMBER_OF_VALUATIONS; valuation++)"
+                Code.bracedBlock {
+                    "struct timespec start, end;"
+                    "fsm_arrangement_restore(arrangement, frontier + i * configuration_size, configuration_size);"
+                    "explore_set_inputs(world, valuation);"
+                    "clock_gettime(CLOCK_MONOTONIC, &start);"
+                    "fsm_arrangement_execute_once(arrangement);"
+                    "clock_gettime(CLOCK_MONOTONIC, &end);"
+                    "const uint64_t cost = (uint64_t)((end.tv_sec - start.tv_sec) * 1000000000LL + (end.tv_nsec - start.tv_nsec));"
+                    "uint64_t highest = atomic_load_explicit(&max_cost, memory_order_relaxed);"
+                    "while (cost > highest && !atomic_compare_exchange_weak_explicit(&max_cost, &highest, cost, memory_order_relaxed, memory_order_relaxed)) {}"
+                    "if (cost > cost_budget) atomic_fetch_add_explicit(&over_budget, 1, memory_order_relaxed);"
+                    "atomic_fetch_add_explicit(&ringlets, 1, memory_order_relaxed);"
+                    "explore_checkpoint(world, configuration);"
+                    "if (!explore_visit(explore_hash(configuration))) continue;"
+                    "const size_t j = atomic_fetch_add_explicit(&next_count, 1, memory_order_relaxed);"
+                    "if (j < EXPLORE_FRONTIER_CAPACITY) memcpy(next_frontier + j * configuration_size, configuration, configuration_size);"
+                    "else atomic_store(&overflow, true);"
+                }
+            }
+            "free(configuration);"
+            "return NULL;"
+        }
+        ""
+        "int main(int argc, char *argv[])"
+        Code.bracedBlock {
+            "const uintmax_t max_depth = argc > 2 ? strtoumax(argv[2], NULL, 10) : UINTMAX_MAX;"
+            "long threads = argc > 3 ? strtol(argv[3], NULL, 10) : sysconf(_SC_NPROCESSORS_ONLN);"
+            "pthread_t workers[EXPLORE_MAX_THREADS];"
+            "struct Arrangement_\(name)_Context *worlds;"
+            "uintmax_t configurations = 1;"
+            "uintmax_t depth = 0;"
+            "long t;"
+            ""
+            "if (threads < 1) threads = 1;"
+            "if (threads > EXPLORE_MAX_THREADS) threads = EXPLORE_MAX_THREADS;"
+            "cost_budget = argc > 1 ? strtoull(argv[1], NULL, 10) : EXPLORE_COST_BUDGET_NS;"
+            "configuration_size = fsm_arrangement_checkpoint_size();"
+            "visited = calloc(EXPLORE_VISITED_CAPACITY, sizeof(*visited));"
+            "frontier = malloc(EXPLORE_FRONTIER_CAPACITY * configuration_size);"
+            "next_frontier = malloc(EXPLORE_FRONTIER_CAPACITY * configuration_size);"
+            "worlds = calloc((size_t)threads, sizeof(*worlds));"
+            "if (!visited || !frontier || !next_frontier || !worlds)"
+            Code.bracedBlock {
+                "perror(\"explore_\(name.lowercased())\");"
+                "return EXIT_FAILURE;"
+            }
+            "for (t = 0; t < threads; t++) arrangement_\(name.lowercased())_context_init(&worlds[t]);"
+            "explore_checkpoint(&worlds[0], frontier);"
+            "explore_visit(explore_hash(frontier));"
+            "frontier_count = 1;"
+            ""
+            "while (frontier_count && depth < max_depth)"
+            Code.bracedBlock {
+                "unsigned char * const expanded = frontier;"
+                "size_t discovered;"
+                "atomic_store(&cursor, 0);"
+                "atomic_store(&next_count, 0);"
+                "for (t = 1; t < threads; t++) if (pthread_create(&workers[t], NULL, explore_worker, &worlds[t])) break;"
+                "explore_worker(&worlds[0]);"
+                "while (--t > 0) pthread_join(workers[t], NULL);"
+                "discovered = atomic_load(&next_count);"
+                "if (discovered > EXPLORE_FRONTIER_CAPACITY) discovered = EXPLORE_FRONTIER_CAPACITY;"
+                "frontier = next_frontier;"
+                "next_frontier = expanded;"
+                "frontier_count = discovered;"
+                "if (!discovered) break;"
+                "configurations += discovered;"
+                "depth++;"
+                "printf(\"depth %ju: %zu new configurations\\n\", depth, discovered);"
+            }
+            "printf(\"\(name): %ju reachable configurations, %ju ringlets, maximum BFS depth %ju\\n\","
+            "       configurations, (uintmax_t)atomic_load(&ringlets), depth);"
+            "printf(\"highest ringlet cost %ju ns, %ju ringlets over the budget of %ju ns\\n\","
+            "       (uintmax_t)atomic_load(&max_cost), (uintmax_t)atomic_load(&over_budget), (uintmax_t)cost_budget);"
+            "if (frontier_count) printf(\"exploration stopped at depth %ju with %zu unexpanded configurations\\n\", depth, frontier_count);"
+            "if (atomic_load(&overflow)) printf(\"warning: exploration capacity exceeded, results are incomplete\\n\");"
+            ""
+            "free(worlds);"
+            "free(next_frontier);"
+            "free(frontier);"
+            "free((void *)visited);"
+            ""
+            "return atomic_load(&over_budget) ? EXIT_FAILURE : EXIT_SUCCESS;"
+        }
+        ""
+        "#pragma clang diagnostic pop"
+    } + "\n"
+}
@@ -0,0 +1,323 @@
+//
+//  CBinding+ExportCode.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+/// Return the shared-memory export interface for a C-language LLFSM arrangement.
+///
+/// The export is only active if `LLFSM_SHM_EXPORT` is defined.
+/// Each machine slot is protected by a sequence lock,
+/// so external monitors can read consistent snapshots
+/// without ever blocking the executor.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+/// - Returns: The LLFSM arrangement export interface code.
+public func cArrangementExportInterface(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+    let upperName = name.uppercased()
+    let lowerName = name.lowercased()
+    return """
+    //
+    // Arrangement_\(name)_Export.h
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+
+    """ + .includeFile(named: "LLFSM_ARRANGEMENT_" + upperName + "_EXPORT_H") {
+        "#include <inttypes.h>"
+        "#include <stdbool.h>"
+        "#include <stdatomic.h>"
+        ""
+        "#pragma clang diagnostic push"
+        "#pragma clang diagnostic ignored \"-Wunused-macros\""
+        "#pragma clang diagnostic ignored \"-Wpadded\""
+        ""
+        "#ifndef LLFSM_CACHE_LINE_SIZE"
+        "#define LLFSM_CACHE_LINE_SIZE 64"
+        "#endif"
+        "#ifndef ARRANGEMENT_\(upperName)_SHM_NAME"
+        "#define ARRANGEMENT_\(upperName)_SHM_NAME \"/llfsm_\(lowerName)\""
+        "#endif"
+        "#define ARRANGEMENT_\(upperName)_SHM_MAGIC UINT64_C(0x4c4c46534d455850)"
+        "#define ARRANGEMENT_\(upperName)_SHM_INSTANCES \(instances.count)"
+        ""
+        "struct Arrangement_" + name + ";"
+        ""
+        "/// Exported state of a single machine."
+        "///"
+        "/// The `sequence` is odd while the machine slot is being written."
+        "struct Arrangement_\(name)_Exported_Machine"
+        Code.bracedBlock {
+            "/// Sequence lock counter."
+            "_Alignas(LLFSM_CACHE_LINE_SIZE) _Atomic(uintptr_t) sequence;"
+            "/// Index of the current state."
+            "_Atomic(uintptr_t) state;"
+            "/// Number of ringlets spent in the current state."
+            "_Atomic(uintptr_t) state_time;"
+            "/// Number of ringlets executed by the arrangement."
+            "_Atomic(uintptr_t) ringlets;"
+        } + ";"
+        ""
+        "/// Shared-memory segment of the \(name) LLFSM arrangement."
+        "struct Arrangement_\(name)_Export"
+        Code.bracedBlock {
+            "/// Set to `ARRANGEMENT_\(upperName)_SHM_MAGIC` once the segment is ready."
+            "_Atomic(uint64_t) magic;"
+            "/// The number of exported instances."
+            "uintptr_t number_of_instances;"
+            "/// The exported machines."
+            "struct Arrangement_\(name)_Exported_Machine machines[ARRANGEMENT_\(upperName)_SHM_INSTANCES];"
+        } + ";"
+        ""
+        "/// Create and map the shared-memory segment of the \(name) arrangement."
+        "///"
+        "/// - Returns: `true` if the segment is ready for exporting."
+        "bool arrangement_" + lowerName + "_export_open(void);"
+        ""
+        "/// Unmap and remove the shared-memory segment of the \(name) arrangement."
+        "void arrangement_" + lowerName + "_export_close(void);"
+        ""
+        "/// Publish the current state of the \(name) arrangement."
+        "///"
+        "/// This is a no-op unless the segment has been opened."
+        "///"
+        "/// - Parameter arrangement: The machine arrangement to export."
+        "void arrangement_" + lowerName + "_export(const struct Arrangement_" + name + " * const arrangement);"
+        ""
+        "#pragma clang diagnostic pop"
+    }
+}
+
+/// Return the shared-memory export code for a C-language LLFSM arrangement.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+/// - Returns: The LLFSM arrangement export code.
+public func cArrangementExportCode(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+    let upperName = name.uppercased()
+    let lowerName = name.lowercased()
+    return """
+    //
+    // Arrangement_\(name)_Export.c
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+    #ifdef LLFSM_SHM_EXPORT
+    #ifndef _POSIX_C_SOURCE
+    #define _POSIX_C_SOURCE 200809L
+    #endif
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+
+    #include \"Machine_Common.h\"
+    #include \"Arrangement_\(name).h\"
+    #include \"Arrangement_\(name)_Export.h\"
+
+    #ifndef NULL
+    #define NULL ((void*)0)
+    #endif
+
+    """ + .block {
+        "/// The mapped shared-memory segment."
+        "static struct Arrangement_\(name)_Export *export_segment;"
+        "/// The states last exported for each instance."
+        "static const struct LLFSMState *exported_states[ARRANGEMENT_\(upperName)_SHM_INSTANCES];"
+        "/// The state indices last exported for each instance."
+        "static uintptr_t exported_indices[ARRANGEMENT_\(upperName)_SHM_INSTANCES];"
+        "/// The number of ringlets exported so far."
+        "static uintptr_t exported_ringlets;"
+        "/// The number of states of each instance."
+        "static const uintptr_t number_of_states[ARRANGEMENT_\(upperName)_SHM_INSTANCES] ="
+        Code.bracedBlock {
+            Code.enumerating(array: instances) { i, instance in
+                "\(instance.fsm.states.count)" + (i < instances.count - 1 ? "," : "")
+            }
+        } + ";"
+        ""
+        "/// Create and map the shared-memory segment of the \(name) arrangement."
+        "///"
+        "/// - Returns: `true` if the segment is ready for exporting."
+        "bool arrangement_" + lowerName + "_export_open(void)"
+        Code.bracedBlock {
+            "if (export_segment) return true;"
+            "const int fd = shm_open(ARRANGEMENT_\(upperName)_SHM_NAME, O_CREAT | O_RDWR, 0644);"
+            "if (fd < 0) return false;"
+            "if (ftruncate(fd, (off_t)sizeof(*export_segment)) != 0)"
+            Code.bracedBlock {
+                "close(fd);"
+                "return false;"
+            }
+            "void * const segment = mmap(NULL, sizeof(*export_segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);"
+            "close(fd);"
+            "if (segment == MAP_FAILED) return false;"
+            "export_segment = segment;"
+            "export_segment->number_of_instances = ARRANGEMENT_\(upperName)_SHM_INSTANCES;"
+            "atomic_store_explicit(&export_segment->magic, ARRANGEMENT_\(upperName)_SHM_MAGIC, memory_order_release);"
+            "return true;"
+        }
+        ""
+        "/// Unmap and remove the shared-memory segment of the \(name) arrangement."
+        "void arrangement_" + lowerName + "_export_close(void)"
+        Code.bracedBlock {
+            "if (!export_segment) return;"
+            "munmap(export_segment, sizeof(*export_segment));"
+            "shm_unlink(ARRANGEMENT_\(upperName)_SHM_NAME);"
+            "export_segment = NULL;"
+        }
+        ""
+        "/// Publish the current state of the \(name) arrangement."
+        "///"
+        "/// State indices are only looked up when a machine changes state."
+        "///"
+        "/// - Parameter arrangement: The machine arrangement to export."
+        "void arrangement_" + lowerName + "_export(const struct Arrangement_" + name + " * const arrangement)"
+        Code.bracedBlock {
+            "if (!export_segment) return;"
+            "const uintptr_t ringlets = ++exported_ringlets;"
+            "uintptr_t i;"
+            "for (i = 0; i < ARRANGEMENT_\(upperName)_SHM_INSTANCES; i++)"
+            Code.bracedBlock {
+                "const struct LLFSMachine * const machine = arrangement->machines[i];"
+                "struct Arrangement_\(name)_Exported_Machine * const exported = &export_segment->machines[i];"
+                "const uintptr_t sequence = atomic_load_explicit(&exported->sequence, memory_order_relaxed);"
+                "if (machine->current_state != exported_states[i])"
+                Code.bracedBlock {
+                    "uintptr_t s = 0;"
+                    "while (s < number_of_states[i] && machine->states[s] != machine->current_state) s++;"
+                    "exported_states[i] = machine->current_state;"
+                    "exported_indices[i] = s;"
+                }
+                "atomic_store_explicit(&exported->sequence, sequence + 1, memory_order_relaxed);"
+                "atomic_thread_fence(memory_order_release);"
+                "atomic_store_explicit(&exported->state, exported_indices[i], memory_order_relaxed);"
+                "atomic_store_explicit(&exported->state_time, machine->state_time, memory_order_relaxed);"
+                "atomic_store_explicit(&exported->ringlets, ringlets, memory_order_relaxed);"
+                "atomic_store_explicit(&exported->sequence, sequence + 2, memory_order_release);"
+            }
+        }
+        ""
+        "#endif // LLFSM_SHM_EXPORT"
+    } + "\n"
+}
+
+/// Return a monitor for a C-language LLFSM arrangement.
+///
+/// The monitor attaches read-only to the shared-memory segment
+/// exported by the arrangement and displays the live state
+/// of every machine instance.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+/// - Returns: The LLFSM arrangement monitor code.
+public func cArrangementMonitorCode(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+    let upperName = name.uppercased()
+    return """
+    //
+    // monitor_main.c for watching the LLFSM arrangement named \(name).
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+    #ifndef _POSIX_C_SOURCE
+    #define _POSIX_C_SOURCE 200809L
+    #endif
+    #include <fcntl.h>
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <sys/mman.h>
+    #include <time.h>
+    #include <unistd.h>
+
+    #include \"Arrangement_\(name)_Export.h\"
+
+    """ + .block {
+        Code.forEach(instances) { instance in
+            "/// State names of the `\(instance.name)` instance."
+            "static const char * const \(instance.name.lowercased())_states[] ="
+            Code.bracedBlock {
+                Code.enumerating(array: instance.fsm.states.compactMap { instance.fsm.stateMap[$0] }) { i, state in
+                    "\"\(state.name)\"" + (i < instance.fsm.states.count - 1 ? "," : "")
+                }
+            } + ";"
+        }
+        ""
+        "/// Instance names."
+        "static const char * const instance_names[ARRANGEMENT_\(upperName)_SHM_INSTANCES] ="
+        Code.bracedBlock {
+            Code.enumerating(array: instances) { i, instance in
+                "\"\(instance.name)\"" + (i < instances.count - 1 ? "," : "")
+            }
+        } + ";"
+        ""
+        "/// State names by instance."
+        "static const char * const * const state_names[ARRANGEMENT_\(upperName)_SHM_INSTANCES] ="
+        Code.bracedBlock {
+            Code.enumerating(array: instances) { i, instance in
+                "\(instance.name.lowercased())_states" + (i < instances.count - 1 ? "," : "")
+            }
+        } + ";"
+        ""
+        "/// Number of states by instance."
+        "static const uintptr_t number_of_states[ARRANGEMENT_\(upperName)_SHM_INSTANCES] ="
+        Code.bracedBlock {
+            Code.enumerating(array: instances) { i, instance in
+                "\(instance.fsm.states.count)" + (i < instances.count - 1 ? "," : "")
+            }
+        } + ";"
+        ""
+        "int main(int argc, char *argv[])"
+        Code.bracedBlock {
+            "const long interval_us = argc > 1 ? strtol(argv[1], NULL, 10) : 10000;"
+            "const struct timespec interval = { .tv_sec = interval_us / 1000000, .tv_nsec = (interval_us % 1000000) * 1000 };"
+            "const int fd = shm_open(ARRANGEMENT_\(upperName)_SHM_NAME, O_RDONLY, 0);"
+            "if (fd < 0)"
+            Code.bracedBlock {
+                "perror(ARRANGEMENT_\(upperName)_SHM_NAME);"
+                "return EXIT_FAILURE;"
+            }
+            "const struct Arrangement_\(name)_Export * const segment = mmap(NULL, sizeof(*segment), PROT_READ, MAP_SHARED, fd, 0);"
+            "close(fd);"
+            "if (segment == MAP_FAILED)"
+            Code.bracedBlock {
+                "perror(\"mmap\");"
+                "return EXIT_FAILURE;"
+            }
+            "if (atomic_load_explicit(&segment->magic, memory_order_acquire) != ARRANGEMENT_\(upperName)_SHM_MAGIC ||"
+            "    segment->number_of_instances != ARRANGEMENT_\(upperName)_SHM_INSTANCES)"
+            Code.bracedBlock {
+                "fprintf(stderr, \"%s: arrangement layout mismatch\\n\", ARRANGEMENT_\(upperName)_SHM_NAME);"
+                "return EXIT_FAILURE;"
+            }
+            "for (;;)"
+            Code.bracedBlock {
+                "uintptr_t i;"
+                "printf(\"\\033[H\\033[J%-24s %-24s %12s %12s\\n\", \"Instance\", \"State\", \"State Time\", \"Ringlets\");"
+                "for (i = 0; i < ARRANGEMENT_\(upperName)_SHM_INSTANCES; i++)"
+                Code.bracedBlock {
+                    "const struct Arrangement_\(name)_Exported_Machine * const machine = &segment->machines[i];"
+                    "uintptr_t before, after, state, state_time, ringlets;"
+                    "do"
+                    Code.bracedBlock {
+                        "before = atomic_load_explicit(&machine->sequence, memory_order_acquire);"
+                        "state = atomic_load_explicit(&machine->state, memory_order_relaxed);"
+                        "state_time = atomic_load_explicit(&machine->state_time, memory_order_relaxed);"
+                        "ringlets = atomic_load_explicit(&machine->ringlets, memory_order_relaxed);"
+                        "atomic_thread_fence(memory_order_acquire);"
+                        "after = atomic_load_explicit(&machine->sequence, memory_order_relaxed);"
+                    }
+                    "while ((before & 1) || before != after);"
+                    "printf(\"%-24s %-24s %12\" PRIuPTR \" %12\" PRIuPTR \"\\n\", instance_names[i], state < number_of_states[i] ? state_names[i][state] : \"?\", state_time, ringlets);"
+                }
+                "fflush(stdout);"
+                "nanosleep(&interval, NULL);"
+            }
+        }
+    } + "\n"
+}
@@ -0,0 +1,79 @@
+//
+//  CBinding+InlineCode.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+/// Placeholder for a `#line` directive restoring the generated file's own line numbers.
+///
+/// This is replaced by `resolvingLineMarkers(in:file:)` once
+/// the final line numbers of the generated file are known.
+@usableFromInline
+let cLineRestoreMarker = "#line %%fsmconvert-restore%%"
+
+/// Return code that includes the given guard or action source.
+///
+/// Without `sources`, this returns an `#include` directive
+/// for the given file.  Otherwise, the content of the file
+/// gets inlined, preceded by a `#line` directive that points
+/// diagnostics and debuggers at the original source, and
+/// followed by a placeholder that `resolvingLineMarkers(in:file:)`
+/// turns into a `#line` directive for the generated file.
+///
+/// - Parameters:
+///   - file: The name of the file containing the source.
+///   - directive: The include directive to use if not inlining.
+///   - sources: The content of the sources to inline by file name (`nil` to include).
+/// - Returns: The code including or inlining the source.
+@usableFromInline
+func cSource(_ file: Filename, directive: String = "#   include", inlining sources: [Filename : String]?) -> Code {
+    guard let sources else { return directive + " \"" + file + "\"" }
+    var content = sources[file] ?? ""
+    while content.last?.isNewline == true { content.removeLast() }
+    return "#line 1 \"" + file + "\"\n" + (content.isEmpty ? "" : content + "\n") + cLineRestoreMarker
+}
+
+/// Resolve the line restore placeholders in generated code.
+///
+/// This replaces each placeholder emitted by `cSource(_:directive:inlining:)`
+/// with a `#line` directive referring to the line that follows it in
+/// the given generated file.
+///
+/// - Parameters:
+///   - code: The generated code.
+///   - file: The name of the generated file.
+/// - Returns: The code with `#line` directives for the generated file.
+@usableFromInline
+func resolvingLineMarkers(in code: Code, file: Filename) -> Code {
+    guard code.contains(cLineRestoreMarker) else { return code }
+    return code.split(separator: "\n", omittingEmptySubsequences: false).enumerated().map { i, line in
+        line.hasSuffix(cLineRestoreMarker) ? "#line \(i + 2) \"" + file + "\"" : String(line)
+    }.joined(separator: "\n")
+}
+
+/// Return the guard and action sources of the given states.
+///
+/// This reads the transition expressions and the state
+/// actions of the given states from the machine wrapper,
+/// as the editable files remain the source of truth when
+/// inlining them into the generated code.
+///
+/// - Parameters:
+///   - states: The states whose sources to return.
+///   - llfsm: The finite-state machine containing the states.
+///   - wrapper: The machine wrapper containing the sources.
+/// - Returns: The content of each source by file name.
+@usableFromInline
+func cInlineSources(for states: [State], of llfsm: LLFSM, in wrapper: MachineWrapper) -> [Filename : String] {
+    var sources = [Filename : String]()
+    for state in states {
+        for (_, file) in cStateBoilerplateFileMappings(for: state.name) where file.hasSuffix(".mm") {
+            sources[file] = wrapper.stringContents(of: file) ?? ""
+        }
+        for (number, transitionID) in llfsm.transitionsFrom(state.id).enumerated() {
+            let file = "State_\(state.name)_Transition_\(number).expr"
+            sources[file] = wrapper.stringContents(of: file) ?? llfsm.transitionMap[transitionID]?.label ?? ""
+        }
+    }
+    return sources
+}
@@ -0,0 +1,301 @@
+//
+//  CBinding+IntrospectionCode.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+/// Create the C introspection interface for an LLFSM.
+///
+/// - Parameters:
+///   - llfsm: The finite-state machine to create the interface for.
+///   - name: The name of the LLFSM.
+///   - isSuspensible: Set to `true` to create an interface that supports suspension.
+/// - Returns: The generated introspection interface.
+public func cMachineIntrospectionInterface(for llfsm: LLFSM, named name: String, isSuspensible: Bool) -> Code {
+    let upperName = name.uppercased()
+    let lowerName = name.lowercased()
+    return """
+    //
+    // Machine_\(name)_Introspection.h
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+
+    """ + .includeFile(named: "LLFSM_MACHINE_" + upperName + "_INTROSPECTION_H") {
+        "#include <inttypes.h>"
+        ""
+        "#define MACHINE_" + upperName + "_TRANSITION_TABLE_SIZE \(llfsm.transitions.count)"
+        "#define MACHINE_" + upperName + "_NO_STATE (~(uintptr_t)0)"
+        ""
+        "/// Static description of a \(name) transition."
+        "struct FSM\(name)_Transition_Info"
+        Code.bracedBlock {
+            "/// Index of the source state."
+            "uintptr_t source;"
+            "/// Index of the target state."
+            "uintptr_t target;"
+            "/// The transition expression."
+            "const char *expression;"
+        } + ";"
+        ""
+        "/// The names of the \(name) states."
+        "extern const char * const fsm_" + lowerName + "_state_names[];"
+        ""
+        "/// The \(name) transitions, ordered by source state and priority."
+        "extern const struct FSM\(name)_Transition_Info fsm_" + lowerName + "_transitions[];"
+        ""
+        "/// Return the name of the given \(name) state."
+        "///"
+        "/// - Parameter state: The index of the state."
+        "/// - Returns: The state name or `NULL` if out of range."
+        "const char *fsm_" + lowerName + "_state_name(uintptr_t state);"
+        ""
+        "/// Return the index of the \(name) state with the given name."
+        "///"
+        "/// - Parameter name: The name of the state to look up."
+        "/// - Returns: The state index or `MACHINE_" + upperName + "_NO_STATE` if not found."
+        "uintptr_t fsm_" + lowerName + "_state_index(const char *name);"
+        ""
+        "/// Return the number of transitions leaving the given \(name) state."
+        "///"
+        "/// - Parameter state: The index of the source state."
+        "/// - Returns: The number of transitions (`0` if out of range)."
+        "uintptr_t fsm_" + lowerName + "_transition_count(uintptr_t state);"
+        ""
+        "/// Return a transition leaving the given \(name) state."
+        "///"
+        "/// - Parameters:"
+        "///   - state: The index of the source state."
+        "///   - transition: The priority of the transition within the source state."
+        "/// - Returns: The transition description or `NULL` if out of range."
+        "const struct FSM\(name)_Transition_Info *fsm_" + lowerName + "_transition(uintptr_t state, uintptr_t transition);"
+        ""
+    }
+}
+
+/// Create the C introspection tables for an LLFSM.
+///
+/// All tables are `const` and thus placed in read-only data.
+///
+/// - Parameters:
+///   - llfsm: The finite-state machine to create the tables for.
+///   - name: The name of the LLFSM.
+///   - isSuspensible: Set to `true` to create an interface that supports suspension.
+/// - Returns: The generated introspection code.
+public func cMachineIntrospectionCode(for llfsm: LLFSM, named name: String, isSuspensible: Bool) -> Code {
+    let upperName = name.uppercased()
+    let lowerName = name.lowercased()
+    let states = llfsm.states.compactMap { llfsm.stateMap[$0] }
+    let transitions: [(source: Int, target: Int, expression: String)] = llfsm.states.enumerated().flatMap { i, stateID in
+        llfsm.transitionsFrom(stateID).compactMap { transitionID in
+            guard let transition = llfsm.transitionMap[transitionID],
+                  let target = llfsm.states.firstIndex(of: transition.target) else { return nil }
+            return (source: i, target: target, expression: transition.label)
+        }
+    }
+    let offsets = (0...llfsm.states.count).map { i in
+        transitions.firstIndex { $0.source >= i } ?? transitions.count
+    }
+    return """
+    //
+    // Machine_\(name)_Introspection.c
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+    #include <string.h>
+    #include \"Machine_\(name)_Introspection.h\"
+
+    #ifndef NULL
+    #define NULL ((void*)0)
+    #endif
+
+    """ + .block {
+        "/// The names of the \(name) states."
+        "const char * const fsm_" + lowerName + "_state_names[] ="
+        Code.bracedBlock {
+            Code.enumerating(array: states) { i, state in
+                state.name.cStringLiteral + (i < states.count - 1 ? "," : "")
+            }
+        } + ";"
+        ""
+        "/// The \(name) transitions, ordered by source state and priority."
+        "const struct FSM\(name)_Transition_Info fsm_" + lowerName + "_transitions[] ="
+        Code.bracedBlock {
+            if transitions.isEmpty {
+                "{ MACHINE_" + upperName + "_NO_STATE, MACHINE_" + upperName + "_NO_STATE, NULL }"
+            } else {
+                Code.enumerating(array: transitions) { i, transition in
+                    "{ \(transition.source), \(transition.target), " + transition.expression.trimmed.cStringLiteral + " }" + (i < transitions.count - 1 ? "," : "")
+                }
+            }
+        } + ";"
+        ""
+        "/// Index of the first transition of each state."
+        "static const uintptr_t transition_offsets[] ="
+        Code.bracedBlock {
+            offsets.map { "\($0)" }.joined(separator: ", ")
+        } + ";"
+        ""
+        "/// Return the name of the given \(name) state."
+        "///"
+        "/// - Parameter state: The index of the state."
+        "/// - Returns: The state name or `NULL` if out of range."
+        "const char *fsm_" + lowerName + "_state_name(uintptr_t state)"
+        Code.bracedBlock {
+            "return state < \(states.count) ? fsm_" + lowerName + "_state_names[state] : NULL;"
+        }
+        ""
+        "/// Return the index of the \(name) state with the given name."
+        "///"
+        "/// - Parameter name: The name of the state to look up."
+        "/// - Returns: The state index or `MACHINE_" + upperName + "_NO_STATE` if not found."
+        "uintptr_t fsm_" + lowerName + "_state_index(const char *name)"
+        Code.bracedBlock {
+            "uintptr_t i;"
+            "for (i = 0; i < \(states.count); i++)"
+            Code.bracedBlock {
+                "if (strcmp(fsm_" + lowerName + "_state_names[i], name) == 0) return i;"
+            }
+            "return MACHINE_" + upperName + "_NO_STATE;"
+        }
+        ""
+        "/// Return the number of transitions leaving the given \(name) state."
+        "///"
+        "/// - Parameter state: The index of the source state."
+        "/// - Returns: The number of transitions (`0` if out of range)."
+        "uintptr_t fsm_" + lowerName + "_transition_count(uintptr_t state)"
+        Code.bracedBlock {
+            "return state < \(states.count) ? transition_offsets[state + 1] - transition_offsets[state] : 0;"
+        }
+        ""
+        "/// Return a transition leaving the given \(name) state."
+        "///"
+        "/// - Parameters:"
+        "///   - state: The index of the source state."
+        "///   - transition: The priority of the transition within the source state."
+        "/// - Returns: The transition description or `NULL` if out of range."
+        "const struct FSM\(name)_Transition_Info *fsm_" + lowerName + "_transition(uintptr_t state, uintptr_t transition)"
+        Code.bracedBlock {
+            "if (transition >= fsm_" + lowerName + "_transition_count(state)) return NULL;"
+            "return &fsm_" + lowerName + "_transitions[transition_offsets[state] + transition];"
+        }
+    } + "\n"
+}
+
+/// Create the C introspection interface for an LLFSM arrangement.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+/// - Returns: The arrangement introspection interface.
+public func cArrangementIntrospectionInterface(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+    let upperName = name.uppercased()
+    let lowerName = name.lowercased()
+    return """
+    //
+    // Arrangement_\(name)_Introspection.h
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+
+    """ + .includeFile(named: "LLFSM_ARRANGEMENT_" + upperName + "_INTROSPECTION_H") {
+        "#include <inttypes.h>"
+        ""
+        "/// Return the name of the given instance of the \(name) arrangement."
+        "///"
+        "/// - Parameter instance: The index of the instance."
+        "/// - Returns: The instance name or `NULL` if out of range."
+        "const char *arrangement_" + lowerName + "_instance_name(uintptr_t instance);"
+        ""
+        "/// Return the machine type of the given instance of the \(name) arrangement."
+        "///"
+        "/// - Parameter instance: The index of the instance."
+        "/// - Returns: The machine type name or `NULL` if out of range."
+        "const char *arrangement_" + lowerName + "_instance_type(uintptr_t instance);"
+        ""
+        "/// Return the name of a state of the given instance of the \(name) arrangement."
+        "///"
+        "/// - Parameters:"
+        "///   - instance: The index of the instance."
+        "///   - state: The index of the state within the instance."
+        "/// - Returns: The state name or `NULL` if out of range."
+        "const char *arrangement_" + lowerName + "_state_name(uintptr_t instance, uintptr_t state);"
+        ""
+    }
+}
+
+/// Create the C introspection tables for an LLFSM arrangement.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+/// - Returns: The arrangement introspection code.
+public func cArrangementIntrospectionCode(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+    let lowerName = name.lowercased()
+    let machineTypes = Array(Set(instances.map(\.typeName))).sorted()
+    return """
+    //
+    // Arrangement_\(name)_Introspection.c
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+    #include \"Arrangement_\(name)_Introspection.h\"
+
+    """ + Code.forEach(machineTypes) { machine in
+        "#include \"" + machine + ".machine/Machine_" + machine + "_Introspection.h\""
+    } + """
+
+
+    #ifndef NULL
+    #define NULL ((void*)0)
+    #endif
+
+    """ + .block {
+        "/// Static description of an instance."
+        "struct Arrangement_\(name)_Instance_Info"
+        Code.bracedBlock {
+            "const char *name;"
+            "const char *type;"
+            "const char *(*state_name)(uintptr_t);"
+        } + ";"
+        ""
+        "/// The instances of the \(name) arrangement."
+        "static const struct Arrangement_\(name)_Instance_Info instance_info[] ="
+        Code.bracedBlock {
+            Code.enumerating(array: instances) { i, instance in
+                "{ " + instance.name.cStringLiteral + ", " + String(instance.typeName).cStringLiteral + ", fsm_" + instance.typeName.lowercased() + "_state_name }" + (i < instances.count - 1 ? "," : "")
+            }
+        } + ";"
+        ""
+        "/// Return the name of the given instance of the \(name) arrangement."
+        "///"
+        "/// - Parameter instance: The index of the instance."
+        "/// - Returns: The instance name or `NULL` if out of range."
+        "const char *arrangement_" + lowerName + "_instance_name(uintptr_t instance)"
+        Code.bracedBlock {
+            "return instance < \(instances.count) ? instance_info[instance].name : NULL;"
+        }
+        ""
+        "/// Return the machine type of the given instance of the \(name) arrangement."
+        "///"
+        "/// - Parameter instance: The index of the instance."
+        "/// - Returns: The machine type name or `NULL` if out of range."
+        "const char *arrangement_" + lowerName + "_instance_type(uintptr_t instance)"
+        Code.bracedBlock {
+            "return instance < \(instances.count) ? instance_info[instance].type : NULL;"
+        }
+        ""
+        "/// Return the name of a state of the given instance of the \(name) arrangement."
+        "///"
+        "/// - Parameters:"
+        "///   - instance: The index of the instance."
+        "///   - state: The index of the state within the instance."
+        "/// - Returns: The state name or `NULL` if out of range."
+        "const char *arrangement_" + lowerName + "_state_name(uintptr_t instance, uintptr_t state)"
+        Code.bracedBlock {
+            "return instance < \(instances.count) ? instance_info[instance].state_name(state) : NULL;"
+        }
+    } + "\n"
+}
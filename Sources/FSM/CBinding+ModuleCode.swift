@@ -0,0 +1,392 @@
+//
+//  CBinding+ModuleCode.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+/// Return the definition of a dynamically loadable LLFSM module descriptor.
+///
+/// This definition is shared between the generated modules
+/// and the arrangement runtime that loads them.
+///
+/// - Returns: The module descriptor definition.
+public func cModuleDescriptorInterface() -> Code {
+    .block {
+        "#ifndef STRUCT_LLFSMMODULE_"
+        "#define STRUCT_LLFSMMODULE_"
+        "#define LLFSM_MODULE_ABI_VERSION 1"
+        "#ifndef LLFSM_MODULE_EXPORT"
+        "#define LLFSM_MODULE_EXPORT __attribute__((visibility(\"default\")))"
+        "#endif"
+        ""
+        "struct LLFSMachine;"
+        ""
+        "/// Versioned descriptor of a dynamically loadable LLFSM."
+        "struct LLFSMModule"
+        Code.bracedBlock {
+            "/// Must equal `LLFSM_MODULE_ABI_VERSION`."
+            "uint32_t abi_version;"
+            "/// The number of states of the machine."
+            "uint32_t number_of_states;"
+            "/// The names of the states."
+            "const char * const *state_names;"
+            "/// Hash of the machine variables."
+            "uint64_t layout_hash;"
+            "/// Offset of the machine variables."
+            "size_t variables_offset;"
+            "/// Size of the machine variables."
+            "size_t variables_size;"
+            "/// Hashes of the state variables."
+            "const uint64_t *state_layout_hashes;"
+            "/// Offsets of the state variables."
+            "const size_t *state_variables_offsets;"
+            "/// Sizes of the state variables."
+            "const size_t *state_variables_sizes;"
+            "/// Allocate and initialise a machine and its states."
+            "struct LLFSMachine *(*create)(void);"
+            "/// Deallocate a machine created by `create`."
+            "void (*destroy)(struct LLFSMachine *);"
+        } + ";"
+        "#endif // STRUCT_LLFSMMODULE_"
+    }
+}
+
+/// Return the loadable module code for an LLFSM.
+///
+/// The module exports a versioned `llfsm_module_<name>` descriptor
+/// that allows the arrangement runtime to replace a running
+/// machine instance with a freshly loaded version.
+///
+/// - Parameters:
+///   - llfsm: The finite-state machine to create the module for.
+///   - name: The name of the LLFSM.
+///   - machineVariables: The machine variable declarations.
+///   - stateVariables: The state variable declarations by state name.
+///   - isSuspensible: Set to `true` to create an interface that supports suspension.
+/// - Returns: The generated module code.
+public func cMachineModuleCode(for llfsm: LLFSM, named name: String, machineVariables: String, stateVariables: [StateName : String], isSuspensible: Bool) -> Code {
+    let lowerName = name.lowercased()
+    let states = llfsm.states.compactMap { llfsm.stateMap[$0] }
+    let lastFunction = isSuspensible ? "on_resume" : "internal"
+    return """
+    //
+    // Machine_\(name)_Module.c
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+    #include <stddef.h>
+    #include <stdlib.h>
+    #include \"Machine_\(name).h\"
+
+    """ + Code.forEach(states) { state in
+        "#include \"State_" + state.name + ".h\""
+    } + "\n\n" + .block {
+        cModuleDescriptorInterface()
+        ""
+        "#ifndef VARIABLES_OFFSET"
+        "#define VARIABLES_OFFSET(type, member) (offsetof(type, member) + sizeof(((type *)0)->member))"
+        "#endif"
+        ""
+        "/// A \(name) machine together with its states."
+        "struct Machine_\(name)_Module_Instance"
+        Code.bracedBlock {
+            "struct Machine_\(name) machine;"
+            Code.forEach(states) { state in
+                "struct FSM\(name)_State_\(state.name) state_\(state.name);"
+            }
+        } + ";"
+        ""
+        "/// Allocate and initialise a \(name) machine."
+        "///"
+        "/// - Returns: The new machine or `NULL` if out of memory."
+        "static struct LLFSMachine *fsm_" + lowerName + "_module_create(void)"
+        Code.bracedBlock {
+            "struct Machine_\(name)_Module_Instance * const instance = calloc(1, sizeof(*instance));"
+            "if (!instance) return NULL;"
+            "struct LLFSMState ** const states = (struct LLFSMState **)(void *)instance->machine.states;"
+            Code.enumerating(array: states) { i, state in
+                "states[\(i)] = (struct LLFSMState *)&instance->state_\(state.name);"
+                "fsm_" + lowerName + "_" + state.name.lowercased() + "_init(&instance->state_\(state.name));"
+            }
+            "fsm_" + lowerName + "_init(&instance->machine);"
+            "return (struct LLFSMachine *)&instance->machine;"
+        }
+        ""
+        "/// Deallocate a \(name) machine."
+        "///"
+        "/// - Parameter machine: The machine to deallocate."
+        "static void fsm_" + lowerName + "_module_destroy(struct LLFSMachine *machine)"
+        Code.bracedBlock {
+            "free(machine);"
+        }
+        ""
+        "/// The names of the \(name) states."
+        "static const char * const state_names[] ="
+        Code.bracedBlock {
+            Code.enumerating(array: states) { i, state in
+                state.name.cStringLiteral + (i < states.count - 1 ? "," : "")
+            }
+        } + ";"
+        ""
+        "/// Hashes of the \(name) state variables."
+        "static const uint64_t state_layout_hashes[] ="
+        Code.bracedBlock {
+            Code.enumerating(array: states) { i, state in
+                "UINT64_C(0x" + String(fnv1aHash(of: stateVariables[state.name]?.trimmed ?? ""), radix: 16) + ")" + (i < states.count - 1 ? "," : "")
+            }
+        } + ";"
+        ""
+        "/// Offsets of the \(name) state variables."
+        "static const size_t state_variables_offsets[] ="
+        Code.bracedBlock {
+            Code.enumerating(array: states) { i, state in
+                "VARIABLES_OFFSET(struct FSM\(name)_State_\(state.name), \(lastFunction))" + (i < states.count - 1 ? "," : "")
+            }
+        } + ";"
+        ""
+        "/// Sizes of the \(name) state variables."
+        "static const size_t state_variables_sizes[] ="
+        Code.bracedBlock {
+            Code.enumerating(array: states) { i, state in
+                "sizeof(struct FSM\(name)_State_\(state.name)) - VARIABLES_OFFSET(struct FSM\(name)_State_\(state.name), \(lastFunction))" + (i < states.count - 1 ? "," : "")
+            }
+        } + ";"
+        ""
+        "/// The \(name) module descriptor."
+        "LLFSM_MODULE_EXPORT const struct LLFSMModule llfsm_module_" + lowerName + " ="
+        Code.bracedBlock {
+            ".abi_version = LLFSM_MODULE_ABI_VERSION,"
+            ".number_of_states = \(states.count),"
+            ".state_names = state_names,"
+            ".layout_hash = UINT64_C(0x" + String(fnv1aHash(of: machineVariables.trimmed), radix: 16) + "),"
+            ".variables_offset = VARIABLES_OFFSET(struct Machine_\(name), states),"
+            ".variables_size = sizeof(struct Machine_\(name)) - VARIABLES_OFFSET(struct Machine_\(name), states),"
+            ".state_layout_hashes = state_layout_hashes,"
+            ".state_variables_offsets = state_variables_offsets,"
+            ".state_variables_sizes = state_variables_sizes,"
+            ".create = fsm_" + lowerName + "_module_create,"
+            ".destroy = fsm_" + lowerName + "_module_destroy"
+        } + ";"
+    } + "\n"
+}
+
+/// Return the dynamic reloading interface for a C-language LLFSM arrangement.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+/// - Returns: The dynamic arrangement interface.
+public func cArrangementDynamicInterface(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+    let upperName = name.uppercased()
+    let lowerName = name.lowercased()
+    return """
+    //
+    // Arrangement_\(name)_Dynamic.h
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+
+    """ + .includeFile(named: "LLFSM_ARRANGEMENT_" + upperName + "_DYNAMIC_H") {
+        "#include <inttypes.h>"
+        "#include <stdbool.h>"
+        "#include <stddef.h>"
+        ""
+        cModuleDescriptorInterface()
+        ""
+        "struct Arrangement_" + name + ";"
+        ""
+        "/// Replace a machine instance with a dynamically loaded version."
+        "///"
+        "/// This must only be called between ringlets."
+        "/// Instances of `static_arrangement_\(lowerName)` cannot be"
+        "/// reloaded, as its specialised executor and `static_fsm_*`"
+        "/// references are bound to the statically linked machines."
+        "/// The current, previous, and resume states get remapped by name."
+        "/// Machine and state variables are carried over"
+        "/// if their layout is unchanged."
+        "/// As `dlopen()` returns the already loaded object for a path"
+        "/// that is still open, each new version must be built to a"
+        "/// distinct path; reloading the running module fails."
+        "///"
+        "/// - Parameters:"
+        "///   - arrangement: The arrangement containing the instance."
+        "///   - instance: The index of the instance to replace."
+        "///   - path: The path of the shared object to load."
+        "/// - Returns: `true` iff the instance was replaced."
+        "bool arrangement_" + lowerName + "_reload(struct Arrangement_" + name + " * const arrangement, uintptr_t instance, const char * const path);"
+        ""
+        "/// Return the module currently running the given instance."
+        "///"
+        "/// - Parameter instance: The index of the instance."
+        "/// - Returns: The module descriptor or `NULL` if out of range."
+        "const struct LLFSMModule *arrangement_" + lowerName + "_module(uintptr_t instance);"
+        ""
+    }
+}
+
+/// Return the dynamic reloading code for a C-language LLFSM arrangement.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+/// - Returns: The dynamic arrangement code.
+public func cArrangementDynamicCode(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+    let upperName = name.uppercased()
+    let lowerName = name.lowercased()
+    let machineTypes = Array(Set(instances.map { String($0.typeName) })).sorted()
+    return """
+    //
+    // Arrangement_\(name)_Dynamic.c
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+    #include <dlfcn.h>
+    #include <string.h>
+    #include \"Machine_Common.h\"
+    #include \"Arrangement_\(name).h\"
+    #include \"Arrangement_\(name)_Dynamic.h\"
+
+    #ifndef NULL
+    #define NULL ((void*)0)
+    #endif
+
+    """ + .block {
+        Code.forEach(machineTypes) { machine in
+            "/// The statically linked \(machine) module."
+            "extern const struct LLFSMModule llfsm_module_" + machine.lowercased() + ";"
+        }
+        ""
+        "/// The static arrangement (if linked in), whose instances cannot be replaced."
+        "extern struct Arrangement_" + name + " static_arrangement_" + lowerName + " __attribute__((weak));"
+        ""
+        "/// Descriptor symbol names by instance."
+        "static const char * const module_symbols[ARRANGEMENT_\(upperName)_NUMBER_OF_INSTANCES] ="
+        Code.bracedBlock {
+            Code.enumerating(array: instances) { i, instance in
+                "\"llfsm_module_\(instance.typeName.lowercased())\"" + (i < instances.count - 1 ? "," : "")
+            }
+        } + ";"
+        ""
+        "/// The modules currently running each instance."
+        "static const struct LLFSMModule *loaded_modules[ARRANGEMENT_\(upperName)_NUMBER_OF_INSTANCES] ="
+        Code.bracedBlock {
+            Code.enumerating(array: instances) { i, instance in
+                "&llfsm_module_\(instance.typeName.lowercased())" + (i < instances.count - 1 ? "," : "")
+            }
+        } + ";"
+        ""
+        "/// Shared object handles (`NULL` for statically linked instances)."
+        "static void *module_handles[ARRANGEMENT_\(upperName)_NUMBER_OF_INSTANCES];"
+        ""
+        "/// Map a state of the old module to the state with the same name in the new module."
+        "///"
+        "/// - Parameters:"
+        "///   - old_module: The module the state belongs to."
+        "///   - old_machine: The machine the state belongs to."
+        "///   - state: The state to map."
+        "///   - module: The new module."
+        "///   - machine: The new machine."
+        "///   - old_index: Set to the index of the state in the old machine."
+        "/// - Returns: The index of the corresponding state in the new machine or `UINT32_MAX`."
+        "static uint32_t remap_state(const struct LLFSMModule * const old_module, const struct LLFSMachine * const old_machine, const struct LLFSMState * const state, const struct LLFSMModule * const module, uint32_t * const old_index)"
+        Code.bracedBlock {
+            "uint32_t i, j;"
+            "*old_index = UINT32_MAX;"
+            "if (!state) return UINT32_MAX;"
+            "for (i = 0; i < old_module->number_of_states && old_machine->states[i] != state; i++) {}"
+            "if (i == old_module->number_of_states) return UINT32_MAX;"
+            "*old_index = i;"
+            "for (j = 0; j < module->number_of_states; j++)"
+            Code.bracedBlock {
+                "if (strcmp(module->state_names[j], old_module->state_names[i]) == 0) return j;"
+            }
+            "return UINT32_MAX;"
+        }
+        ""
+        "/// Transfer the runtime state of a machine to a newly loaded machine."
+        "///"
+        "/// - Parameters:"
+        "///   - old_module: The module of the running machine."
+        "///   - old_machine: The running machine."
+        "///   - module: The newly loaded module."
+        "///   - machine: The newly created machine."
+        "static void transfer_machine(const struct LLFSMModule * const old_module, const struct LLFSMachine * const old_machine, const struct LLFSMModule * const module, struct LLFSMachine * const machine)"
+        Code.bracedBlock {
+            "uint32_t i, j, old_index;"
+            "const uint32_t current = remap_state(old_module, old_machine, old_machine->current_state, module, &old_index);"
+            "const uint32_t previous = remap_state(old_module, old_machine, old_machine->previous_state, module, &old_index);"
+            "if (current != UINT32_MAX)"
+            Code.bracedBlock {
+                "machine->current_state = machine->states[current];"
+                "machine->previous_state = previous != UINT32_MAX ? machine->states[previous] : machine->current_state;"
+                "machine->state_time = old_machine->state_time;"
+            }
+            if isSuspensible {
+                "const uint32_t resume = remap_state(old_module, old_machine, old_machine->resume_state, module, &old_index);"
+                "machine->resume_state = resume != UINT32_MAX ? machine->states[resume] : NULL;"
+            }
+            "if (module->layout_hash == old_module->layout_hash && module->variables_size == old_module->variables_size)"
+            Code.bracedBlock {
+                "memcpy((unsigned char *)machine + module->variables_offset, (const unsigned char *)old_machine + old_module->variables_offset, module->variables_size);"
+            }
+            "for (i = 0; i < old_module->number_of_states; i++)"
+            Code.bracedBlock {
+                "j = remap_state(old_module, old_machine, old_machine->states[i], module, &old_index);"
+                "if (j == UINT32_MAX || module->state_layout_hashes[j] != old_module->state_layout_hashes[i] ||"
+                "    module->state_variables_sizes[j] != old_module->state_variables_sizes[i]) continue;"
+                "memcpy((unsigned char *)machine->states[j] + module->state_variables_offsets[j], (const unsigned char *)old_machine->states[i] + old_module->state_variables_offsets[i], module->state_variables_sizes[j]);"
+            }
+        }
+        ""
+        "/// Replace a machine instance with a dynamically loaded version."
+        "///"
+        "/// A descriptor that is already running the instance"
+        "/// (e.g. a rebuilt object loaded from an unchanged path)"
+        "/// is rejected rather than silently reloading the old code."
+        "///"
+        "/// - Parameters:"
+        "///   - arrangement: The arrangement containing the instance."
+        "///   - instance: The index of the instance to replace."
+        "///   - path: The path of the shared object to load."
+        "/// - Returns: `true` iff the instance was replaced."
+        "bool arrangement_" + lowerName + "_reload(struct Arrangement_" + name + " * const arrangement, uintptr_t instance, const char * const path)"
+        Code.bracedBlock {
+            "if (instance >= ARRANGEMENT_\(upperName)_NUMBER_OF_INSTANCES || arrangement == &static_arrangement_" + lowerName + ") return false;"
+            "void * const handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);"
+            "if (!handle) return false;"
+            "const struct LLFSMModule * const module = (const struct LLFSMModule *)dlsym(handle, module_symbols[instance]);"
+            "struct LLFSMachine * const machine = module && module != loaded_modules[instance] && module->abi_version == LLFSM_MODULE_ABI_VERSION ? module->create() : NULL;"
+            "if (!machine)"
+            Code.bracedBlock {
+                "dlclose(handle);"
+                "return false;"
+            }
+            "const struct LLFSMModule * const old_module = loaded_modules[instance];"
+            "struct LLFSMachine * const old_machine = arrangement->machines[instance];"
+            "transfer_machine(old_module, old_machine, module, machine);"
+            "arrangement->machines[instance] = machine;"
+            "if (module_handles[instance])"
+            Code.bracedBlock {
+                "old_module->destroy(old_machine);"
+                "dlclose(module_handles[instance]);"
+            }
+            "module_handles[instance] = handle;"
+            "loaded_modules[instance] = module;"
+            if isSuspensible {
+                "arrangement->activity_epoch = LLFSM_ACTIVITY_EPOCH_INVALID;"
+            }
+            "return true;"
+        }
+        ""
+        "/// Return the module currently running the given instance."
+        "///"
+        "/// - Parameter instance: The index of the instance."
+        "/// - Returns: The module descriptor or `NULL` if out of range."
+        "const struct LLFSMModule *arrangement_" + lowerName + "_module(uintptr_t instance)"
+        Code.bracedBlock {
+            "return instance < ARRANGEMENT_\(upperName)_NUMBER_OF_INSTANCES ? loaded_modules[instance] : NULL;"
+        }
+    } + "\n"
+}
@@ -0,0 +1,75 @@
+//
+//  CBinding+PartitionCode.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+/// Return the partition interface for a C-language LLFSM arrangement.
+///
+/// Instances in different partitions do not (as far as a lexical
+/// analysis of their actions and guards can tell) write identifiers
+/// the other partitions read or write, so each partition can be
+/// scheduled on a separate thread that calls
+/// `arrangement_<name>_execute_partition()` for its partition.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+///   - analysis: The read/write-set analysis of the instances.
+/// - Returns: The LLFSM arrangement partition interface code.
+public func cArrangementPartitionInterface(for instances: [Instance], named name: String, isSuspensible: Bool, analysis: AccessAnalysis) -> Code {
+    let upperName = name.uppercased()
+    let lowerName = name.lowercased()
+    return """
+    //
+    // Arrangement_\(name)_Partition.h
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+
+    """ + .includeFile(named: "LLFSM_ARRANGEMENT_" + upperName + "_PARTITION_H") {
+        "#include \"Arrangement_\(name).h\""
+        ""
+        "/// Number of independent instance groups."
+        "#define ARRANGEMENT_\(upperName)_NUMBER_OF_PARTITIONS \(analysis.numberOfPartitions)"
+        ""
+        "/// Partition index of each instance, in arrangement order."
+        "#define ARRANGEMENT_\(upperName)_PARTITIONS { " + analysis.partitions.map(String.init).joined(separator: ", ") + " }"
+        ""
+        Code.enumerating(array: instances) { i, instance in
+            "#define ARRANGEMENT_\(upperName)_PARTITION_\(instance.name.uppercased()) \(i < analysis.partitions.count ? analysis.partitions[i] : 0)"
+        }
+        ""
+        if analysis.conflicts.isEmpty {
+            "// No conflicts between instances."
+        } else {
+            "// Conflicts between instances:"
+            Code.forEach(analysis.conflicts) { conflict in
+                "//   \(analysis.instances[conflict.first]) <-> \(analysis.instances[conflict.second]): " + conflict.identifiers.sorted().joined(separator: ", ")
+            }
+        }
+        if !analysis.accesses.allSatisfy(\.calls.isEmpty) {
+            "// Function calls were not analysed."
+        }
+        ""
+        "void llfsm_execute_once(struct LLFSMachine * const machine);"
+        ""
+        "/// Run a ringlet of the instances in the given partition."
+        "///"
+        "/// Different partitions can be run concurrently,"
+        "/// e.g., one thread per partition."
+        "///"
+        "/// - Parameters:"
+        "///   - arrangement: The machine arrangement to run a ringlet over."
+        "///   - partition: The partition whose instances to run."
+        "static inline void arrangement_" + lowerName + "_execute_partition(struct Arrangement_" + name + " * const arrangement, const unsigned partition)"
+        Code.bracedBlock {
+            "static const unsigned partitions[ARRANGEMENT_\(upperName)_NUMBER_OF_INSTANCES] = ARRANGEMENT_\(upperName)_PARTITIONS;"
+            "unsigned i;"
+            "for (i = 0; i < ARRANGEMENT_\(upperName)_NUMBER_OF_INSTANCES; i++)"
+            "    if (partitions[i] == partition) llfsm_execute_once(arrangement->machines[i]);"
+        }
+        ""
+    }
+}
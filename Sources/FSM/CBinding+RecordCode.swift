@@ -0,0 +1,248 @@
+//
+//  CBinding+RecordCode.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+/// Return the snapshot log interface for a C-language LLFSM arrangement.
+///
+/// If `LLFSM_RECORD` is defined, the values of the snapshot variables
+/// are appended to a binary log after every `TAKE_SNAPSHOT()`.
+/// If `LLFSM_REPLAY` is defined, the snapshot variables are read back
+/// from the log instead of calling `TAKE_SNAPSHOT()`.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+/// - Returns: The LLFSM arrangement snapshot log interface code.
+public func cArrangementRecordInterface(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+    let upperName = name.uppercased()
+    let lowerName = name.lowercased()
+    return """
+    //
+    // Arrangement_\(name)_Record.h
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+
+    """ + .includeFile(named: "LLFSM_ARRANGEMENT_" + upperName + "_RECORD_H") {
+        "#include <stdbool.h>"
+        ""
+        "#ifndef ARRANGEMENT_\(upperName)_SNAPSHOT_LOG"
+        "#define ARRANGEMENT_\(upperName)_SNAPSHOT_LOG \"\(name).snapshots\""
+        "#endif"
+        ""
+        "struct Arrangement_" + name + ";"
+        ""
+        "/// Open the snapshot log of the \(name) arrangement."
+        "///"
+        "/// This creates the log when recording and validates"
+        "/// the log header against the current build when replaying."
+        "///"
+        "/// - Parameters:"
+        "///   - arrangement: The arrangement whose snapshots to record or replay."
+        "///   - path: The path of the snapshot log."
+        "/// - Returns: `true` iff the log was opened successfully."
+        "bool arrangement_" + lowerName + "_snapshot_log_open(struct Arrangement_" + name + " * const arrangement, const char * const path);"
+        ""
+        "/// Close the snapshot log of the \(name) arrangement."
+        "void arrangement_" + lowerName + "_snapshot_log_close(void);"
+        ""
+        "/// Check whether the replayed snapshot log has been exhausted."
+        "///"
+        "/// - Returns: `true` iff there are no more snapshots to replay."
+        "bool arrangement_" + lowerName + "_snapshot_log_exhausted(void);"
+        ""
+    }
+}
+
+/// Return the snapshot log code for a C-language LLFSM arrangement.
+///
+/// The log starts with a header containing a hash of the recorded
+/// instances, variables, and their sizes, followed by the raw values
+/// of the snapshot variables of each machine in execution order.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+///   - variables: The snapshot variables to record or replay.
+/// - Returns: The LLFSM arrangement snapshot log code.
+public func cArrangementRecordCode(for instances: [Instance], named name: String, isSuspensible: Bool, variables: [SnapshotVariable]) -> Code {
+    let lowerName = name.lowercased()
+    let recorded = instances.compactMap { instance -> (instance: String, type: String, variables: [String])? in
+        let names = variables.filter { $0.instance == instance.name }.map(\.name)
+        return names.isEmpty ? nil : (instance: instance.name.lowercased(), type: instance.typeName, variables: names)
+    }
+    let machines = Array(Set(recorded.map(\.type))).sorted()
+    let structure = ([name] + recorded.map { machine in
+        machine.instance + ":" + machine.type + ":" + machine.variables.joined(separator: ",")
+    }).joined(separator: "\n")
+    return """
+    //
+    // Arrangement_\(name)_Record.c
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+    #include <stdio.h>
+    #include \"Machine_Common.h\"
+    #include \"Arrangement_\(name).h\"
+    #include \"Arrangement_\(name)_Record.h\"
+
+    """ + Code.forEach(machines) { machine in
+        "#include \"" + machine + ".machine/Machine_" + machine + ".h\""
+    } + "\n\n" + """
+    #if defined(LLFSM_RECORD) || defined(LLFSM_REPLAY)
+
+    #pragma clang diagnostic push
+    #pragma clang diagnostic ignored \"-Wunused-macros\"
+
+    #ifndef NULL
+    #define NULL ((void*)0)
+    #endif
+
+    """ + .block {
+        "#define SNAPSHOT_LOG_MAGIC UINT32_C(0x504e534c)"
+        "#define SNAPSHOT_LOG_VERSION 1"
+        "#define SNAPSHOT_LOG_STRUCTURE_HASH UINT64_C(0x" + String(fnv1aHash(of: structure), radix: 16) + ")"
+        "#ifndef SNAPSHOT_LOG_BUFFER_SIZE"
+        "#define SNAPSHOT_LOG_BUFFER_SIZE 65536"
+        "#endif"
+        ""
+        "/// Snapshot log header."
+        "struct llfsm_snapshot_log_header"
+        Code.bracedBlock {
+            "uint32_t magic;"
+            "uint32_t version;"
+            "uint64_t layout_hash;"
+        } + ";"
+        ""
+        "/// Sizes of the snapshot variables."
+        "static const uint64_t snapshot_layout[] ="
+        Code.bracedBlock {
+            Code.forEach(recorded) { machine in
+                Code.forEach(machine.variables) { variable in
+                    "sizeof(((struct Machine_\(machine.type) *)0)->\(variable)),"
+                }
+            }
+            "0"
+        } + ";"
+        ""
+        "/// The snapshot log."
+        "static FILE *snapshot_log;"
+        "/// The arrangement whose snapshots are logged."
+        "static struct Arrangement_\(name) *snapshot_arrangement;"
+        "/// Set once the replayed log has run out of snapshots."
+        "static bool snapshot_log_exhausted;"
+        ""
+        "/// Return the hash of the snapshot log layout."
+        "///"
+        "/// - Returns: The FNV-1a hash of the snapshot variables and their sizes."
+        "static uint64_t snapshot_layout_hash(void)"
+        Code.bracedBlock {
+            "const unsigned char * const layout = (const unsigned char *)snapshot_layout;"
+            "uint64_t hash = SNAPSHOT_LOG_STRUCTURE_HASH;"
+            "size_t i;"
+            "for (i = 0; i < sizeof(snapshot_layout); i++)"
+            Code.bracedBlock {
+                "hash ^= layout[i];"
+                "hash *= UINT64_C(0x100000001b3);"
+            }
+            "return hash;"
+        }
+        ""
+        "#ifdef LLFSM_REPLAY"
+        "/// Replay the snapshot variables of the given machine."
+        "///"
+        "/// - Parameter machine: The machine to read the snapshot for."
+        "void llfsm_replay_snapshot(struct LLFSMachine * const machine)"
+        Code.bracedBlock {
+            "struct Arrangement_\(name) * const a = snapshot_arrangement;"
+            "if (!snapshot_log || snapshot_log_exhausted) return;"
+            Code.forEach(recorded) { machine in
+                "if (machine == (struct LLFSMachine *)a->fsm_\(machine.instance))"
+                Code.bracedBlock {
+                    Code.forEach(machine.variables) { variable in
+                        "if (fread(&a->fsm_\(machine.instance)->\(variable), sizeof(a->fsm_\(machine.instance)->\(variable)), 1, snapshot_log) != 1) snapshot_log_exhausted = true;"
+                    }
+                    "return;"
+                }
+            }
+        }
+        "#else"
+        "/// Record the snapshot variables of the given machine."
+        "///"
+        "/// - Parameter machine: The machine whose snapshot to append to the log."
+        "void llfsm_record_snapshot(const struct LLFSMachine * const machine)"
+        Code.bracedBlock {
+            "const struct Arrangement_\(name) * const a = snapshot_arrangement;"
+            "if (!snapshot_log) return;"
+            Code.forEach(recorded) { machine in
+                "if (machine == (const struct LLFSMachine *)a->fsm_\(machine.instance))"
+                Code.bracedBlock {
+                    Code.forEach(machine.variables) { variable in
+                        "fwrite(&a->fsm_\(machine.instance)->\(variable), sizeof(a->fsm_\(machine.instance)->\(variable)), 1, snapshot_log);"
+                    }
+                    "return;"
+                }
+            }
+        }
+        "#endif"
+        ""
+        "/// Open the snapshot log of the \(name) arrangement."
+        "///"
+        "/// - Parameters:"
+        "///   - arrangement: The arrangement whose snapshots to record or replay."
+        "///   - path: The path of the snapshot log."
+        "/// - Returns: `true` iff the log was opened successfully."
+        "bool arrangement_" + lowerName + "_snapshot_log_open(struct Arrangement_" + name + " * const arrangement, const char * const path)"
+        Code.bracedBlock {
+            "struct llfsm_snapshot_log_header header = { SNAPSHOT_LOG_MAGIC, SNAPSHOT_LOG_VERSION, snapshot_layout_hash() };"
+            "#ifdef LLFSM_REPLAY"
+            "struct llfsm_snapshot_log_header log_header;"
+            "snapshot_log = fopen(path, \"rb\");"
+            "if (!snapshot_log) return false;"
+            "setvbuf(snapshot_log, NULL, _IOFBF, SNAPSHOT_LOG_BUFFER_SIZE);"
+            "if (fread(&log_header, sizeof(log_header), 1, snapshot_log) != 1 ||"
+            "    log_header.magic != header.magic || log_header.version != header.version ||"
+            "    log_header.layout_hash != header.layout_hash)"
+            Code.bracedBlock {
+                "arrangement_" + lowerName + "_snapshot_log_close();"
+                "return false;"
+            }
+            "#else"
+            "snapshot_log = fopen(path, \"wb\");"
+            "if (!snapshot_log) return false;"
+            "setvbuf(snapshot_log, NULL, _IOFBF, SNAPSHOT_LOG_BUFFER_SIZE);"
+            "if (fwrite(&header, sizeof(header), 1, snapshot_log) != 1)"
+            Code.bracedBlock {
+                "arrangement_" + lowerName + "_snapshot_log_close();"
+                "return false;"
+            }
+            "#endif"
+            "snapshot_arrangement = arrangement;"
+            "snapshot_log_exhausted = false;"
+            "return true;"
+        }
+        ""
+        "/// Close the snapshot log of the \(name) arrangement."
+        "void arrangement_" + lowerName + "_snapshot_log_close(void)"
+        Code.bracedBlock {
+            "if (snapshot_log) fclose(snapshot_log);"
+            "snapshot_log = NULL;"
+        }
+        ""
+        "/// Check whether the replayed snapshot log has been exhausted."
+        "///"
+        "/// - Returns: `true` iff there are no more snapshots to replay."
+        "bool arrangement_" + lowerName + "_snapshot_log_exhausted(void)"
+        Code.bracedBlock {
+            "return snapshot_log_exhausted;"
+        }
+        ""
+        "#pragma clang diagnostic pop"
+        ""
+        "#endif // LLFSM_RECORD || LLFSM_REPLAY"
+    } + "\n"
+}
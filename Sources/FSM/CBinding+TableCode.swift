@@ -0,0 +1,209 @@
+//
+//  CBinding+TableCode.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+/// Return the names of the state actions dispatched by the table-driven executor.
+///
+/// - Parameter isSuspensible: Indicates whether suspend and resume actions are included.
+/// - Returns: The C names of the state actions.
+func tableActions(isSuspensible: Bool) -> [String] {
+    ["on_entry", "on_exit", "internal"] + (isSuspensible ? ["on_suspend", "on_resume"] : [])
+}
+
+/// Return the smallest unsigned C integer type that can hold the given value.
+///
+/// - Parameter maximum: The largest value to store.
+/// - Returns: `uint8_t`, `uint16_t`, or `uint32_t`.
+func cIndexType(for maximum: Int) -> String {
+    maximum <= Int(UInt8.max) ? "uint8_t" : maximum <= Int(UInt16.max) ? "uint16_t" : "uint32_t"
+}
+
+/// Create the table-driven C code for an LLFSM.
+///
+/// Instead of one function per state action and one
+/// `check_transitions` function per state, this emits
+/// read-only tables holding the range of transitions of
+/// each state together with a guard and a target index
+/// for each transition, a single `switch`-based guard
+/// evaluator (sharing identical guards), one dispatcher
+/// per action, and a small generic executor walking the
+/// transition table.  This minimises code size and
+/// instruction cache footprint for very large machines.
+///
+/// - Parameters:
+///   - llfsm: The finite-state machine to create code for.
+///   - name: The name of the LLFSM.
+///   - isSuspensible: Set to `true` to create code that supports suspension.
+///   - isTraceable: Set to `true` to fire a USDT probe for each transition taken.
+///   - sources: The guard and action sources to inline by file name (`nil` to `#include` them).
+/// - Returns: The generated C code.
+public func cMachineTableCode(for llfsm: LLFSM, named name: String, isSuspensible: Bool, isTraceable: Bool = false, inlining sources: [Filename : String]? = nil) -> Code {
+    let lowerName = name.lowercased()
+    let states = llfsm.states.map { llfsm.stateMap[$0] ?? State(id: $0, name: "Orphaned") }
+    let transitions = llfsm.states.map { stateID in
+        llfsm.transitionsFrom(stateID).enumerated().compactMap { number, transitionID in
+            llfsm.transitionMap[transitionID].map { (number: number, transition: $0) }
+        }
+    }
+    let starts = transitions.reduce(into: [0]) { $0.append($0.last! + $1.count) }
+    var guardKeys = [String : Int]()
+    var guards = [(state: State, number: Int)]()
+    let guardIndices = zip(states, transitions).flatMap { state, transitions in
+        transitions.map { number, transition in
+            let label = transition.label.trimmed
+            let key = cTokens(of: label).contains(.identifier("state")) ? state.name + "\n" + label : label
+            if let index = guardKeys[key] { return index }
+            guardKeys[key] = guards.count
+            guards.append((state: state, number: number))
+            return guards.count - 1
+        }
+    }
+    let targets = transitions.flatMap { $0.map { llfsm.states.firstIndex(of: $0.transition.target) ?? 0 } }
+    let guardType = cIndexType(for: guards.count)
+    let targetType = cIndexType(for: states.count)
+    let functionPointerCast = "(void (*)(struct LLFSMachine *, struct LLFSMState *))"
+    let code: Code = """
+    //
+    // Machine_\(name)_Table.c
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+
+    """ + .block {
+        "#include \"Machine_\(name).h\""
+        Code.forEach(states) { state in
+            "#include \"State_\(state.name).h\""
+        }
+        ""
+        "#pragma GCC diagnostic push"
+        "#pragma GCC diagnostic ignored \"-Wunknown-pragmas\""
+        "#pragma GCC diagnostic ignored \"-Wincompatible-pointer-types\""
+        ""
+        "#pragma clang diagnostic push"
+        "#pragma clang diagnostic ignored \"-Wincompatible-function-pointer-types\""
+        "#pragma clang diagnostic ignored \"-Wcompare-distinct-pointer-types\""
+        "#pragma clang diagnostic ignored \"-Wcast-align\""
+        "#pragma clang diagnostic ignored \"-Wunused-parameter\""
+        ""
+        "/// The common prefix of all \(name) states."
+        "struct FSM\(name)_Table_State"
+        Code.bracketedBlock(openingBracket: "{\n", closingBracket: "};\n") {
+            "struct LLFSMState *(*check_transitions)(const struct LLFSMachine *, const struct LLFSMState *);"
+            Code.forEach(tableActions(isSuspensible: isSuspensible)) { action in
+                "void (*" + action + ")(struct LLFSMachine *, struct LLFSMState *);"
+            }
+            "uintptr_t pt_resume;"
+            "uintptr_t state_index;"
+        }
+        "/// The first transition of each state."
+        "///"
+        "/// The transitions of state `s` are at `[start[s], start[s + 1])`."
+        "static const uint32_t fsm_" + lowerName + "_transition_start[\(starts.count)] = { " + starts.map(String.init).joined(separator: ", ") + " };"
+        ""
+        "/// The guard index of each transition."
+        "static const \(guardType) fsm_" + lowerName + "_transition_guard[\(max(guardIndices.count, 1))] = { " + (guardIndices.isEmpty ? "0" : guardIndices.map(String.init).joined(separator: ", ")) + " };"
+        ""
+        "/// The target state index of each transition."
+        "static const \(targetType) fsm_" + lowerName + "_transition_target[\(max(targets.count, 1))] = { " + (targets.isEmpty ? "0" : targets.map(String.init).joined(separator: ", ")) + " };"
+        ""
+        "/// Evaluate a transition guard."
+        "///"
+        "/// - Parameters:"
+        "///   - machine: The machine whose guard to evaluate."
+        "///   - generic_state: The current state of the machine."
+        "///   - guard: The index of the guard to evaluate."
+        "/// - Returns: `true` iff the guard holds."
+        "static bool fsm_" + lowerName + "_eval_guard(const struct Machine_" + name + " * const machine, const struct LLFSMState * const generic_state, const uint32_t guard)"
+        Code.bracedBlock {
+            "switch (guard)"
+            Code.bracedBlock {
+                Code.enumerating(array: guards) { i, guardSource in
+                    "case \(i):"
+                    Code.bracedBlock {
+                        "const struct FSM\(name)_State_\(guardSource.state.name) * const state = (const struct FSM\(name)_State_\(guardSource.state.name) *)generic_state;"
+                        "(void)state;"
+                        "return ("
+                        cSource("State_\(guardSource.state.name)_Transition_\(guardSource.number).expr", directive: "#       include", inlining: sources)
+                        ");"
+                    }
+                }
+                "default:"
+                "    return false;"
+            }
+        }
+        ""
+        "struct LLFSMState *fsm_" + lowerName + "_table_check_transitions(const struct Machine_" + name + " * const machine, const struct LLFSMState * const state)"
+        Code.bracedBlock {
+            "const uintptr_t s = ((const struct FSM\(name)_Table_State *)state)->state_index;"
+            "const uint32_t end = fsm_" + lowerName + "_transition_start[s + 1];"
+            "for (uint32_t t = fsm_" + lowerName + "_transition_start[s]; t < end; t++)"
+            Code.bracedBlock {
+                "if (fsm_" + lowerName + "_eval_guard(machine, state, fsm_" + lowerName + "_transition_guard[t]))"
+                if isTraceable {
+                    Code.bracedBlock {
+                        "LLFSM_PROBE_TRANSITION(machine, s, fsm_" + lowerName + "_transition_target[t], t - fsm_" + lowerName + "_transition_start[s]);"
+                        "return machine->states[fsm_" + lowerName + "_transition_target[t]];"
+                    }
+                } else {
+                    "    return machine->states[fsm_" + lowerName + "_transition_target[t]];"
+                }
+            }
+            "return NULL; // None of the transitions fired."
+        }
+        Code.forEach(Array(zip(tableActions(isSuspensible: isSuspensible), ["OnEntry", "OnExit", "Internal", "OnSuspend", "OnResume"]))) { action, file in
+            ""
+            "void fsm_" + lowerName + "_table_" + action + "(struct Machine_" + name + " * const machine, struct LLFSMState * const generic_state)"
+            Code.bracedBlock {
+                "switch (((struct FSM\(name)_Table_State *)generic_state)->state_index)"
+                Code.bracedBlock {
+                    Code.enumerating(array: states) { i, state in
+                        "case \(i):"
+                        Code.bracedBlock {
+                            "struct FSM\(name)_State_\(state.name) * const state = (struct FSM\(name)_State_\(state.name) *)generic_state;"
+                            "(void)state;"
+                            if action == "on_entry" || action == "on_exit" {
+                                "state->pt_resume = 0;"
+                            } else if action == "internal" {
+                                "uintptr_t * const llfsm_pt_resume = &state->pt_resume;"
+                                "(void)llfsm_pt_resume;"
+                            }
+                            cSource("State_\(state.name)_\(file).mm", directive: "#       include", inlining: sources)
+                            "break;"
+                        }
+                    }
+                    "default:"
+                    "    break;"
+                }
+            }
+        }
+        ""
+        "void fsm_" + lowerName + "_table_init_state(struct LLFSMState * const generic_state, const uintptr_t index)"
+        Code.bracedBlock {
+            "struct FSM\(name)_Table_State * const state = (struct FSM\(name)_Table_State *)generic_state;"
+            "state->check_transitions = (struct LLFSMState *(*)(const struct LLFSMachine *, const struct LLFSMState *))fsm_" + lowerName + "_table_check_transitions;"
+            Code.forEach(tableActions(isSuspensible: isSuspensible)) { action in
+                "state->" + action + " = " + functionPointerCast + "fsm_" + lowerName + "_table_" + action + ";"
+            }
+            "state->pt_resume = 0;"
+            "state->state_index = index;"
+        }
+        ""
+        "bool fsm_" + lowerName + "_table_validate_state(const struct LLFSMState * const generic_state, const uintptr_t index)"
+        Code.bracedBlock {
+            "const struct FSM\(name)_Table_State * const state = (const struct FSM\(name)_Table_State *)generic_state;"
+            "return state->check_transitions == (struct LLFSMState *(*)(const struct LLFSMachine *, const struct LLFSMState *))fsm_" + lowerName + "_table_check_transitions &&"
+            Code.indentedBlock(with: "       ") {
+                Code.forEach(tableActions(isSuspensible: isSuspensible)) { action in
+                    "state->" + action + " == " + functionPointerCast + "fsm_" + lowerName + "_table_" + action + " &&"
+                }
+                "state->state_index == index;"
+            }
+        }
+        ""
+        "#pragma clang diagnostic pop"
+        "#pragma GCC diagnostic pop"
+    } + "\n"
+    return resolvingLineMarkers(in: code, file: "Machine_\(name)_Table.c")
+}
@@ -0,0 +1,138 @@
+//
+//  CBinding+TraceCode.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+/// Return the USDT probe macros for tracing C-language LLFSMs.
+///
+/// The probes belong to the `llfsm` provider and use
+/// `<sys/sdt.h>`, so they compile to a single `nop` each
+/// and cost nothing unless a tracer such as `bpftrace` or
+/// `perf` attaches to them.  Without `<sys/sdt.h>`, or if
+/// `LLFSM_NO_USDT` is defined, the probes expand to nothing.
+///
+/// - Returns: The probe macro definitions.
+public func cTraceProbeMacros() -> Code {
+    .block {
+        "#ifndef LLFSM_PROBE_RINGLET_START"
+        "#if !defined(LLFSM_NO_USDT) && defined(__has_include)"
+        "#if __has_include(<sys/sdt.h>)"
+        "#include <sys/sdt.h>"
+        "#define LLFSM_USDT 1"
+        "#endif"
+        "#endif"
+        "#ifdef LLFSM_USDT"
+        "#define LLFSM_PROBE_RINGLET_START(m, s)    DTRACE_PROBE2(llfsm, ringlet__start, m, s)"
+        "#define LLFSM_PROBE_RINGLET_END(m, s)      DTRACE_PROBE2(llfsm, ringlet__end, m, s)"
+        "#define LLFSM_PROBE_STATE_ENTRY(m, s, t)   DTRACE_PROBE3(llfsm, state__entry, m, s, t)"
+        "#define LLFSM_PROBE_TRANSITION(m, f, t, i) DTRACE_PROBE4(llfsm, transition, m, f, t, i)"
+        "#define LLFSM_PROBE_SUSPEND(m, s)          DTRACE_PROBE2(llfsm, suspend, m, s)"
+        "#define LLFSM_PROBE_RESUME(m, s)           DTRACE_PROBE2(llfsm, resume, m, s)"
+        "#else"
+        "#define LLFSM_PROBE_RINGLET_START(m, s)    ((void)0)"
+        "#define LLFSM_PROBE_RINGLET_END(m, s)      ((void)0)"
+        "#define LLFSM_PROBE_STATE_ENTRY(m, s, t)   ((void)0)"
+        "#define LLFSM_PROBE_TRANSITION(m, f, t, i) ((void)0)"
+        "#define LLFSM_PROBE_SUSPEND(m, s)          ((void)0)"
+        "#define LLFSM_PROBE_RESUME(m, s)           ((void)0)"
+        "#endif"
+        "#endif // LLFSM_PROBE_RINGLET_START"
+    }
+}
+
+/// Return a `bpftrace` script printing the transitions of an arrangement.
+///
+/// The `transition` probe is fired by the `check_transitions`
+/// code of each machine with the machine, the indices of the
+/// source and target states, and the index of the transition.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+/// - Returns: The `bpftrace` script.
+public func cArrangementTransitionsScript(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+    let binary = "./run_\(name)_arrangement"
+    return """
+    #!/usr/bin/env bpftrace
+    //
+    // \(name)_transitions.bt
+    //
+    // Print the transitions of the \(name) LLFSM arrangement, e.g. using
+    //     sudo bpftrace \(name)_transitions.bt
+    // in the build directory (adjust the path for other binaries).
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+
+    """ + .block {
+        "usdt:" + binary + ":llfsm:transition"
+        Code.bracedBlock {
+            "printf(\"%-24s state %d -> %d (transition %d)\\n\", usym(arg0), arg1, arg2, arg3);"
+            "@transitions[usym(arg0), arg1, arg2] = count();"
+        }
+        if isSuspensible {
+            ""
+            "usdt:" + binary + ":llfsm:suspend"
+            Code.bracedBlock {
+                "printf(\"%-24s suspended in %s\\n\", usym(arg0), usym(arg1));"
+            }
+            ""
+            "usdt:" + binary + ":llfsm:resume"
+            Code.bracedBlock {
+                "printf(\"%-24s resumed in %s\\n\", usym(arg0), usym(arg1));"
+            }
+        }
+    } + "\n"
+}
+
+/// Return a `bpftrace` script summarising the ringlets of an arrangement.
+///
+/// This prints a histogram of the ringlet durations of each
+/// machine and the number of times each state was entered.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+/// - Returns: The `bpftrace` script.
+public func cArrangementRingletsScript(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+    let binary = "./run_\(name)_arrangement"
+    return """
+    #!/usr/bin/env bpftrace
+    //
+    // \(name)_ringlets.bt
+    //
+    // Summarise the ringlet durations (in ns) and state entries of the
+    // \(name) LLFSM arrangement, e.g. using
+    //     sudo bpftrace \(name)_ringlets.bt
+    // in the build directory (adjust the path for other binaries).
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+
+    """ + .block {
+        "usdt:" + binary + ":llfsm:ringlet__start"
+        Code.bracedBlock {
+            "@start[tid] = nsecs;"
+        }
+        ""
+        "usdt:" + binary + ":llfsm:ringlet__end"
+        "/@start[tid]/"
+        Code.bracedBlock {
+            "@ringlet_ns[usym(arg0)] = hist(nsecs - @start[tid]);"
+            "delete(@start[tid]);"
+        }
+        ""
+        "usdt:" + binary + ":llfsm:state__entry"
+        Code.bracedBlock {
+            "@entries[usym(arg0), usym(arg1)] = count();"
+        }
+        ""
+        "END"
+        Code.bracedBlock {
+            "clear(@start);"
+        }
+    } + "\n"
+}
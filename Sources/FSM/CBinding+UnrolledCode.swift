@@ -0,0 +1,252 @@
+//
+//  CBinding+UnrolledCode.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+/// The maximum number of states of a machine to dispatch directly.
+///
+/// The specialised ringlet of an instance compares the current state
+/// against each of its states in turn, so machines with more states
+/// fall back to the generic, function-pointer based ringlet.
+public let cUnrolledStateLimit = 32
+
+/// Return the specialised executor for a static C-language LLFSM arrangement.
+///
+/// As the instances of a static arrangement are known at generation
+/// time, this emits a ringlet function for each instance that
+/// operates on its statically allocated machine and calls the
+/// actions and transition checks of its states directly, as well
+/// as an `arrangement_<name>_execute_once()` function that runs
+/// these ringlets in order.  This allows the compiler to inline
+/// across machines and keep machine fields in registers,
+/// rather than looping over `struct LLFSMachine` pointers.
+///
+/// - Note: Suspended (idle) machines are skipped directly,
+///         rather than through the active machine bitmap,
+///         which gets invalidated for the generic executor.
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+///   - isTableDriven: Indicates whether the machines use the table-driven executor.
+///   - isTraceable: Indicates whether the ringlets fire USDT probes.
+/// - Returns: The specialised arrangement executor code.
+public func cStaticArrangementExecuteCode(for instances: [Instance], named name: String, isSuspensible: Bool, isTableDriven: Bool = false, isTraceable: Bool = false) -> Code {
+    let lowerName = name.lowercased()
+    return .block {
+        Code.forEach(instances) { instance in
+            let machineName = instance.typeName
+            let lowerMachine = machineName.lowercased()
+            let lowerInstance = instance.name.lowercased()
+            let states = instance.fsm.states.compactMap { instance.fsm.stateMap[$0] }
+            "/// Run a ringlet of the \(instance.name) instance of the \(machineName) LLFSM."
+            "static inline void static_" + lowerInstance + "_execute_once(void)"
+            Code.bracedBlock {
+                if states.count > cUnrolledStateLimit {
+                    "llfsm_execute_once((struct LLFSMachine *)&static_fsm_" + lowerInstance + ");"
+                } else {
+                    "struct Machine_" + machineName + " * const machine = &static_fsm_" + lowerInstance + ";"
+                    "struct LLFSMState * const current_state = machine->current_state;"
+                    "struct LLFSMState *target_state;"
+                    if isTraceable {
+                        "LLFSM_PROBE_RINGLET_START(machine, current_state);"
+                    }
+                    Code.enumerating(array: states) { i, state in
+                        let function = "fsm_" + lowerMachine + "_" + state.name.lowercased()
+                        let staticState = "static_" + lowerInstance + "_state_" + state.name
+                        let argument = isTableDriven ? "current_state" : "state"
+                        (i == 0 ? "if" : "else if") + " (current_state == (struct LLFSMState *)&" + staticState + ")"
+                        Code.bracedBlock {
+                            if !isTableDriven {
+                                "struct FSM" + machineName + "_State_" + state.name + " * const state = &" + staticState + ";"
+                            }
+                            "if (current_state != machine->previous_state)"
+                            Code.bracedBlock {
+                                "machine->state_time = GET_TIME();"
+                                if isSuspensible {
+                                    "if (current_state == machine->suspend_state)"
+                                    Code.bracedBlock {
+                                        if isTraceable {
+                                            "LLFSM_PROBE_SUSPEND(machine, machine->previous_state);"
+                                        }
+                                        "if (machine->previous_state && machine->previous_state->on_suspend) machine->previous_state->on_suspend((struct LLFSMachine *)machine, machine->previous_state);"
+                                        function + "_on_suspend(machine, " + argument + ");"
+                                    }
+                                    "else if (machine->previous_state == machine->suspend_state)"
+                                    Code.bracedBlock {
+                                        if isTraceable {
+                                            "LLFSM_PROBE_RESUME(machine, current_state);"
+                                        }
+                                        "if (machine->previous_state && machine->previous_state->on_resume) machine->previous_state->on_resume((struct LLFSMachine *)machine, machine->previous_state);"
+                                        function + "_on_resume(machine, " + argument + ");"
+                                    }
+                                }
+                                if isTraceable {
+                                    "LLFSM_PROBE_STATE_ENTRY(machine, current_state, machine->state_time);"
+                                }
+                                function + "_on_entry(machine, " + argument + ");"
+                            }
+                            "LLFSM_SNAPSHOT((struct LLFSMachine *)machine);"
+                            "target_state = " + function + "_check_transitions(machine, " + argument + ");"
+                            "machine->previous_state = current_state;"
+                            "if (target_state)"
+                            Code.bracedBlock {
+                                function + "_on_exit(machine, " + argument + ");"
+                                "machine->current_state = target_state;"
+                            }
+                            "else " + function + "_internal(machine, " + argument + ");"
+                        }
+                    }
+                    if states.isEmpty {
+                        "(void)current_state;"
+                        "(void)target_state;"
+                    } else {
+                        "else llfsm_execute_once((struct LLFSMachine *)machine);"
+                    }
+                    if isTraceable {
+                        "LLFSM_PROBE_RINGLET_END(machine, machine->current_state);"
+                    }
+                }
+            }
+            ""
+        }
+        "/// Run a ringlet of the static \(name) LLFSM arrangement."
+        "///"
+        "/// This runs the specialised ringlet of each instance in order,"
+        "/// equivalent to `fsm_arrangement_execute_once()` on"
+        "/// `static_arrangement_\(lowerName)`."
+        "void arrangement_" + lowerName + "_execute_once(void)"
+        Code.bracedBlock {
+            Code.forEach(instances) { instance in
+                let lowerInstance = instance.name.lowercased()
+                let isPollable = instance.fsm.suspendState.map { !instance.fsm.transitionsFrom($0).isEmpty } ?? false
+                if isSuspensible {
+                    "if (!IS_IDLE(&static_fsm_" + lowerInstance + ")) static_" + lowerInstance + "_execute_once();"
+                    if isPollable {
+                        "#if LLFSM_POLL_SUSPENDED"
+                        "else"
+                        Code.bracedBlock {
+                            "struct LLFSMachine * const machine = (struct LLFSMachine *)&static_fsm_" + lowerInstance + ";"
+                            "struct LLFSMState * const current_state = machine->current_state;"
+                            "LLFSM_SNAPSHOT(machine);"
+                            "struct LLFSMState * const target_state = current_state->check_transitions(machine, current_state);"
+                            "if (target_state)"
+                            Code.bracedBlock {
+                                "current_state->on_exit(machine, current_state);"
+                                "machine->current_state = target_state;"
+                            }
+                        }
+                        "#endif"
+                    }
+                } else {
+                    "static_" + lowerInstance + "_execute_once();"
+                }
+            }
+            if isSuspensible {
+                "// the active machine bitmap is not maintained here"
+                "static_arrangement_" + lowerName + ".activity_epoch = LLFSM_ACTIVITY_EPOCH_INVALID;"
+            }
+        }
+        ""
+    }
+}
+
+/// Return a benchmark comparing the generic and the specialised executor.
+///
+/// The benchmark checkpoints the initial configuration of the
+/// static arrangement, runs the given number of ringlets using
+/// `fsm_arrangement_execute_once()`, restores the checkpoint,
+/// and runs the same number of ringlets using the specialised
+/// `arrangement_<name>_execute_once()`, reporting the time per
+/// ringlet of each and whether both reached the same configuration.
+///
+/// - Parameters:
+///   - instances: The instances to arrange.
+///   - name: The name of the arrangement
+///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+/// - Returns: The benchmark main code.
+public func cStaticArrangementBenchmarkCode(for instances: [Instance], named name: String, isSuspensible: Bool) -> Code {
+    let lowerName = name.lowercased()
+    return """
+    //
+    // benchmark_main.c for comparing the executors of the static LLFSM arrangement named \(name).
+    //
+    // Automatically created using fsmconvert -- do not change manually!
+    //
+    #ifndef _POSIX_C_SOURCE
+    #define _POSIX_C_SOURCE 200809L
+    #endif
+    #include <inttypes.h>
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <string.h>
+    #include <time.h>
+
+    #include \"Machine_Common.h\"
+    #include \"Arrangement_\(name).h\"
+    #include \"Static_Arrangement_\(name).h\"
+
+    """ + .block {
+        "/// Return the elapsed time between two points in time."
+        "///"
+        "/// - Parameters:"
+        "///   - start: The start time."
+        "///   - end: The end time."
+        "/// - Returns: The elapsed time in seconds."
+        "static double benchmark_seconds(const struct timespec * const start, const struct timespec * const end)"
+        Code.bracedBlock {
+            "return (double)(end->tv_sec - start->tv_sec) + (double)(end->tv_nsec - start->tv_nsec) * 1e-9;"
+        }
+        ""
+        "int main(int argc, char *argv[])"
+        Code.bracedBlock {
+            "const uintmax_t ringlets = argc > 1 ? strtoumax(argv[1], NULL, 10) : 10000000;"
+            "struct LLFSMArrangement * const arrangement = (struct LLFSMArrangement *)&static_arrangement_" + lowerName + ";"
+            "const size_t size = fsm_arrangement_checkpoint_size();"
+            "unsigned char * const initial = malloc(size);"
+            "unsigned char * const generic = malloc(size);"
+            "unsigned char * const specialised = malloc(size);"
+            "struct timespec start, end;"
+            "double generic_seconds, specialised_seconds;"
+            "uintmax_t i;"
+            ""
+            "if (!initial || !generic || !specialised)"
+            Code.bracedBlock {
+                "perror(\"benchmark_\(lowerName)\");"
+                "return EXIT_FAILURE;"
+            }
+            "if (!arrangement_" + lowerName + "_validate(&static_arrangement_" + lowerName + "))"
+            Code.bracedBlock {
+                "printf(\"'static_arrangement_" + lowerName + "' does not validate!\\n\");"
+                "return EXIT_FAILURE;"
+            }
+            "fsm_arrangement_checkpoint(arrangement, initial, size);"
+            ""
+            "clock_gettime(CLOCK_MONOTONIC, &start);"
+            "for (i = 0; i < ringlets; i++) fsm_arrangement_execute_once(arrangement);"
+            "clock_gettime(CLOCK_MONOTONIC, &end);"
+            "generic_seconds = benchmark_seconds(&start, &end);"
+            "fsm_arrangement_checkpoint(arrangement, generic, size);"
+            ""
+            "fsm_arrangement_restore(arrangement, initial, size);"
+            "clock_gettime(CLOCK_MONOTONIC, &start);"
+            "for (i = 0; i < ringlets; i++) arrangement_" + lowerName + "_execute_once();"
+            "clock_gettime(CLOCK_MONOTONIC, &end);"
+            "specialised_seconds = benchmark_seconds(&start, &end);"
+            "fsm_arrangement_checkpoint(arrangement, specialised, size);"
+            ""
+            "printf(\"\(name): %ju ringlets\\n\", ringlets);"
+            "printf(\"generic:     %.6f s, %.2f ns/ringlet\\n\", generic_seconds, ringlets ? generic_seconds * 1e9 / (double)ringlets : 0.0);"
+            "printf(\"specialised: %.6f s, %.2f ns/ringlet\\n\", specialised_seconds, ringlets ? specialised_seconds * 1e9 / (double)ringlets : 0.0);"
+            "if (specialised_seconds > 0) printf(\"speedup:     %.2fx\\n\", generic_seconds / specialised_seconds);"
+            "if (memcmp(generic, specialised, size)) printf(\"warning: the executors reached different configurations\\n\");"
+            ""
+            "free(specialised);"
+            "free(generic);"
+            "free(initial);"
+            ""
+            "return EXIT_SUCCESS;"
+        }
+    } + "\n"
+}
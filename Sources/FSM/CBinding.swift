@@ -51,6 +51,19 @@ public struct CBinding: OutputLanguage {
         targetOfCTransition(transitionNumber, state: stateName, for: machineWrapper, with: states)
     }
 
+    /// Plain C binding from URL, states, and source state name to the targets of its transitions.
+    ///
+    /// - Parameters:
+    ///   - numberOfTransitions: The number of transitions to examine.
+    ///   - machineWrapper: The MachineWrapper to examine.
+    ///   - stateName: The name of the state to examine.
+    ///   - states: The states of the machine.
+    /// - Returns: The target state IDs of the transitions, in order.
+    @inlinable
+    public func targets(of numberOfTransitions: Int, for machineWrapper: MachineWrapper, stateName: StateName, with states: [State]) -> [StateID?] {
+        targetsOfCTransitions(numberOfTransitions, state: stateName, for: machineWrapper, with: states)
+    }
+
     /// Objective-C++ binding from URL, states to suspend state ID.
     ///
     /// - Parameters:
@@ -116,7 +129,7 @@ public extension CBinding {
     @inlinable
     func addInterface(for llfsm: LLFSM, to wrapper: MachineWrapper, isSuspensible: Bool) throws {
         let name = wrapper.name
-        let machineCode = cMachineInterface(for: llfsm, named: name, isSuspensible: isSuspensible)
+        let machineCode = cMachineInterface(for: llfsm, named: name, isSuspensible: isSuspensible, isTraceable: wrapper.isTraceable)
         let fileWrapper = fileWrapper(named: "Machine_" + name + ".h", from: machineCode)
         wrapper.replaceFileWrapper(fileWrapper)
     }
@@ -137,7 +150,7 @@ public extension CBinding {
                 fputs("Warning: orphaned state ID \(stateID) for \(name)\n", stderr)
                 continue
             }
-            let stateCode = cStateInterface(for: state, llfsm: fsm, named: name, isSuspensible: isSuspensible)
+            let stateCode = cStateInterface(for: state, llfsm: fsm, named: name, isSuspensible: isSuspensible, isTableDriven: wrapper.isTableDriven)
             let fileWrapper = fileWrapper(named: "State_" + state.name + ".h", from: stateCode)
             wrapper.replaceFileWrapper(fileWrapper)
         }
@@ -157,6 +170,29 @@ public extension CBinding {
         let machineCode = cMachineCode(for: llfsm, named: name, isSuspensible: isSuspensible)
         let fileWrapper = fileWrapper(named: "Machine_" + name + ".c", from: machineCode)
         wrapper.replaceFileWrapper(fileWrapper)
+        if wrapper.isIntrospectable {
+            try addIntrospection(for: llfsm, to: wrapper, isSuspensible: isSuspensible)
+        }
+    }
+    /// Add the introspection tables for the given LLFSM to the given `MachineWrapper`.
+    ///
+    /// This method adds read-only tables describing the states
+    /// and transitions of the given finite-state machine,
+    /// as well as functions to look them up.
+    ///
+    /// - Parameters:
+    ///   - llfsm: The finite-state machine to add.
+    ///   - wrapper: The `MachineWrapper` to add to.
+    ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+    @inlinable
+    func addIntrospection(for llfsm: LLFSM, to wrapper: MachineWrapper, isSuspensible: Bool) throws {
+        let name = wrapper.name
+        let introspectionInterface = cMachineIntrospectionInterface(for: llfsm, named: name, isSuspensible: isSuspensible)
+        let interfaceWrapper = fileWrapper(named: "Machine_" + name + "_Introspection.h", from: introspectionInterface)
+        wrapper.replaceFileWrapper(interfaceWrapper)
+        let introspectionCode = cMachineIntrospectionCode(for: llfsm, named: name, isSuspensible: isSuspensible)
+        let codeWrapper = fileWrapper(named: "Machine_" + name + "_Introspection.c", from: introspectionCode)
+        wrapper.replaceFileWrapper(codeWrapper)
     }
     /// Add the state code for the given LLFSM to the given `MachineWrapper`.
     ///
@@ -170,12 +206,19 @@ public extension CBinding {
     @inlinable
     func addStateCode(for fsm: LLFSM, to wrapper: MachineWrapper, isSuspensible: Bool) throws {
         let name = wrapper.name
+        let sources = wrapper.isInlined ? cInlineSources(for: fsm.states.compactMap { fsm.stateMap[$0] }, of: fsm, in: wrapper) : nil
+        if wrapper.isTableDriven {
+            let tableCode = cMachineTableCode(for: fsm, named: name, isSuspensible: isSuspensible, isTraceable: wrapper.isTraceable, inlining: sources)
+            let fileWrapper = fileWrapper(named: "Machine_" + name + "_Table.c", from: tableCode)
+            wrapper.replaceFileWrapper(fileWrapper)
+            return
+        }
         for stateID in fsm.states {
             guard let state = fsm.stateMap[stateID] else {
                 fputs("Warning: orphaned state ID \(stateID) for \(name)\n", stderr)
                 continue
             }
-            let stateCode = cStateCode(for: state, llfsm: fsm, named: name, isSuspensible: isSuspensible)
+            let stateCode = cStateCode(for: state, llfsm: fsm, named: name, isSuspensible: isSuspensible, isTraceable: wrapper.isTraceable, inlining: sources)
             let fileWrapper = fileWrapper(named: "State_" + state.name + ".c", from: stateCode)
             wrapper.replaceFileWrapper(fileWrapper)
         }
@@ -197,17 +240,153 @@ public extension CBinding {
                 fputs("Warning: orphaned state \(i) ID \(stateID) for \(name)\n", stderr)
                 continue
             }
-            let transitions = fsm.transitionsFrom(stateID)
-            transitions.enumerated().forEach { number, transitionID in
-                guard let transition = fsm.transitionMap[transitionID] else {
-                    fputs("Warning: orphaned transition \(number) (\(transitionID)) for \(state.name)\n", stderr)
-                    return
-                }
-                let file = "State_\(state.name)_Transition_\(number).expr"
-                let fileWrapper = fileWrapper(named: file, from: transition.label + "\n")
-                wrapper.replaceFileWrapper(fileWrapper)
+            addTransitionCode(for: state, of: fsm, to: wrapper)
+        }
+    }
+    /// Add the transition expressions for the given state to the given `MachineWrapper`.
+    ///
+    /// - Parameters:
+    ///   - state: The source state of the transitions.
+    ///   - llfsm: The finite-state machine containing the state.
+    ///   - wrapper: The `MachineWrapper` to add to.
+    @inlinable
+    func addTransitionCode(for state: State, of fsm: LLFSM, to wrapper: MachineWrapper) {
+        let transitions = fsm.transitionsFrom(state.id)
+        transitions.enumerated().forEach { number, transitionID in
+            guard let transition = fsm.transitionMap[transitionID] else {
+                fputs("Warning: orphaned transition \(number) (\(transitionID)) for \(state.name)\n", stderr)
+                return
+            }
+            let file = "State_\(state.name)_Transition_\(number).expr"
+            let fileWrapper = fileWrapper(named: file, from: transition.label + "\n")
+            wrapper.replaceFileWrapper(fileWrapper)
+        }
+        var number = transitions.count
+        while let staleWrapper = wrapper.fileWrappers?["State_\(state.name)_Transition_\(number).expr"] {
+            wrapper.removeFileWrapper(staleWrapper)
+            number += 1
+        }
+    }
+    /// Add the files for the given states to the given `MachineWrapper`.
+    ///
+    /// This method regenerates the interface, code, and
+    /// transition expressions of the given states only.
+    /// The machine-level introspection and table-driven
+    /// code only gets regenerated if transition guards or
+    /// targets changed (or if actions are inlined into the
+    /// table).  The batchability of the given states gets
+    /// re-examined, and the batch files get regenerated
+    /// if the machine is batchable.  If the machine became
+    /// (or stopped being) batchable, the batch files get
+    /// added (or removed) and the CMake files regenerated.
+    ///
+    /// - Note: State boilerplate needs to be added before
+    ///         calling this method, as the batch code is
+    ///         derived from the actions in the wrapper.
+    /// - Parameters:
+    ///   - stateIDs: The states whose files to regenerate.
+    ///   - llfsm: The finite-state machine containing the states.
+    ///   - wrapper: The `MachineWrapper` to add to.
+    ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+    ///   - transitionsChanged: Indicates whether any transition guards or targets were edited.
+    @inlinable
+    func addStateFiles(for stateIDs: [StateID], of fsm: LLFSM, to wrapper: MachineWrapper, isSuspensible: Bool, transitionsChanged: Bool) throws {
+        let name = wrapper.name
+        for stateID in stateIDs {
+            guard let state = fsm.stateMap[stateID] else { continue }
+            let stateInterface = cStateInterface(for: state, llfsm: fsm, named: name, isSuspensible: isSuspensible, isTableDriven: wrapper.isTableDriven)
+            let interfaceWrapper = fileWrapper(named: "State_" + state.name + ".h", from: stateInterface)
+            wrapper.replaceFileWrapper(interfaceWrapper)
+            addTransitionCode(for: state, of: fsm, to: wrapper)
+            if !wrapper.isTableDriven {
+                let sources = wrapper.isInlined ? cInlineSources(for: [state], of: fsm, in: wrapper) : nil
+                let stateCode = cStateCode(for: state, llfsm: fsm, named: name, isSuspensible: isSuspensible, isTraceable: wrapper.isTraceable, inlining: sources)
+                let codeWrapper = fileWrapper(named: "State_" + state.name + ".c", from: stateCode)
+                wrapper.replaceFileWrapper(codeWrapper)
             }
         }
+        if wrapper.isTableDriven && (transitionsChanged || wrapper.isInlined) {
+            let sources = wrapper.isInlined ? cInlineSources(for: fsm.states.compactMap { fsm.stateMap[$0] }, of: fsm, in: wrapper) : nil
+            let tableCode = cMachineTableCode(for: fsm, named: name, isSuspensible: isSuspensible, isTraceable: wrapper.isTraceable, inlining: sources)
+            let tableWrapper = fileWrapper(named: "Machine_" + name + "_Table.c", from: tableCode)
+            wrapper.replaceFileWrapper(tableWrapper)
+        }
+        if wrapper.isIntrospectable && transitionsChanged {
+            try addIntrospection(for: fsm, to: wrapper, isSuspensible: isSuspensible)
+        }
+        let boilerplate = boilerplateOfCMachine(at: wrapper)
+        var analysis = wrapper.batchAnalysis ?? BatchAnalysis(for: fsm, boilerplate: boilerplate, stateBoilerplate: cStateBoilerplate(for: fsm, in: wrapper))
+        analysis.update(states: stateIDs, of: fsm, stateBoilerplate: cStateBoilerplate(for: fsm, in: wrapper, states: stateIDs))
+        wrapper.batchAnalysis = analysis
+        let batchFiles = ["Machine_" + name + "_Batch.h", "Machine_" + name + "_Batch.c"]
+        let wasBatchable = wrapper.fileWrappers?[batchFiles[1]] != nil
+        if let variables = analysis.variables(for: fsm) {
+            addBatchCode(for: fsm, named: name, to: wrapper, isSuspensible: isSuspensible, variables: variables)
+        } else if wasBatchable {
+            for file in batchFiles {
+                if let batchWrapper = wrapper.fileWrappers?[file] { wrapper.removeFileWrapper(batchWrapper) }
+            }
+        }
+        if wasBatchable != (analysis.variables(for: fsm) != nil) {
+            try addCMakeFile(for: fsm, boilerplate: boilerplate, to: wrapper, isSuspensible: isSuspensible)
+        }
+    }
+    /// Add the loadable module code for the given LLFSM to the given `MachineWrapper`.
+    ///
+    /// This method adds a module exporting a versioned descriptor
+    /// for the given finite-state machine, whose variable layout
+    /// hashes are derived from the machine and state variables
+    /// previously added to the given `MachineWrapper`.
+    ///
+    /// - Parameters:
+    ///   - llfsm: The finite-state machine to add.
+    ///   - wrapper: The `MachineWrapper` to add to.
+    ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+    @inlinable
+    func addModuleCode(for fsm: LLFSM, to wrapper: MachineWrapper, isSuspensible: Bool) throws {
+        let name = wrapper.name
+        let machineVariables = wrapper.stringContents(of: "Machine_\(name)_Variables.h") ?? ""
+        let stateVariables: [StateName : String] = Dictionary(fsm.states.compactMap { stateID in
+            fsm.stateMap[stateID].map { ($0.name, wrapper.stringContents(of: "State_\($0.name)_Variables.h") ?? "") }
+        }, uniquingKeysWith: { a, _ in a })
+        let moduleCode = cMachineModuleCode(for: fsm, named: name, machineVariables: machineVariables, stateVariables: stateVariables, isSuspensible: isSuspensible)
+        let moduleWrapper = fileWrapper(named: "Machine_" + name + "_Module.c", from: moduleCode)
+        wrapper.replaceFileWrapper(moduleWrapper)
+    }
+    /// Add the batch executor code for the given LLFSM to the given `MachineWrapper`.
+    ///
+    /// This method adds a struct-of-arrays batch executor
+    /// if the actions and guards previously added to the
+    /// given `MachineWrapper` are simple arithmetic over
+    /// scalar machine variables.
+    ///
+    /// - Parameters:
+    ///   - llfsm: The finite-state machine to add.
+    ///   - wrapper: The `MachineWrapper` to add to.
+    ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+    @inlinable
+    func addBatchCode(for fsm: LLFSM, to wrapper: MachineWrapper, isSuspensible: Bool) throws {
+        let analysis = BatchAnalysis(for: fsm, boilerplate: boilerplateOfCMachine(at: wrapper), stateBoilerplate: cStateBoilerplate(for: fsm, in: wrapper))
+        wrapper.batchAnalysis = analysis
+        guard let variables = analysis.variables(for: fsm) else { return }
+        addBatchCode(for: fsm, named: wrapper.name, to: wrapper, isSuspensible: isSuspensible, variables: variables)
+    }
+    /// Add the batch executor files for the given batch variables.
+    ///
+    /// - Parameters:
+    ///   - llfsm: The batchable finite-state machine to add.
+    ///   - name: The name of the machine.
+    ///   - wrapper: The `MachineWrapper` to add to.
+    ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+    ///   - variables: The machine variables to store as arrays.
+    @inlinable
+    func addBatchCode(for fsm: LLFSM, named name: String, to wrapper: MachineWrapper, isSuspensible: Bool, variables: [BatchVariable]) {
+        let batchInterface = cMachineBatchInterface(for: fsm, named: name, isSuspensible: isSuspensible, variables: variables)
+        let interfaceWrapper = fileWrapper(named: "Machine_" + name + "_Batch.h", from: batchInterface)
+        wrapper.replaceFileWrapper(interfaceWrapper)
+        let batchCode = cMachineBatchCode(for: fsm, named: name, isSuspensible: isSuspensible, variables: variables, stateBoilerplate: cStateBoilerplate(for: fsm, in: wrapper))
+        let codeWrapper = fileWrapper(named: "Machine_" + name + "_Batch.c", from: batchCode)
+        wrapper.replaceFileWrapper(codeWrapper)
     }
     /// Add a CMakefile for the given LLFSM to the given `MachineWrapper`.
     ///
@@ -223,12 +402,17 @@ public extension CBinding {
     @inlinable
     func addCMakeFile(for fsm: LLFSM, boilerplate: any Boilerplate, to wrapper: MachineWrapper, isSuspensible: Bool) throws {
         let name = wrapper.name
-        let cmakeFragment = cMakeFragment(for: fsm, named: name, isSuspensible: isSuspensible)
+        let cmakeFragment = cMakeFragment(for: fsm, named: name, isSuspensible: isSuspensible, isIntrospectable: wrapper.isIntrospectable, isTableDriven: wrapper.isTableDriven)
         let fragmentWrapper = fileWrapper(named: "project.cmake", from: cmakeFragment)
         wrapper.replaceFileWrapper(fragmentWrapper)
-        let cmakeLists = cMakeLists(for: fsm, named: name, boilerplate: boilerplate, isSuspensible: isSuspensible)
+        let analysis = wrapper.batchAnalysis ?? BatchAnalysis(for: fsm, boilerplate: boilerplate, stateBoilerplate: cStateBoilerplate(for: fsm, in: wrapper))
+        let isBatchable = analysis.variables(for: fsm) != nil
+        let cmakeLists = cMakeLists(for: fsm, named: name, boilerplate: boilerplate, isSuspensible: isSuspensible, isBatchable: isBatchable)
         let cmakeWrapper = fileWrapper(named: "CMakeLists.txt", from: cmakeLists)
         wrapper.replaceFileWrapper(cmakeWrapper)
+        let packageConfig = cMakePackageConfig(named: name)
+        let packageWrapper = fileWrapper(named: name + "Config.cmake.in", from: packageConfig)
+        wrapper.replaceFileWrapper(packageWrapper)
     }
 }
 
@@ -246,7 +430,10 @@ public extension CBinding {
     ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
     func addArrangementInterface(for instances: [Instance], to wrapper: ArrangementWrapper, isSuspensible: Bool) throws {
         let name = wrapper.name
-        let commonInterface = cArrangementMachineInterface(for: instances, named: name, isSuspensible: isSuspensible)
+        let macroInterface = cArrangementMacroInterface(isSuspensible: isSuspensible, isTraceable: wrapper.isTraceable)
+        let macroWrapper = fileWrapper(named: "Machine_Macros.h", from: macroInterface)
+        wrapper.replaceFileWrapper(macroWrapper)
+        let commonInterface = cArrangementMachineInterface(for: instances, named: name, isSuspensible: isSuspensible, channels: wrapper.arrangement.channels, isCheckpointable: wrapper.hasCheckpoints)
         let commonWrapper = fileWrapper(named: "Machine_Common.h", from: commonInterface)
         wrapper.replaceFileWrapper(commonWrapper)
         let arrangementInterface = cArrangementInterface(for: instances, named: name, isSuspensible: isSuspensible)
@@ -255,6 +442,35 @@ public extension CBinding {
         let staticInterface = cStaticArrangementInterface(for: instances, named: name, isSuspensible: isSuspensible)
         let staticWrapper = fileWrapper(named: "Static_Arrangement_\(name).h", from: staticInterface)
         wrapper.replaceFileWrapper(staticWrapper)
+        if wrapper.isReloadable {
+            let dynamicInterface = cArrangementDynamicInterface(for: instances, named: name, isSuspensible: isSuspensible)
+            let dynamicInterfaceWrapper = fileWrapper(named: "Arrangement_\(name)_Dynamic.h", from: dynamicInterface)
+            wrapper.replaceFileWrapper(dynamicInterfaceWrapper)
+        }
+        if wrapper.isExportable {
+            let exportInterface = cArrangementExportInterface(for: instances, named: name, isSuspensible: isSuspensible)
+            let exportWrapper = fileWrapper(named: "Arrangement_\(name)_Export.h", from: exportInterface)
+            wrapper.replaceFileWrapper(exportWrapper)
+        }
+        if wrapper.isSimulatable || wrapper.isExplorable {
+            let contextInterface = cArrangementContextInterface(for: instances, named: name, isSuspensible: isSuspensible)
+            let contextInterfaceWrapper = fileWrapper(named: "Arrangement_\(name)_Context.h", from: contextInterface)
+            wrapper.replaceFileWrapper(contextInterfaceWrapper)
+        }
+        if wrapper.isPartitioned {
+            let machineTypes = wrapper.arrangement.machineTypes(of: instances)
+            let analysis = AccessAnalysis(instances: instances.compactMap { instance in
+                machineTypes[instance.typeFile].map { (name: instance.name, machine: $0) }
+            })
+            let partitionInterface = cArrangementPartitionInterface(for: instances, named: name, isSuspensible: isSuspensible, analysis: analysis)
+            let partitionWrapper = fileWrapper(named: "Arrangement_\(name)_Partition.h", from: partitionInterface)
+            wrapper.replaceFileWrapper(partitionWrapper)
+        }
+        if !wrapper.arrangement.snapshotVariables.isEmpty {
+            let recordInterface = cArrangementRecordInterface(for: instances, named: name, isSuspensible: isSuspensible)
+            let recordWrapper = fileWrapper(named: "Arrangement_\(name)_Record.h", from: recordInterface)
+            wrapper.replaceFileWrapper(recordWrapper)
+        }
     }
     /// Add the arrangment implementation to the given .
     ///
@@ -267,18 +483,79 @@ public extension CBinding {
     ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
     func addArrangementCode(for instances: [Instance], to wrapper: ArrangementWrapper, isSuspensible: Bool) throws {
         let name = wrapper.name
-        let commonCode = cArrangementMachineCode(for: instances, named: name, isSuspensible: isSuspensible)
+        let commonCode = cArrangementMachineCode(for: instances, named: name, isSuspensible: isSuspensible, channels: wrapper.arrangement.channels, isTraceable: wrapper.isTraceable)
         let commonWrapper = fileWrapper(named: "Machine_Common.c", from: commonCode)
         wrapper.replaceFileWrapper(commonWrapper)
         let arrangementCode = cArrangementCode(for: instances, named: name, isSuspensible: isSuspensible)
         let arrangementWrapper = fileWrapper(named: "Arrangement_\(name).c", from: arrangementCode)
         wrapper.replaceFileWrapper(arrangementWrapper)
-        let staticCode = cStaticArrangementCode(for: instances, named: name, isSuspensible: isSuspensible)
+        let staticCode = cStaticArrangementCode(for: instances, named: name, isSuspensible: isSuspensible, isTableDriven: wrapper.isTableDriven, isTraceable: wrapper.isTraceable)
         let staticWrapper = fileWrapper(named: "Static_Arrangement_\(name).c", from: staticCode)
         wrapper.replaceFileWrapper(staticWrapper)
-        let mainCode = cStaticArrangementMainCode(for: instances, named: name, isSuspensible: isSuspensible)
+        let snapshotVariables = wrapper.arrangement.snapshotVariables
+        let mainCode = cStaticArrangementMainCode(for: instances, named: name, isSuspensible: isSuspensible, isRecordable: !snapshotVariables.isEmpty)
         let mainWrapper = fileWrapper(named: "static_main.c", from: mainCode)
         wrapper.replaceFileWrapper(mainWrapper)
+        if wrapper.hasCheckpoints {
+            let variables = Dictionary(wrapper.arrangement.machineTypes(of: instances).map { ($0.sansExtension, variableDeclarations(of: $1)) }, uniquingKeysWith: { a, _ in a })
+            let checkpointCode = cArrangementCheckpointCode(for: instances, named: name, isSuspensible: isSuspensible, variables: variables, channels: wrapper.arrangement.channels)
+            let checkpointWrapper = fileWrapper(named: "Arrangement_\(name)_Checkpoint.c", from: checkpointCode)
+            wrapper.replaceFileWrapper(checkpointWrapper)
+        }
+        if wrapper.isReloadable {
+            let dynamicCode = cArrangementDynamicCode(for: instances, named: name, isSuspensible: isSuspensible)
+            let dynamicWrapper = fileWrapper(named: "Arrangement_\(name)_Dynamic.c", from: dynamicCode)
+            wrapper.replaceFileWrapper(dynamicWrapper)
+        }
+        if wrapper.isExportable {
+            let exportCode = cArrangementExportCode(for: instances, named: name, isSuspensible: isSuspensible)
+            let exportWrapper = fileWrapper(named: "Arrangement_\(name)_Export.c", from: exportCode)
+            wrapper.replaceFileWrapper(exportWrapper)
+            let monitorCode = cArrangementMonitorCode(for: instances, named: name, isSuspensible: isSuspensible)
+            let monitorWrapper = fileWrapper(named: "monitor_main.c", from: monitorCode)
+            wrapper.replaceFileWrapper(monitorWrapper)
+        }
+        if wrapper.isSimulatable || wrapper.isExplorable {
+            let contextCode = cArrangementContextCode(for: instances, named: name, isSuspensible: isSuspensible, channels: wrapper.arrangement.channels)
+            let contextWrapper = fileWrapper(named: "Arrangement_\(name)_Context.c", from: contextCode)
+            wrapper.replaceFileWrapper(contextWrapper)
+        }
+        if wrapper.isExplorable {
+            let exploreCode = cArrangementExploreCode(for: instances, named: name, isSuspensible: isSuspensible, inputs: snapshotVariables)
+            let exploreWrapper = fileWrapper(named: "explore_main.c", from: exploreCode)
+            wrapper.replaceFileWrapper(exploreWrapper)
+        }
+        if wrapper.isSimulatable {
+            let simulateCode = cArrangementSimulateCode(for: instances, named: name, isSuspensible: isSuspensible, inputs: snapshotVariables)
+            let simulateWrapper = fileWrapper(named: "simulate_main.c", from: simulateCode)
+            wrapper.replaceFileWrapper(simulateWrapper)
+        }
+        if wrapper.isBenchmarkable {
+            let benchmarkCode = cStaticArrangementBenchmarkCode(for: instances, named: name, isSuspensible: isSuspensible)
+            let benchmarkWrapper = fileWrapper(named: "benchmark_main.c", from: benchmarkCode)
+            wrapper.replaceFileWrapper(benchmarkWrapper)
+        }
+        if wrapper.isTraceable {
+            let transitionsScript = cArrangementTransitionsScript(for: instances, named: name, isSuspensible: isSuspensible)
+            let transitionsWrapper = fileWrapper(named: "\(name)_transitions.bt", from: transitionsScript)
+            wrapper.replaceFileWrapper(transitionsWrapper)
+            let ringletsScript = cArrangementRingletsScript(for: instances, named: name, isSuspensible: isSuspensible)
+            let ringletsWrapper = fileWrapper(named: "\(name)_ringlets.bt", from: ringletsScript)
+            wrapper.replaceFileWrapper(ringletsWrapper)
+        }
+        if !snapshotVariables.isEmpty {
+            let recordCode = cArrangementRecordCode(for: instances, named: name, isSuspensible: isSuspensible, variables: snapshotVariables)
+            let recordWrapper = fileWrapper(named: "Arrangement_\(name)_Record.c", from: recordCode)
+            wrapper.replaceFileWrapper(recordWrapper)
+        }
+        if wrapper.isIntrospectable {
+            let introspectionInterface = cArrangementIntrospectionInterface(for: instances, named: name, isSuspensible: isSuspensible)
+            let introspectionInterfaceWrapper = fileWrapper(named: "Arrangement_\(name)_Introspection.h", from: introspectionInterface)
+            wrapper.replaceFileWrapper(introspectionInterfaceWrapper)
+            let introspectionCode = cArrangementIntrospectionCode(for: instances, named: name, isSuspensible: isSuspensible)
+            let introspectionWrapper = fileWrapper(named: "Arrangement_\(name)_Introspection.c", from: introspectionCode)
+            wrapper.replaceFileWrapper(introspectionWrapper)
+        }
     }
     /// Add a CMakefile for the given LLFSM arrangement to the given `MachineWrapper`.
     ///
@@ -292,10 +569,11 @@ public extension CBinding {
     @inlinable
     func addArrangementCMakeFile(for instances: [Instance], to wrapper: ArrangementWrapper, isSuspensible: Bool) throws {
         let name = wrapper.name
-        let cmakeFragment = cArrangementCMakeFragment(for: instances, named: name, isSuspensible: isSuspensible)
+        let isRecordable = !wrapper.arrangement.snapshotVariables.isEmpty
+        let cmakeFragment = cArrangementCMakeFragment(for: instances, named: name, isSuspensible: isSuspensible, isIntrospectable: wrapper.isIntrospectable, isRecordable: isRecordable, isExportable: wrapper.isExportable, isCheckpointable: wrapper.hasCheckpoints, hasContexts: wrapper.isSimulatable || wrapper.isExplorable)
         let fragmentWrapper = fileWrapper(named: "project.cmake", from: cmakeFragment)
         wrapper.replaceFileWrapper(fragmentWrapper)
-        let cmakeLists = cArrangementCMakeLists(for: instances, named: name, isSuspensible: isSuspensible)
+        let cmakeLists = cArrangementCMakeLists(for: instances, named: name, isSuspensible: isSuspensible, channels: wrapper.arrangement.channels, isRecordable: isRecordable, isTraceable: wrapper.isTraceable, isExportable: wrapper.isExportable, isReloadable: wrapper.isReloadable, isExplorable: wrapper.isExplorable, isSimulatable: wrapper.isSimulatable, isBenchmarkable: wrapper.isBenchmarkable)
         let cmakeWrapper = fileWrapper(named: "CMakeLists.txt", from: cmakeLists)
         wrapper.replaceFileWrapper(cmakeWrapper)
     }
@@ -306,9 +584,7 @@ public extension CBinding {
 /// - Returns: The number of transitions in the given state.
 @inlinable
 public func numberOfCTransitionsIn(header content: String) -> Int {
-    guard let numString = string(containedIn: content, matching: #/numberOfTransitions.*return[^0-9]*([0-9][0-9]*)/#),
-          let numberOfTransitions = Int(numString) else { return 0 }
-    return numberOfTransitions
+    integer(following: ["numberOfTransitions", "return"], in: content) ?? 0
 }
 
 
@@ -320,9 +596,7 @@ public func numberOfCTransitionsIn(header content: String) -> Int {
 /// - Returns:
 @inlinable
 public func targetStateIndexOfCTransition(_ i: Int, inHeader content: String) -> Int? {
-    guard let numString = string(containedIn: content, matching: try! Regex("Transition_\(i).*int.*toState.*=[^0-9]*([0-9]*)")),
-          let targetStateIndex = Int(numString) else { return nil }
-    return targetStateIndex
+    integer(following: ["Transition_\(i)", "int", "toState", "="], in: content)
 }
 
 
@@ -369,6 +643,24 @@ public func expressionOfCTransition(_ number: Int, state: StateName, for machine
     return content.trimmingCharacters(in:.whitespacesAndNewlines)
 }
 
+/// Return the target state IDs for the first transitions of a given state
+///
+/// This reads and scans the `State.h` file only once.
+///
+/// - Parameters:
+///   - count: The number of transitions to examine.
+///   - name: The name of the state to search for.
+///   - machineWrapper: The MachineWrapper to examine.
+///   - states: Array of states to examine.
+/// - Returns: The State IDs (or `nil` for transitions without a valid target).
+@inlinable
+public func targetsOfCTransitions(_ count: Int, state name: StateName, for machineWrapper: MachineWrapper, with states: [State]) -> [StateID?] {
+    let indices = contentOfCState(for: machineWrapper, state: name).map { transitionTargetIndices(inHeader: $0) } ?? [:]
+    return (0..<count).map { number in
+        indices[number].flatMap { $0 >= 0 && $0 < states.count ? states[$0].id : nil }
+    }
+}
+
 /// Return the target state ID for a given transition
 /// - Parameters:
 ///   - number:The sequence number of the transition to examine.
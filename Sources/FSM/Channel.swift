@@ -0,0 +1,64 @@
+//
+//  Channel.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+import Foundation
+
+/// Single-producer/single-consumer message channel.
+///
+/// A channel connects two machine instances of an arrangement
+/// through a fixed-capacity, lock-free ring buffer.
+public struct Channel: Equatable, Hashable {
+    /// The name of the channel.
+    ///
+    /// This name needs to be unique within an arrangement
+    /// and a valid C identifier.
+    public let name: String
+    /// The type of the elements sent through the channel.
+    public let elementType: String
+    /// The number of elements the channel can hold.
+    ///
+    /// This is always a power of two.
+    public let capacity: Int
+    /// The name of the instance sending through the channel.
+    public let producer: String
+    /// The name of the instance receiving from the channel.
+    public let consumer: String
+
+    /// Designated initialiser for a channel.
+    ///
+    /// - Note: The capacity gets rounded up to the next power of two.
+    /// - Parameters:
+    ///   - name: The unique name of the channel.
+    ///   - elementType: The type of the channel elements.
+    ///   - capacity: The minimum number of elements the channel can hold.
+    ///   - producer: The name of the producer instance.
+    ///   - consumer: The name of the consumer instance.
+    @inlinable
+    public init(name: String, elementType: String, capacity: Int, producer: String, consumer: String) {
+        self.name = name
+        self.elementType = elementType
+        self.capacity = capacity <= 1 ? 1 : 1 << (Int.bitWidth - (capacity - 1).leadingZeroBitCount)
+        self.producer = producer
+        self.consumer = consumer
+    }
+}
+
+public extension Channel {
+    /// Create a channel from a textual description.
+    ///
+    /// The description has the form
+    /// `name:type:capacity:producer:consumer`.
+    ///
+    /// - Parameter description: The channel description.
+    init?(description: String) {
+        let components = description.split(separator: ":", omittingEmptySubsequences: false).map { $0.trimmingCharacters(in: .whitespaces) }
+        guard components.count == 5,
+              let capacity = Int(components[2]), capacity > 0,
+              !components[0].isEmpty, !components[1].isEmpty,
+              !components[3].isEmpty, !components[4].isEmpty else { return nil }
+        self.init(name: components[0], elementType: components[1], capacity: capacity, producer: components[3], consumer: components[4])
+    }
+}
@@ -9,4 +9,39 @@
 public enum FSMError: String, Error, RawRepresentable, Codable {
     /// Unsupported output format.
     case unsupportedOutputFormat = "Unsupported output format"
+    /// Duplicate channel or channel referring to an unknown instance.
+    case invalidChannel = "Invalid channel"
+    /// Snapshot variable referring to an unknown instance.
+    case invalidSnapshotVariable = "Invalid snapshot variable"
+    /// Product machine exceeding the maximum number of states.
+    case productTooLarge = "Product machine too large"
+    /// State name that is already in use.
+    case duplicateState = "Duplicate state"
+    /// State ID that is not part of the machine.
+    case unknownState = "Unknown state"
+    /// Transition ID that is not part of the machine.
+    case unknownTransition = "Unknown transition"
+    /// Machine wrapper that is not an instance of the arrangement.
+    case unknownMachine = "Unknown machine"
+    /// Malformed or truncated (tar) archive.
+    case invalidArchive = "Invalid archive"
+    /// Error compressing or decompressing an archive.
+    case compressionFailed = "Compression failed"
+    /// Compressed archive, but FSM was built without libzstd.
+    case compressionUnavailable = "Compression not available"
+}
+
+/// Errors of the individual parts of an arrangement.
+///
+/// The machines of an arrangement are generated and written
+/// independently, so this collects the errors of all parts
+/// that failed, rather than just the first one.
+public struct ArrangementError: Error, CustomStringConvertible {
+    /// The filename of each failed part and its error.
+    public var errors: [(filename: Filename, error: any Error)]
+
+    /// The errors of all failed parts, one per line.
+    public var description: String {
+        errors.map { "\($0.filename): \($0.error)" }.joined(separator: "\n")
+    }
 }
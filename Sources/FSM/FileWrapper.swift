@@ -258,16 +258,36 @@ open class FileWrapper: @unchecked Sendable {
     }
 
     /// Add a child `FileWrapper`.
+    ///
+    /// The children dictionary is moved out of `content`
+    /// while inserting, so it is mutated in place rather
+    /// than copied for every child that gets added.
+    ///
     /// - Parameter child: The child `FileWrapper` to add.
     /// - Returns: The filename of the added child.
     @discardableResult @inlinable
     open func replaceFileWrapper(_ child: FileWrapper) -> String {
         guard case var .directory(children) = content else { return "" }
+        content = nil
         let filename = child.filename ?? child.preferredFilename ?? UUID().uuidString
         children[filename] = child
         content = .directory(children)
         return filename
     }
+
+    /// Add or replace child `FileWrapper`s in bulk.
+    ///
+    /// This merges the given children into the
+    /// children dictionary in place, in a single update.
+    ///
+    /// - Parameter newChildren: The child `FileWrapper`s by file name.
+    @inlinable
+    open func replaceFileWrappers(_ newChildren: [String : FileWrapper]) {
+        guard case var .directory(children) = content else { return }
+        content = nil
+        children.merge(newChildren) { $1 }
+        content = .directory(children)
+    }
 }
 
 public extension FileWrapper {
@@ -387,6 +407,19 @@ extension FileWrapper {
         addFileWrapper(child)
     }
 
+#if canImport(Darwin)
+    /// Add or replace child `FileWrapper`s in bulk.
+    ///
+    /// - Parameter newChildren: The child `FileWrapper`s by file name.
+    @usableFromInline
+    func replaceFileWrappers(_ newChildren: [String : FileWrapper]) {
+        for (filename, child) in newChildren {
+            if child.preferredFilename == nil { child.preferredFilename = filename }
+            replaceFileWrapper(child)
+        }
+    }
+#endif
+
     /// Remove all child FileWrappers.
     @usableFromInline
     func removeFileWrappers() {
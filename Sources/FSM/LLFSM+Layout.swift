@@ -0,0 +1,198 @@
+//
+//  LLFSM+Layout.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+import Foundation
+
+/// Automatically computed layout of states and transitions.
+public typealias AutomaticLayout = (states: [StateID : StateLayout], transitions: [TransitionID : TransitionLayout])
+
+/// The number of states per parallel chunk when ordering layers.
+private let layoutChunkSize = 1024
+
+public extension LLFSM {
+    /// Compute a layered (Sugiyama-style) layout of the machine.
+    ///
+    /// States are assigned to layers by their breadth-first
+    /// distance from the initial (and suspend) state, with
+    /// unreachable states layered after all reachable ones.
+    /// The states within each layer are then ordered using
+    /// alternating barycentre sweeps to reduce crossings,
+    /// computing the barycentres of large layers in parallel.
+    /// Each sweep takes O(|E| + |V| log |V|) time.
+    /// Transitions are routed as cubic Bezier curves between
+    /// the state outlines; self-loops, back edges, and parallel
+    /// transitions are bent to keep them apart.
+    ///
+    /// - Parameters:
+    ///   - horizontalSpacing: The distance between the centres of adjacent states in a layer.
+    ///   - verticalSpacing: The distance between the centres of adjacent layers.
+    ///   - top: The vertical position above the first layer.
+    ///   - sweeps: The number of down/up barycentre sweeps.
+    /// - Returns: The layouts of all states and transitions.
+    func layeredLayout(horizontalSpacing: Double = 150, verticalSpacing: Double = 150, top: Double = 0, sweeps: Int = 4) -> AutomaticLayout {
+        let index = Dictionary(states.enumerated().map { ($1, $0) }, uniquingKeysWith: { a, _ in a })
+        let edges = transitions.compactMap { transitionMap[$0] }.compactMap { transition -> (Int, Int)? in
+            guard let source = index[transition.source], let target = index[transition.target] else { return nil }
+            return (source, target)
+        }
+        var neighbours = [[Int]](repeating: [], count: states.count)
+        for (source, target) in edges where source != target {
+            neighbours[source].append(target)
+            neighbours[target].append(source)
+        }
+        let layer = layers(roots: [initialState, suspendState].compactMap { $0.flatMap { index[$0] } }, count: states.count, successors: edges)
+        var layers = [[Int]](repeating: [], count: (layer.max() ?? -1) + 1)
+        for (i, l) in layer.enumerated() { layers[l].append(i) }
+        var position = [Int](repeating: 0, count: states.count)
+        for l in layers { for (p, i) in l.enumerated() { position[i] = p } }
+        for sweep in 0..<(2 * sweeps) {
+            let isDownward = sweep % 2 == 0
+            let order = isDownward ? Array(layers.indices.dropFirst()) : Array(layers.indices.dropLast().reversed())
+            for l in order {
+                let adjacent = isDownward ? l - 1 : l + 1
+                let keys = barycentres(of: layers[l], adjacentLayer: adjacent, layer: layer, position: position, neighbours: neighbours)
+                layers[l] = layers[l].indices.sorted { keys[$0] < keys[$1] || (keys[$0] == keys[$1] && $0 < $1) }.map { layers[l][$0] }
+                for (p, i) in layers[l].enumerated() { position[i] = p }
+            }
+        }
+        let widest = Double(layers.map(\.count).max() ?? 0)
+        var stateLayouts = [StateID : StateLayout]()
+        var centres = [Coordinate2D](repeating: Coordinate2D(), count: states.count)
+        var sizes = [Dimensions2D](repeating: Dimensions2D(), count: states.count)
+        for (i, stateID) in states.enumerated() {
+            let x = horizontalSpacing * (Double(position[i]) - Double(layers[layer[i]].count - 1) / 2 + widest / 2)
+            let y = top + verticalSpacing * (Double(layer[i]) + 0.5)
+            var layout = StateLayout()
+            layout.closedLayout.x = x
+            layout.closedLayout.y = y
+            layout.openLayout.x = x
+            layout.openLayout.y = y
+            stateLayouts[stateID] = layout
+            sizes[i] = layout.layout.dimensions
+            centres[i] = Coordinate2D(x + sizes[i].w / 2, y + sizes[i].h / 2)
+        }
+        var transitionLayouts = [TransitionID : TransitionLayout]()
+        var parallel = [Int : Int]()
+        for transitionID in transitions {
+            guard let transition = transitionMap[transitionID],
+                  let source = index[transition.source], let target = index[transition.target] else { continue }
+            let key = min(source, target) * states.count + max(source, target)
+            let ordinal = parallel[key, default: 0]
+            parallel[key] = ordinal + 1
+            let c = centres[source]
+            let size = sizes[source]
+            if source == target {
+                let scale = 1 + 0.5 * Double(ordinal)
+                transitionLayouts[transitionID] = TransitionLayout([
+                    Point2D(c.x + size.w / 2, c.y),
+                    Point2D(c.x + size.w * scale, c.y),
+                    Point2D(c.x, c.y - size.h * scale),
+                    Point2D(c.x, c.y - size.h / 2)
+                ])
+                continue
+            }
+            let d = centres[target]
+            let (dx, dy) = (d.x - c.x, d.y - c.y)
+            let distance = max((dx * dx + dy * dy).squareRoot(), 1)
+            let isShortForward = layer[target] == layer[source] + 1
+            let bend = (isShortForward ? 0 : 0.2 * distance) + 20 * Double(ordinal)
+            let (nx, ny) = (-dy / distance * bend, dx / distance * bend)
+            let beg = outlinePoint(of: c, size: size, towards: dx, dy)
+            let end = outlinePoint(of: d, size: sizes[target], towards: -dx, -dy)
+            transitionLayouts[transitionID] = TransitionLayout([
+                beg,
+                Point2D(beg.x + (end.x - beg.x) / 3 + nx, beg.y + (end.y - beg.y) / 3 + ny),
+                Point2D(beg.x + 2 * (end.x - beg.x) / 3 + nx, beg.y + 2 * (end.y - beg.y) / 3 + ny),
+                end
+            ])
+        }
+        return (states: stateLayouts, transitions: transitionLayouts)
+    }
+}
+
+/// Assign states to layers by breadth-first search.
+///
+/// States that cannot be reached from the roots start
+/// their own search in the layer after the deepest
+/// reachable state.
+///
+/// - Parameters:
+///   - roots: The indices of the states to start from.
+///   - count: The number of states.
+///   - successors: The edges between state indices.
+/// - Returns: The layer of each state.
+func layers(roots: [Int], count: Int, successors edges: [(Int, Int)]) -> [Int] {
+    var successors = [[Int]](repeating: [], count: count)
+    for (source, target) in edges { successors[source].append(target) }
+    var layer = [Int](repeating: -1, count: count)
+    var queue = [Int]()
+    queue.reserveCapacity(count)
+    var trailing: Int?
+    for (n, root) in (roots + Array(0..<count)).enumerated() where layer[root] < 0 {
+        if n >= roots.count && trailing == nil { trailing = (layer.max() ?? -1) + 1 }
+        layer[root] = trailing ?? 0
+        queue.append(root)
+        var next = queue.count - 1
+        while next < queue.count {
+            let i = queue[next]
+            next += 1
+            for j in successors[i] where layer[j] < 0 {
+                layer[j] = layer[i] + 1
+                queue.append(j)
+            }
+        }
+    }
+    return layer
+}
+
+/// Compute the barycentres of the states in a layer.
+///
+/// The barycentre of a state is the mean position of its
+/// neighbours in the adjacent layer (or its own position
+/// if it has no such neighbours).  Large layers are
+/// processed in parallel chunks.
+///
+/// - Parameters:
+///   - states: The states of the layer.
+///   - adjacentLayer: The layer whose positions to use.
+///   - layer: The layer of each state.
+///   - position: The position of each state within its layer.
+///   - neighbours: The neighbours of each state.
+/// - Returns: The barycentre of each state in the layer.
+func barycentres(of states: [Int], adjacentLayer: Int, layer: [Int], position: [Int], neighbours: [[Int]]) -> [Double] {
+    var keys = [Double](repeating: 0, count: states.count)
+    let chunks = (states.count + layoutChunkSize - 1) / layoutChunkSize
+    keys.withUnsafeMutableBufferPointer { keys in
+        DispatchQueue.concurrentPerform(iterations: chunks) { chunk in
+            for k in (chunk * layoutChunkSize)..<min(states.count, (chunk + 1) * layoutChunkSize) {
+                let i = states[k]
+                var sum = 0
+                var n = 0
+                for j in neighbours[i] where layer[j] == adjacentLayer {
+                    sum += position[j]
+                    n += 1
+                }
+                keys[k] = n == 0 ? Double(position[i]) : Double(sum) / Double(n)
+            }
+        }
+    }
+    return keys
+}
+
+/// Return the point on the outline of an ellipse in the given direction.
+///
+/// - Parameters:
+///   - centre: The centre of the ellipse.
+///   - size: The width and height of the ellipse.
+///   - dx: The horizontal component of the direction.
+///   - dy: The vertical component of the direction.
+/// - Returns: The point where a ray from the centre crosses the outline.
+func outlinePoint(of centre: Coordinate2D, size: Dimensions2D, towards dx: Double, _ dy: Double) -> Point2D {
+    let (a, b) = (size.w / 2, size.h / 2)
+    let scale = ((dx / a) * (dx / a) + (dy / b) * (dy / b)).squareRoot()
+    guard scale > 0 else { return centre }
+    return Point2D(centre.x + dx / scale, centre.y + dy / scale)
+}
@@ -0,0 +1,332 @@
+//
+//  LLFSMExecutor.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+
+/// An action executed by an `LLFSMExecutor`.
+public typealias LLFSMAction<Context> = (inout Context) -> Void
+
+/// A transition guard evaluated by an `LLFSMExecutor`.
+public typealias LLFSMGuard<Context> = (Context) -> Bool
+
+/// The actions of a state executed by an `LLFSMExecutor`.
+public struct LLFSMStateActions<Context> {
+    /// Action executed when entering the state.
+    public var onEntry: LLFSMAction<Context>?
+    /// Action executed when leaving the state.
+    public var onExit: LLFSMAction<Context>?
+    /// Action executed when no transition fires.
+    public var `internal`: LLFSMAction<Context>?
+    /// Action executed when suspending in or to the state.
+    public var onSuspend: LLFSMAction<Context>?
+    /// Action executed when resuming from or to the state.
+    public var onResume: LLFSMAction<Context>?
+
+    /// Create the actions of a state.
+    ///
+    /// - Parameters:
+    ///   - onEntry: Action executed when entering the state.
+    ///   - onExit: Action executed when leaving the state.
+    ///   - internal: Action executed when no transition fires.
+    ///   - onSuspend: Action executed when suspending in or to the state.
+    ///   - onResume: Action executed when resuming from or to the state.
+    @inlinable
+    public init(onEntry: LLFSMAction<Context>? = nil, onExit: LLFSMAction<Context>? = nil, internal: LLFSMAction<Context>? = nil, onSuspend: LLFSMAction<Context>? = nil, onResume: LLFSMAction<Context>? = nil) {
+        self.onEntry = onEntry
+        self.onExit = onExit
+        self.internal = `internal`
+        self.onSuspend = onSuspend
+        self.onResume = onResume
+    }
+}
+
+/// In-process executor for an LLFSM.
+///
+/// This compiles an `LLFSM` into dense, index-based state
+/// and transition tables, with guards and actions supplied
+/// as Swift closures.  A ringlet has the same semantics as
+/// the generated `llfsm_execute_once()`, but does not allocate
+/// and does not dispatch through existentials.
+public struct LLFSMExecutor<Context> {
+    /// Index denoting the absence of a state.
+    public static var noState: Int { -1 }
+
+    /// The names of the states (by state index).
+    public let stateNames: ContiguousArray<StateName>
+    /// The index of the first outgoing transition of each state.
+    ///
+    /// This has one more element than there are states, so
+    /// the transitions of state `s` range from `transitionStart[s]`
+    /// up to (excluding) `transitionStart[s + 1]`.
+    @usableFromInline let transitionStart: ContiguousArray<Int>
+    /// The target state index of each transition.
+    @usableFromInline let transitionTarget: ContiguousArray<Int>
+    /// The guard of each transition.
+    @usableFromInline let guards: ContiguousArray<LLFSMGuard<Context>>
+    /// The actions of each state.
+    @usableFromInline let actions: ContiguousArray<LLFSMStateActions<Context>>
+    /// The index of the suspend state (`noState` if not suspensible).
+    public let suspendState: Int
+
+    /// The machine (and state) variables.
+    public var context: Context
+    /// The index of the current state.
+    public internal(set) var currentState = 0
+    /// The index of the state of the previous ringlet (`noState` initially).
+    public internal(set) var previousState = LLFSMExecutor.noState
+    /// The index of the state to resume (`noState` if none).
+    public internal(set) var resumeState = LLFSMExecutor.noState
+    /// The number of ringlets executed.
+    public internal(set) var ringlets = 0
+    /// The ringlet in which the current state was entered.
+    public internal(set) var stateEntryRinglet = 0
+
+    /// Compile an LLFSM into an executor.
+    ///
+    /// The first state of the machine is its initial state.
+    /// Transitions are evaluated in the order of the machine,
+    /// like in the generated `check_transitions()` code.
+    ///
+    /// - Parameters:
+    ///   - llfsm: The finite-state machine to compile.
+    ///   - context: The initial machine variables.
+    ///   - isSuspensible: Whether the machine can be suspended.
+    ///   - actions: Returns the actions for a given state.
+    ///   - guards: Returns the guard for a given transition.
+    /// - Throws: `FSMError.unknownState` if a transition or the machine refers to a non-existent state.
+    @inlinable
+    public init(compiling llfsm: LLFSM, context: Context, isSuspensible: Bool = true, actions: (State) throws -> LLFSMStateActions<Context> = { _ in LLFSMStateActions() }, guards: (Transition) throws -> LLFSMGuard<Context>) throws {
+        let states = try llfsm.states.map {
+            guard let state = llfsm.stateMap[$0] else { throw FSMError.unknownState }
+            return state
+        }
+        guard !states.isEmpty else { throw FSMError.unknownState }
+        let stateIndex = Dictionary(states.enumerated().map { ($1.id, $0) }, uniquingKeysWith: { a, _ in a })
+        var transitionStart = ContiguousArray<Int>()
+        var transitionTarget = ContiguousArray<Int>()
+        var transitionGuards = ContiguousArray<LLFSMGuard<Context>>()
+        transitionStart.reserveCapacity(states.count + 1)
+        transitionTarget.reserveCapacity(llfsm.transitions.count)
+        transitionGuards.reserveCapacity(llfsm.transitions.count)
+        let outgoing = Dictionary(grouping: llfsm.transitions.compactMap { llfsm.transitionMap[$0] }, by: \.source)
+        for state in states {
+            transitionStart.append(transitionTarget.count)
+            for transition in outgoing[state.id] ?? [] {
+                guard let target = stateIndex[transition.target] else { throw FSMError.unknownState }
+                transitionTarget.append(target)
+                transitionGuards.append(try guards(transition))
+            }
+        }
+        transitionStart.append(transitionTarget.count)
+        if isSuspensible, let suspendState = llfsm.suspendState {
+            guard let index = stateIndex[suspendState] else { throw FSMError.unknownState }
+            self.suspendState = index
+        } else {
+            suspendState = LLFSMExecutor.noState
+        }
+        self.stateNames = ContiguousArray(states.map(\.name))
+        self.transitionStart = transitionStart
+        self.transitionTarget = transitionTarget
+        self.guards = transitionGuards
+        self.actions = ContiguousArray(try states.map(actions))
+        self.context = context
+    }
+
+    /// The name of the current state.
+    @inlinable public var currentStateName: StateName { stateNames[currentState] }
+
+    /// Whether the machine is in its suspend state.
+    @inlinable public var isSuspended: Bool { suspendState != LLFSMExecutor.noState && currentState == suspendState }
+
+    /// Whether the machine has executed a ringlet in its suspend state.
+    @inlinable public var isIdle: Bool { isSuspended && previousState == currentState }
+
+    /// Whether the suspend state has outgoing transitions that can be polled.
+    @inlinable public var isPollable: Bool {
+        suspendState != LLFSMExecutor.noState && transitionStart[suspendState] != transitionStart[suspendState + 1]
+    }
+
+    /// Execute a single ringlet.
+    ///
+    /// This executes the entry (and suspend or resume)
+    /// actions if the state has changed, then evaluates
+    /// the transitions in order, and either executes the
+    /// exit action and moves to the target of the first
+    /// transition that fires, or executes the internal action.
+    @inlinable
+    public mutating func executeOnce() {
+        let current = currentState
+        if current != previousState {
+            stateEntryRinglet = ringlets
+            if suspendState != LLFSMExecutor.noState {
+                if current == suspendState {
+                    if previousState != LLFSMExecutor.noState { actions[previousState].onSuspend?(&context) }
+                    actions[current].onSuspend?(&context)
+                } else if previousState == suspendState {
+                    actions[previousState].onResume?(&context)
+                    actions[current].onResume?(&context)
+                }
+            }
+            actions[current].onEntry?(&context)
+        }
+        let target = firstEnabledTransition(from: current)
+        previousState = current
+        if target != LLFSMExecutor.noState {
+            actions[current].onExit?(&context)
+            currentState = target
+        } else {
+            actions[current].internal?(&context)
+        }
+        ringlets &+= 1
+    }
+
+    /// Execute the given number of ringlets.
+    ///
+    /// - Parameter count: The number of ringlets to execute.
+    @inlinable
+    public mutating func execute(ringlets count: Int) {
+        for _ in 0..<count { executeOnce() }
+    }
+
+    /// Poll the transitions of an idle machine.
+    ///
+    /// Like `llfsm_poll_suspended()`, this only evaluates
+    /// the transitions of the suspend state and, if one
+    /// fires, executes the exit action and moves to its target,
+    /// resuming the machine in the next ringlet.
+    @inlinable
+    public mutating func pollSuspended() {
+        let current = currentState
+        let target = firstEnabledTransition(from: current)
+        if target != LLFSMExecutor.noState {
+            actions[current].onExit?(&context)
+            currentState = target
+        }
+    }
+
+    /// Return the target of the first transition that fires.
+    ///
+    /// - Parameter state: The index of the source state.
+    /// - Returns: The index of the target state, or `noState` if no transition fires.
+    @inlinable
+    func firstEnabledTransition(from state: Int) -> Int {
+        var t = transitionStart[state]
+        let end = transitionStart[state + 1]
+        while t < end {
+            if guards[t](context) { return transitionTarget[t] }
+            t &+= 1
+        }
+        return LLFSMExecutor.noState
+    }
+
+    /// Suspend the machine (like `SUSPEND()`).
+    ///
+    /// - Returns: `true` iff the machine has a suspend state.
+    @inlinable @discardableResult
+    public mutating func suspend() -> Bool {
+        guard suspendState != LLFSMExecutor.noState else { return false }
+        if currentState != suspendState { resumeState = currentState }
+        previousState = currentState
+        currentState = suspendState
+        return true
+    }
+
+    /// Resume the machine (like `RESUME()`).
+    ///
+    /// This returns to the state the machine was suspended in,
+    /// falling back to the previous or the initial state.
+    ///
+    /// - Returns: `true` iff the machine was suspended.
+    @inlinable @discardableResult
+    public mutating func resume() -> Bool {
+        guard isSuspended else { return false }
+        if resumeState != LLFSMExecutor.noState {
+            currentState = resumeState
+        } else {
+            currentState = previousState != LLFSMExecutor.noState && previousState != suspendState ? previousState : 0
+        }
+        previousState = suspendState
+        return true
+    }
+
+    /// Restart the machine in its initial state (like `RESTART()`).
+    @inlinable
+    public mutating func restart() {
+        previousState = currentState
+        currentState = 0
+    }
+}
+
+/// In-process executor for an arrangement of LLFSMs.
+///
+/// Like the generated `fsm_arrangement_execute_once()`,
+/// each ringlet of the arrangement executes one ringlet
+/// of every machine that is not idle, polling idle
+/// machines whose suspend state has outgoing transitions.
+public struct LLFSMArrangementExecutor<Context> {
+    /// The machines of the arrangement.
+    public var machines: ContiguousArray<LLFSMExecutor<Context>>
+    /// Whether idle machines get their suspend state transitions polled.
+    public var pollsSuspended = true
+
+    /// Create an arrangement executor.
+    ///
+    /// - Parameter machines: The machines to arrange.
+    @inlinable
+    public init<Machines: Sequence>(machines: Machines) where Machines.Element == LLFSMExecutor<Context> {
+        self.machines = ContiguousArray(machines)
+    }
+
+    /// Whether all machines are idle.
+    @inlinable public var isIdle: Bool { machines.allSatisfy(\.isIdle) }
+
+    /// Execute a single ringlet of each active machine.
+    @inlinable
+    public mutating func executeOnce() {
+        var i = machines.startIndex
+        while i < machines.endIndex {
+            if !machines[i].isIdle {
+                machines[i].executeOnce()
+            } else if pollsSuspended && machines[i].isPollable {
+                machines[i].pollSuspended()
+            }
+            i &+= 1
+        }
+    }
+
+    /// Execute the arrangement for the given number of ringlets.
+    ///
+    /// - Parameter count: The number of arrangement ringlets to execute.
+    @inlinable
+    public mutating func execute(ringlets count: Int) {
+        for _ in 0..<count { executeOnce() }
+    }
+
+    /// Suspend all machines except for the given one.
+    ///
+    /// - Parameter machine: The index of the machine to keep running.
+    @inlinable
+    public mutating func suspendAll(except machine: Int = 0) {
+        for i in machines.indices where i != machine && !machines[i].isSuspended {
+            machines[i].suspend()
+        }
+    }
+
+    /// Resume all suspended machines except for the given one.
+    ///
+    /// - Parameter machine: The index of the machine to leave alone.
+    @inlinable
+    public mutating func resumeAll(except machine: Int = 0) {
+        for i in machines.indices where i != machine { machines[i].resume() }
+    }
+
+    /// Restart all machines except for the given one.
+    ///
+    /// - Parameter machine: The index of the machine to leave alone.
+    @inlinable
+    public mutating func restartAll(except machine: Int = 0) {
+        for i in machines.indices where i != machine { machines[i].restart() }
+    }
+}
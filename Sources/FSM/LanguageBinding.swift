@@ -37,6 +37,15 @@ public protocol LanguageBinding: Equatable {
     ///   - states: The states of the machine.
     /// - Returns: The target state ID of the given transition.
     func target(of transitionNumber: Int, for machineWrapper: MachineWrapper, stateName: StateName, with states: [State]) -> StateID?
+    /// Return the target state IDs of the first transitions of the given state.
+    ///
+    /// - Parameters:
+    ///   - numberOfTransitions: The number of transitions to examine.
+    ///   - machineWrapper: The machine wrapper to read from.
+    ///   - stateName: The name of the state to examine.
+    ///   - states: The states of the machine.
+    /// - Returns: The target state IDs of the transitions, in order.
+    func targets(of numberOfTransitions: Int, for machineWrapper: MachineWrapper, stateName: StateName, with states: [State]) -> [StateID?]
     /// Return the suspend state ID for the given machine.
     ///
     /// - Parameters:
@@ -80,6 +89,21 @@ public extension LanguageBinding {
     func windowLayout(for machineWrapper: MachineWrapper) -> Data? {
         machineWrapper.fileWrappers?[.windowLayout]?.regularFileContents
     }
+
+    /// Return the target state IDs of the first transitions of the given state.
+    ///
+    /// This default implementation examines each transition separately.
+    ///
+    /// - Parameters:
+    ///   - numberOfTransitions: The number of transitions to examine.
+    ///   - machineWrapper: The machine wrapper to read from.
+    ///   - stateName: The name of the state to examine.
+    ///   - states: The states of the machine.
+    /// - Returns: The target state IDs of the transitions, in order.
+    @inlinable
+    func targets(of numberOfTransitions: Int, for machineWrapper: MachineWrapper, stateName: StateName, with states: [State]) -> [StateID?] {
+        (0..<numberOfTransitions).map { target(of: $0, for: machineWrapper, stateName: stateName, with: states) }
+    }
 }
 
 /// Return the language binding for the given URL
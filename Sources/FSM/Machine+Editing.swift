@@ -0,0 +1,229 @@
+//
+//  Machine+Editing.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+import Foundation
+
+public extension LLFSM {
+    /// Append a state.
+    ///
+    /// - Parameter state: The state to add.
+    @inlinable
+    mutating func add(state: State) {
+        states.append(state.id)
+        stateMap[state.id] = state
+    }
+
+    /// Remove a state and all transitions from or to it.
+    ///
+    /// - Note: If the state is the suspend state,
+    ///         the machine will no longer be suspensible.
+    /// - Parameter stateID: The ID of the state to remove.
+    /// - Returns: The transitions that were removed.
+    @inlinable @discardableResult
+    mutating func removeState(_ stateID: StateID) -> [Transition] {
+        states.removeAll { $0 == stateID }
+        stateMap[stateID] = nil
+        if suspendState == stateID { suspendState = nil }
+        let removed = transitions.compactMap { transitionMap[$0] }.filter { $0.source == stateID || $0.target == stateID }
+        let removedIDs = Set(removed.map(\.id))
+        transitions.removeAll { removedIDs.contains($0) }
+        for transitionID in removedIDs { transitionMap[transitionID] = nil }
+        return removed
+    }
+
+    /// Append a transition.
+    ///
+    /// The transition will have the lowest priority
+    /// of all transitions from its source state.
+    ///
+    /// - Parameter transition: The transition to add.
+    @inlinable
+    mutating func add(transition: Transition) {
+        transitions.append(transition.id)
+        transitionMap[transition.id] = transition
+    }
+
+    /// Remove a transition.
+    ///
+    /// - Parameter transitionID: The ID of the transition to remove.
+    /// - Returns: The removed transition, or `nil` if not found.
+    @inlinable @discardableResult
+    mutating func removeTransition(_ transitionID: TransitionID) -> Transition? {
+        guard let transition = transitionMap.removeValue(forKey: transitionID) else { return nil }
+        transitions.removeAll { $0 == transitionID }
+        return transition
+    }
+}
+
+public extension Machine {
+    /// Add a new state to the machine.
+    ///
+    /// The state is appended, so the indices of
+    /// existing states remain unchanged, but the
+    /// machine-level files need to be regenerated.
+    ///
+    /// - Parameters:
+    ///   - name: The name of the new state.
+    ///   - boilerplate: The boilerplate (actions and variables) of the state.
+    ///   - layout: The layout of the state (defaults to the next grid position).
+    /// - Throws: `FSMError.duplicateState` if the name is already in use.
+    /// - Returns: The ID of the new state.
+    @discardableResult
+    func addState(named name: StateName, boilerplate: (any Boilerplate)? = nil, layout: StateLayout? = nil) throws -> StateID {
+        guard !llfsm.stateMap.values.contains(where: { $0.name == name }) else { throw FSMError.duplicateState }
+        let state = State(id: StateID(), name: name)
+        stateLayout[state.id] = layout ?? StateLayout(index: llfsm.states.count)
+        stateBoilerplate[state.id] = boilerplate ?? CBoilerplate()
+        llfsm.add(state: state)
+        dirtyStates.insert(state.id)
+        isStructureDirty = true
+        return state.id
+    }
+
+    /// Remove a state and all transitions from or to it.
+    ///
+    /// This shifts the indices of subsequent states,
+    /// so all generated files need to be regenerated.
+    ///
+    /// - Parameter stateID: The ID of the state to remove.
+    /// - Throws: `FSMError.unknownState` if the state is not part of the machine.
+    func removeState(_ stateID: StateID) throws {
+        guard llfsm.stateMap[stateID] != nil else { throw FSMError.unknownState }
+        for transition in llfsm.removeState(stateID) {
+            transitionLayout[transition.id] = nil
+        }
+        stateLayout[stateID] = nil
+        stateBoilerplate[stateID] = nil
+        dirtyStates.remove(stateID)
+        isStructureDirty = true
+    }
+
+    /// Rename a state.
+    ///
+    /// As generated file names are derived from state
+    /// names, this marks the machine-level files dirty.
+    ///
+    /// - Parameters:
+    ///   - stateID: The ID of the state to rename.
+    ///   - name: The new name of the state.
+    /// - Throws: `FSMError.unknownState` or `FSMError.duplicateState`.
+    func renameState(_ stateID: StateID, to name: StateName) throws {
+        guard let state = llfsm.stateMap[stateID] else { throw FSMError.unknownState }
+        guard state.name != name else { return }
+        guard !llfsm.stateMap.values.contains(where: { $0.name == name }) else { throw FSMError.duplicateState }
+        llfsm.stateMap[stateID]?.name = name
+        dirtyStates.insert(stateID)
+        isStructureDirty = true
+    }
+
+    /// Add a transition with the lowest priority of its source state.
+    ///
+    /// - Parameters:
+    ///   - label: The guard expression of the transition.
+    ///   - source: The source state of the transition.
+    ///   - target: The target state of the transition.
+    ///   - layout: The layout of the transition (if any).
+    /// - Throws: `FSMError.unknownState` if the source or target is not part of the machine.
+    /// - Returns: The ID of the new transition.
+    @discardableResult
+    func addTransition(label: Expression, from source: StateID, to target: StateID, layout: TransitionLayout? = nil) throws -> TransitionID {
+        guard llfsm.stateMap[source] != nil, llfsm.stateMap[target] != nil else { throw FSMError.unknownState }
+        let transition = Transition(label: label, source: source, target: target)
+        llfsm.add(transition: transition)
+        transitionLayout[transition.id] = layout
+        dirtyStates.insert(source)
+        isTransitionDirty = true
+        return transition.id
+    }
+
+    /// Remove a transition.
+    ///
+    /// - Parameter transitionID: The ID of the transition to remove.
+    /// - Throws: `FSMError.unknownTransition` if the transition is not part of the machine.
+    func removeTransition(_ transitionID: TransitionID) throws {
+        guard let transition = llfsm.removeTransition(transitionID) else { throw FSMError.unknownTransition }
+        transitionLayout[transitionID] = nil
+        dirtyStates.insert(transition.source)
+        isTransitionDirty = true
+    }
+
+    /// Change the target state of a transition.
+    ///
+    /// - Parameters:
+    ///   - transitionID: The ID of the transition to retarget.
+    ///   - target: The new target state.
+    /// - Throws: `FSMError.unknownTransition` or `FSMError.unknownState`.
+    func retargetTransition(_ transitionID: TransitionID, to target: StateID) throws {
+        guard let source = llfsm.transitionMap[transitionID]?.source else { throw FSMError.unknownTransition }
+        guard llfsm.stateMap[target] != nil else { throw FSMError.unknownState }
+        llfsm.transitionMap[transitionID]?.target = target
+        dirtyStates.insert(source)
+        isTransitionDirty = true
+    }
+
+    /// Change the guard expression of a transition.
+    ///
+    /// - Parameters:
+    ///   - transitionID: The ID of the transition to relabel.
+    ///   - label: The new guard expression.
+    /// - Throws: `FSMError.unknownTransition` if the transition is not part of the machine.
+    func relabelTransition(_ transitionID: TransitionID, to label: Expression) throws {
+        guard let source = llfsm.transitionMap[transitionID]?.source else { throw FSMError.unknownTransition }
+        llfsm.transitionMap[transitionID]?.label = label
+        dirtyStates.insert(source)
+        isTransitionDirty = true
+    }
+
+    /// Change the source code of a state action.
+    ///
+    /// - Parameters:
+    ///   - code: The new source code of the action.
+    ///   - action: The action to change.
+    ///   - stateID: The ID of the state containing the action.
+    /// - Throws: `FSMError.unknownState` if the state is not part of the machine.
+    func setAction(_ code: String, for action: StateActivityName, of stateID: StateID) throws {
+        guard llfsm.stateMap[stateID] != nil else { throw FSMError.unknownState }
+        var boilerplate = stateBoilerplate[stateID] ?? CBoilerplate()
+        boilerplate.setSection(named: action.rawValue, to: code)
+        stateBoilerplate[stateID] = boilerplate
+        dirtyStates.insert(stateID)
+    }
+
+    /// Regenerate the out-of-date files in the given `MachineWrapper`.
+    ///
+    /// If only states were edited, this regenerates
+    /// the boilerplate and code of the dirty states only,
+    /// as well as the machine-level tables if transition
+    /// guards or targets changed.
+    /// If states were added, removed, or renamed (i.e.,
+    /// state indices or file names changed), or the
+    /// language differs, all files are regenerated.
+    ///
+    /// - Note: The layout is only written as part of a full
+    ///         regeneration through `add(to:language:isSuspensible:)`.
+    /// - Parameters:
+    ///   - machineWrapper: The `MachineWrapper` previously written using `add(to:language:isSuspensible:)`.
+    ///   - targetLanguage: The language to use (defaults to the original language).
+    ///   - isSuspensible: Whether the FSM code will allow suspension.
+    func update(_ machineWrapper: MachineWrapper, language targetLanguage: (any LanguageBinding)? = nil, isSuspensible: Bool) throws {
+        guard let destination = (targetLanguage ?? language) as? (any OutputLanguage) else {
+            throw FSMError.unsupportedOutputFormat
+        }
+        guard !isStructureDirty && destination == language else {
+            return try add(to: machineWrapper, language: destination, isSuspensible: isSuspensible)
+        }
+        guard !dirtyStates.isEmpty else { return }
+        let stateIDs = Array(dirtyStates)
+        for stateID in stateIDs {
+            guard let stateName = llfsm.stateMap[stateID]?.name,
+                  let boilerplate = stateBoilerplate[stateID] else { continue }
+            try destination.add(stateBoilerplate: boilerplate, to: machineWrapper, for: stateName)
+        }
+        try destination.addStateFiles(for: stateIDs, of: llfsm, to: machineWrapper, isSuspensible: isSuspensible, transitionsChanged: isTransitionDirty)
+        dirtyStates.removeAll()
+        isTransitionDirty = false
+    }
+}
@@ -0,0 +1,236 @@
+//
+//  Machine+Product.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+import Foundation
+
+/// The default maximum number of states of a product machine.
+public let defaultMaximumProductStates = 256
+
+/// A state of a product machine.
+///
+/// This contains the index of the corresponding
+/// state of each component machine.
+public typealias ProductStateComponents = [Int]
+
+public extension LLFSM {
+    /// Compose the given LLFSMs into their synchronous product.
+    ///
+    /// In each ringlet, the product machine takes every transition
+    /// the component machines would take in that ringlet.
+    /// A product transition therefore is guarded by the conjunction
+    /// of the chosen component transitions with the negation of all
+    /// higher-priority transitions of the same component.
+    /// Product states are created lazily, i.e. only the states reachable
+    /// from the initial (and suspend) state of the product are created.
+    ///
+    /// - Parameters:
+    ///   - fsms: The component machines.
+    ///   - maxStates: The maximum number of product states to create.
+    /// - Throws: `FSMError.productTooLarge` if `maxStates` is exceeded.
+    /// - Returns: The product LLFSM and the component states of each product state.
+    static func product(of fsms: [LLFSM], maxStates: Int = defaultMaximumProductStates) throws -> (fsm: LLFSM, components: [StateID : ProductStateComponents]) {
+        let componentTransitions = fsms.map { fsm in
+            fsm.states.map { fsm.transitionsFrom($0).compactMap { fsm.transitionMap[$0] } }
+        }
+        let initial = fsms.map { $0.states.firstIndex(of: $0.initialState) ?? 0 }
+        let suspend: ProductStateComponents? = fsms.allSatisfy { $0.suspendState != nil } ? fsms.compactMap { fsm in
+            fsm.suspendState.flatMap { fsm.states.firstIndex(of: $0) }
+        } : nil
+        var states = [State]()
+        var stateIDs = [ProductStateComponents : StateID]()
+        var components = [StateID : ProductStateComponents]()
+        var transitions = [Transition]()
+        var queue = [ProductStateComponents]()
+        func add(_ product: ProductStateComponents) throws -> StateID {
+            if let id = stateIDs[product] { return id }
+            guard states.count < maxStates else { throw FSMError.productTooLarge }
+            let name = zip(fsms, product).compactMap { fsm, i in
+                fsm.stateMap[fsm.states[i]]?.name
+            }.joined(separator: "__")
+            let state = State(id: StateID(), name: name)
+            states.append(state)
+            stateIDs[product] = state.id
+            components[state.id] = product
+            queue.append(product)
+            return state.id
+        }
+        _ = try add(initial)
+        if let suspend { _ = try add(suspend) }
+        var next = 0
+        while next < queue.count {
+            let source = queue[next]
+            next += 1
+            guard let sourceID = stateIDs[source] else { continue }
+            let outgoing = zip(componentTransitions, source).map { $0[$1] }
+            for choice in cartesianProduct(of: outgoing.map(reachableChoices)) where choice.contains(where: { $0 != nil }) {
+                let target = fsms.indices.map { k -> Int in
+                    guard let c = choice[k] else { return source[k] }
+                    return fsms[k].states.firstIndex(of: outgoing[k][c].target) ?? source[k]
+                }
+                let label = fsms.indices.compactMap {
+                    productGuard(for: outgoing[$0], choice: choice[$0])
+                }.joined(separator: " && ")
+                let targetID = try add(target)
+                transitions.append(Transition(label: label.isEmpty ? "true" : label, source: sourceID, target: targetID))
+            }
+        }
+        return (fsm: LLFSM(states: states, transitions: transitions, suspendState: suspend.flatMap { stateIDs[$0] }), components: components)
+    }
+}
+
+public extension Machine {
+    /// Create the synchronous product of the given machines.
+    ///
+    /// The component actions are merged into the product states
+    /// as follows: the onEntry action of a component only runs
+    /// if the component state changed (tracked through a
+    /// `product_<component>_state` machine variable);
+    /// the onExit action of the product state re-evaluates the
+    /// component guards to run either the onExit or the internal
+    /// action of each component; the internal action of the product
+    /// state runs the internal actions of all components.
+    ///
+    /// - Note: Component guards need to be free of side effects
+    ///         and component actions must not return early.
+    ///         Variables of different components must not clash.
+    /// - Parameters:
+    ///   - components: The names and machines to compose.
+    ///   - maxStates: The maximum number of product states.
+    /// - Throws: `FSMError.productTooLarge` if `maxStates` is exceeded.
+    convenience init(productOf components: [(name: String, machine: Machine)], maxStates: Int = defaultMaximumProductStates) throws {
+        self.init()
+        let product = try LLFSM.product(of: components.map(\.machine.llfsm), maxStates: maxStates)
+        language = components.first?.machine.language ?? CBinding()
+        llfsm = product.fsm
+        boilerplate = productBoilerplate(of: components)
+        let layout = llfsm.layeredLayout()
+        stateLayout = layout.states
+        transitionLayout = layout.transitions
+        for stateID in llfsm.states {
+            guard let indices = product.components[stateID] else { continue }
+            stateBoilerplate[stateID] = productStateBoilerplate(of: components, states: indices)
+        }
+    }
+}
+
+/// Return the choices of transitions a component can take in a ringlet.
+///
+/// - Note: A transition whose guard is literally `true`
+///         prunes all lower-priority choices.
+/// - Parameter transitions: The transitions leaving the component state.
+/// - Returns: The indices of the reachable transitions, `nil` denoting no transition.
+func reachableChoices(of transitions: [Transition]) -> [Int?] {
+    var choices = [Int?]()
+    for (i, transition) in transitions.enumerated() {
+        choices.append(i)
+        if isTautology(transition.label) { return choices }
+    }
+    return choices + [nil]
+}
+
+/// Return the guard of a component choice.
+///
+/// - Parameters:
+///   - transitions: The transitions leaving the component state.
+///   - choice: The chosen transition (`nil` if no transition).
+/// - Returns: The guard expression or `nil` if the choice is unconditional.
+func productGuard(for transitions: [Transition], choice: Int?) -> Expression? {
+    let negated = transitions.prefix(choice ?? transitions.count).map { "!(" + $0.label.trimmed + ")" }
+    let chosen = choice.flatMap { isTautology(transitions[$0].label) ? nil : "(" + transitions[$0].label.trimmed + ")" }
+    let conjuncts = negated + (chosen.map { [$0] } ?? [])
+    return conjuncts.isEmpty ? nil : conjuncts.joined(separator: " && ")
+}
+
+/// Return whether the given expression is literally true.
+///
+/// - Parameter expression: The expression to examine.
+/// - Returns: `true` iff the expression is `true` or `1`.
+func isTautology(_ expression: Expression) -> Bool {
+    let e = expression.trimmed
+    return e == "true" || e == "1"
+}
+
+/// Return the cartesian product of the given choices.
+///
+/// - Parameter choices: The choices for each position.
+/// - Returns: All combinations, varying the last position fastest.
+func cartesianProduct<Element>(of choices: [[Element]]) -> [[Element]] {
+    choices.reduce([[]]) { combinations, options in
+        combinations.flatMap { combination in options.map { combination + [$0] } }
+    }
+}
+
+/// Return the C machine boilerplate of a product machine.
+///
+/// - Parameter components: The names and machines to compose.
+/// - Returns: The combined boilerplate.
+func productBoilerplate(of components: [(name: String, machine: Machine)]) -> CBoilerplate {
+    var boilerplate = CBoilerplate()
+    let sections = { (section: CBoilerplate.SectionName) in
+        components.map { $0.machine.boilerplate.getSection(named: section.rawValue) }
+    }
+    boilerplate.sections[.includePath] = uniqueLines(of: sections(.includePath))
+    boilerplate.sections[.includes] = uniqueLines(of: sections(.includes))
+    boilerplate.sections[.variables] = (zip(components, sections(.variables)).map { component, variables in
+        "// " + component.name + "\n" + variables.trimmed
+    } + components.map { component in
+        "uintptr_t product_" + component.name.lowercased() + "_state; ///< 1 + index of the entered \(component.name) state"
+    }).joined(separator: "\n") + "\n"
+    boilerplate.sections[.functions] = sections(.functions).map(\.trimmed).filter(nonempty).joined(separator: "\n") + "\n"
+    return boilerplate
+}
+
+/// Return the C state boilerplate of a product state.
+///
+/// - Parameters:
+///   - components: The names and machines to compose.
+///   - indices: The component state indices of the product state.
+/// - Returns: The combined boilerplate.
+func productStateBoilerplate(of components: [(name: String, machine: Machine)], states indices: ProductStateComponents) -> CBoilerplate {
+    let states = zip(components, indices).map { component, i in
+        (name: component.name, machine: component.machine, index: i, id: component.machine.llfsm.states[i])
+    }
+    let sections = { (section: CBoilerplate.SectionName) in
+        states.map { $0.machine.stateBoilerplate[$0.id]?.getSection(named: section.rawValue).trimmed ?? "" }
+    }
+    var boilerplate = CBoilerplate()
+    boilerplate.sections[.includePath] = uniqueLines(of: sections(.includePath))
+    boilerplate.sections[.includes] = uniqueLines(of: sections(.includes))
+    boilerplate.sections[.variables] = sections(.variables).filter(nonempty).joined(separator: "\n") + "\n"
+    boilerplate.sections[.functions] = sections(.functions).filter(nonempty).joined(separator: "\n") + "\n"
+    boilerplate.sections[.onEntry] = zip(states, sections(.onEntry)).map { state, onEntry in
+        let variable = "machine->product_" + state.name.lowercased() + "_state"
+        return "if (\(variable) != \(state.index + 1))\n{\n\(variable) = \(state.index + 1);\n" + onEntry + "\n}"
+    }.joined(separator: "\n") + "\n"
+    let fired = states.map { state -> String? in
+        let guards = state.machine.llfsm.transitionsFrom(state.id).compactMap {
+            state.machine.llfsm.transitionMap[$0].map { "(" + $0.label.trimmed + ")" }
+        }
+        return guards.isEmpty ? nil : guards.joined(separator: " || ")
+    }
+    boilerplate.sections[.onExit] = (zip(states, fired).compactMap { state, fired in
+        fired.map { "const bool product_" + state.name.lowercased() + "_fired = " + $0 + ";" }
+    } + zip(zip(states, fired), zip(sections(.onExit), sections(.internal))).map { component, actions in
+        let (state, fired) = component
+        guard fired != nil else { return "{\n" + actions.1 + "\n}" }
+        return "if (product_" + state.name.lowercased() + "_fired)\n{\n" + actions.0 + "\n}\nelse\n{\n" + actions.1 + "\n}"
+    }).joined(separator: "\n") + "\n"
+    for section in [CBoilerplate.SectionName.internal, .onSuspend, .onResume] {
+        boilerplate.sections[section] = sections(section).filter(nonempty).map { "{\n" + $0 + "\n}" }.joined(separator: "\n") + "\n"
+    }
+    return boilerplate
+}
+
+/// Return the unique, non-empty lines of the given code sections.
+///
+/// - Parameter sections: The sections to merge.
+/// - Returns: The merged lines in order of first appearance.
+func uniqueLines(of sections: [String]) -> String {
+    var seen = Set<String>()
+    return sections.flatMap(\.lines).filter { line in
+        !line.trimmed.isEmpty && seen.insert(line.trimmed).inserted
+    }.joined(separator: "\n") + "\n"
+}
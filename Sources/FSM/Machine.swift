@@ -43,6 +43,12 @@ public class Machine {
     public var stateBoilerplate: [StateID : any Boilerplate]
     /// Source code of OnEntry/OnExit/Internal actions of states
     public var activities: StateActivitiesSourceCode
+    /// States whose generated files are out of date
+    public var dirtyStates = Set<StateID>()
+    /// Indicates whether machine-level files are out of date
+    public var isStructureDirty = false
+    /// Indicates whether transition guards or targets are out of date
+    public var isTransitionDirty = false
     
     /// Constructor for reading an FSM from a given URL.
     ///
@@ -89,8 +95,19 @@ public class Machine {
         }
         //
         // convert mapping from name ot layout to mapping from ID to layout
-        // using default grid layout for states at position (0,0)
+        // using an automatic layered layout for states at position (0,0),
+        // placed below all states with a saved position
         //
+        var savedLayouts = [StateID : StateLayout]()
+        for state in states {
+            guard let saved = namesLayout[state.name]?.state,
+                  saved.closedLayout.x != 0 || saved.closedLayout.y != 0 else { continue }
+            savedLayouts[state.id] = saved
+        }
+        let savedBottom = savedLayouts.values.map {
+            max($0.closedLayout.y + $0.closedLayout.h, $0.openLayout.y + $0.openLayout.h)
+        }.max() ?? 0
+        let automaticLayout = savedLayouts.count == states.count ? nil : llfsm.layeredLayout(top: savedBottom)
         transitionLayout = [:]
         stateLayout = [:]
         stateBoilerplate = [:]
@@ -98,7 +115,7 @@ public class Machine {
             let state = si.element
             let boilerplate = language.stateBoilerplate(for: machineWrapper, stateName: state.name)
             stateBoilerplate[state.id] = boilerplate
-            let gridLayout = StateLayout(index: si.offset)
+            let gridLayout = automaticLayout?.states[state.id] ?? StateLayout(index: si.offset)
             let layoutsForName = namesLayout[state.name]
             var layout = layoutsForName?.state ?? gridLayout
             if layout.closedLayout.x == 0 && layout.closedLayout.y == 0 {
@@ -111,6 +128,11 @@ public class Machine {
             }
             stateLayout[state.id] = layout
             let stateTransitionIDs = transitionMap[state.id] ?? []
+            if layoutsForName == nil, let automaticLayout {
+                for transitionID in stateTransitionIDs where llfsm.transitionMap[transitionID].map({ savedLayouts[$0.target] == nil }) ?? false {
+                    transitionLayout[transitionID] = automaticLayout.transitions[transitionID]
+                }
+            }
             for te in (layoutsForName?.transitions ?? []).enumerated() {
                 guard stateTransitionIDs.count > te.offset else {
                     fputs("Layout \(te.offset + 1) ignored: State \(state.name) only has \(stateTransitionIDs.count) transitions\n", stderr)
@@ -176,6 +198,8 @@ public class Machine {
     /// `MachineWrapper`.
     /// Optionally, a language binding can be specified,
     /// that will write the FSM using the given binding.
+    /// The generated files are staged and then committed
+    /// to the `MachineWrapper` in bulk.
     ///
     /// - Parameters:
     ///   - machineWrapper: The `MachineWrapper` to add the FSM to.
@@ -188,33 +212,40 @@ public class Machine {
         if destination != language {
             machineWrapper.removeFileWrappers()
         }
-        try destination.addLanguage(to: machineWrapper)
-        try destination.add(boilerplate: boilerplate, to: machineWrapper)
-        try destination.add(windowLayout: windowLayout, to: machineWrapper)
-        try destination.add(stateNames: llfsm.states.map { llfsm.stateMap[$0]!.name }, to: machineWrapper)
-        try destination.addInterface(for: llfsm, to: machineWrapper, isSuspensible: isSuspensible)
-        try destination.addCode(for: llfsm, to: machineWrapper, isSuspensible: isSuspensible)
-        try destination.addStateInterface(for: llfsm, to: machineWrapper, isSuspensible: isSuspensible)
-        try destination.addStateCode(for: llfsm, to: machineWrapper, isSuspensible: isSuspensible)
-        try destination.addTransitionCode(for: llfsm, to: machineWrapper, isSuspensible: isSuspensible)
-        for stateID in llfsm.states {
-            guard let stateName = llfsm.stateMap[stateID]?.name,
-                  let boilerplate = stateBoilerplate[stateID] else {
-                fputs("Orphaned state \(stateID) for \(machineWrapper.name)\n", stderr)
-                continue
+        try machineWrapper.buildFileWrappers { wrapper in
+            try destination.addLanguage(to: wrapper)
+            try destination.add(boilerplate: boilerplate, to: wrapper)
+            try destination.add(windowLayout: windowLayout, to: wrapper)
+            try destination.add(stateNames: llfsm.states.map { llfsm.stateMap[$0]!.name }, to: wrapper)
+            try destination.addInterface(for: llfsm, to: wrapper, isSuspensible: isSuspensible)
+            try destination.addCode(for: llfsm, to: wrapper, isSuspensible: isSuspensible)
+            try destination.addStateInterface(for: llfsm, to: wrapper, isSuspensible: isSuspensible)
+            try destination.addTransitionCode(for: llfsm, to: wrapper, isSuspensible: isSuspensible)
+            for stateID in llfsm.states {
+                guard let stateName = llfsm.stateMap[stateID]?.name,
+                      let boilerplate = stateBoilerplate[stateID] else {
+                    fputs("Orphaned state \(stateID) for \(wrapper.name)\n", stderr)
+                    continue
+                }
+                try destination.add(stateBoilerplate: boilerplate, to: wrapper, for: stateName)
             }
-            try destination.add(stateBoilerplate: boilerplate, to: machineWrapper, for: stateName)
-        }
-        try destination.addCMakeFile(for: llfsm, boilerplate: boilerplate, to: machineWrapper, isSuspensible: isSuspensible)
-        var layouts = StateNameLayouts()
-        for (stateID, layout) in stateLayout {
-            guard let state = llfsm.stateMap[stateID] else { continue }
-            let tl = llfsm.transitionsFrom(stateID).compactMap {
-                transitionLayout[$0]
+            try destination.addStateCode(for: llfsm, to: wrapper, isSuspensible: isSuspensible)
+            try destination.addModuleCode(for: llfsm, to: wrapper, isSuspensible: isSuspensible)
+            try destination.addBatchCode(for: llfsm, to: wrapper, isSuspensible: isSuspensible)
+            try destination.addCMakeFile(for: llfsm, boilerplate: boilerplate, to: wrapper, isSuspensible: isSuspensible)
+            var layouts = StateNameLayouts()
+            for (stateID, layout) in stateLayout {
+                guard let state = llfsm.stateMap[stateID] else { continue }
+                let tl = llfsm.transitionsFrom(stateID).compactMap {
+                    transitionLayout[$0]
+                }
+                layouts[state.name] = (state: layout, transitions: tl)
             }
-            layouts[state.name] = (state: layout, transitions: tl)
+            try destination.add(layout: layouts, to: wrapper)
         }
-        try destination.add(layout: layouts, to: machineWrapper)
+        if !dirtyStates.isEmpty { dirtyStates.removeAll() }
+        if isStructureDirty { isStructureDirty = false }
+        if isTransitionDirty { isTransitionDirty = false }
     }
 }
 
@@ -349,7 +380,8 @@ public func dictionary(from layouts: StateNameLayouts) -> NSDictionary {
 ///
 /// This function returns a function that takes a state and
 /// reads in the transitions for that state from the given machine
-/// file wrapper.
+/// file wrapper.  As every transition has its own expression file,
+/// the number of transitions is capped by the number of files.
 ///
 /// - Parameters:
 ///   - machineWrapper: The MachineWrapper to examine.
@@ -360,10 +392,10 @@ public func dictionary(from layouts: StateNameLayouts) -> NSDictionary {
 func transitions(for machineWrapper: MachineWrapper, with states: [State], using language: any LanguageBinding = ObjCPPBinding()) -> (State) -> [Transition] {
     return { (state: State) -> [Transition] in
         let sourceID = state.id
-        let n = language.numberOfTransitions(for: machineWrapper, stateName: state.name)
-        let transitionIndices = (0..<n).enumerated()
-        let transitions = transitionIndices.map { i, _ -> Transition in
-            let targetID = language.target(of: i, for: machineWrapper, stateName: state.name, with: states) ?? StateID(uuid: UUID_NULL)
+        let n = min(language.numberOfTransitions(for: machineWrapper, stateName: state.name), machineWrapper.fileWrappers?.count ?? 0)
+        let targets = language.targets(of: n, for: machineWrapper, stateName: state.name, with: states)
+        let transitions = targets.enumerated().map { i, target -> Transition in
+            let targetID = target ?? StateID(uuid: UUID_NULL)
             return Transition(id: TransitionID(), label: language.expression(of: i, for: machineWrapper, stateName: state.name), source: sourceID, target: targetID)
         }
         return transitions
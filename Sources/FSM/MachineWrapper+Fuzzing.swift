@@ -0,0 +1,54 @@
+//
+//  MachineWrapper+Fuzzing.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+import Foundation
+
+public extension MachineWrapper {
+    /// Create a machine wrapper from fuzzer input.
+    ///
+    /// The input is a flat list of files, consisting of alternating file names and
+    /// file contents, each terminated by a NUL byte (the last
+    /// terminator is optional).  Later files replace earlier
+    /// files of the same name.
+    ///
+    /// - Parameters:
+    ///   - data: The files to unpack.
+    ///   - name: The preferred file name of the machine.
+    convenience init(fuzzInput data: Data, named name: String = "Machine.machine") {
+        var children = [String : FileWrapper]()
+        let fields = data.split(separator: 0, omittingEmptySubsequences: false)
+        var fieldIndex = fields.startIndex
+        while fieldIndex < fields.endIndex {
+            let filename = String(decoding: fields[fieldIndex], as: UTF8.self)
+            let contentIndex = fields.index(after: fieldIndex)
+            let contents = contentIndex < fields.endIndex ? Data(fields[contentIndex]) : Data()
+            if !filename.isEmpty && !filename.contains("/") {
+                let child = FileWrapper(regularFileWithContents: contents)
+                child.preferredFilename = filename
+                children[filename] = child
+            }
+            fieldIndex = min(fields.index(after: contentIndex), fields.endIndex)
+        }
+        self.init(directoryWithFileWrappers: children, for: Machine(), named: name)
+        filename = name
+    }
+}
+
+/// Fuzz entry point for parsing a machine.
+///
+/// This unpacks the given data as the files of a
+/// machine wrapper (see `MachineWrapper.init(fuzzInput:named:)`)
+/// and reads the machine from it.  Parsing must neither
+/// crash nor take more than linear time in the size of
+/// the input.
+///
+/// - Parameter data: The fuzzer-generated input.
+/// - Returns: The machine read from the input, or `nil` on error.
+@discardableResult
+public func fuzzMachineWrapper(_ data: Data) -> Machine? {
+    let wrapper = MachineWrapper(fuzzInput: data)
+    return try? Machine(from: wrapper)
+}
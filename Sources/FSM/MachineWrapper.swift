@@ -14,20 +14,35 @@ open class MachineWrapper: DirectoryWrapper {
     public var language: any LanguageBinding
     /// Whether or onot the machine is suspensible
     public var isSuspensible = true
+    /// Whether or not to generate static introspection tables
+    public var isIntrospectable = false
+    /// Whether or not to generate a table-driven executor
+    /// instead of functions for each state
+    public var isTableDriven = false
+    /// Whether or not to place USDT probes for tracing
+    public var isTraceable = false
+    /// Whether or not to inline guards and actions
+    /// instead of including them
+    public var isInlined = false
+    /// Batchability of the machine states,
+    /// cached for incremental updates
+    public var batchAnalysis: BatchAnalysis?
 
     /// Initialiser for reading from a URL.
     ///
     ///This initialiser sets up a file wrapper for  reading from the given URL.
+    /// The URL may refer to a machine directory or to a
+    /// (`.tar`, `.tar.zst`, or `.tzst`) archive containing one.
     /// - Parameters:
     ///   - url: The URL to read from.
     ///   - options: The reading options to use.
     /// - Throws: Any error thrown by the underlying file system.
     public override init(url: URL, options: ReadingOptions = []) throws {
-        let temporaryWrapper = try FileWrapper(url: url, options: options)
+        let (name, children) = try directoryContents(at: url, options: options)
         machine = Machine()
         language = machine.language
-        super.init(directoryWithFileWrappers: temporaryWrapper.fileWrappers ?? [:])
-        preferredFilename = url.lastPathComponent
+        super.init(directoryWithFileWrappers: children)
+        preferredFilename = name
         filename = url.lastPathComponent
         machine = try Machine(from: self)
         language = machine.language
@@ -36,17 +51,19 @@ open class MachineWrapper: DirectoryWrapper {
     /// Designated initialiser for reading from a URL.
     ///
     ///This initialiser sets up a file wrapper for  reading from the given URL.
+    /// The URL may refer to a machine directory or to a
+    /// (`.tar`, `.tar.zst`, or `.tzst`) archive containing one.
     /// - Parameters:
     ///   - url: The URL to read from.
     ///   - options: The reading options to use.
     /// - Throws: Any error thrown by the underlying file system.
     @inlinable
     public init(for machine: Machine, url: URL, options: ReadingOptions = []) throws {
-        let temporaryWrapper = try FileWrapper(url: url, options: options)
+        let (name, children) = try directoryContents(at: url, options: options)
         self.machine = machine
         self.language = machine.language
-        super.init(directoryWithFileWrappers: temporaryWrapper.fileWrappers ?? [:])
-        preferredFilename = url.lastPathComponent
+        super.init(directoryWithFileWrappers: children)
+        preferredFilename = name
         filename = url.lastPathComponent
     }
 
@@ -73,6 +90,9 @@ open class MachineWrapper: DirectoryWrapper {
     /// Write the content of the machine to the specified location.
     ///
     /// Recursively writes the entire machine to the specified location.
+    /// If the URL has a `.tar`, `.tar.zst`, or `.tzst` extension,
+    /// the generated machine directory is streamed into a single
+    /// (compressed) archive instead.
     ///
     /// - Note: This requires that the `language` is a valid output language.
     /// - Parameters:
@@ -83,9 +103,40 @@ open class MachineWrapper: DirectoryWrapper {
         guard let destination = language as? (any OutputLanguage) else {
             throw FSMError.unsupportedOutputFormat
         }
-        directoryName = url.lastPathComponent
+        let format = ArchiveFormat(url: url)
+        let name = ArchiveFormat.directoryName(of: url)
+        directoryName = name
         try machine.add(to: self, language: destination, isSuspensible: isSuspensible)
-        try super.write(to: url, options: options, originalContentsURL: originalContentsURL)
+        if let format {
+            try writeArchive(to: url, format: format, named: name)
+        } else {
+            try super.write(to: url, options: options, originalContentsURL: originalContentsURL)
+        }
         filename = url.lastPathComponent
     }
+
+    /// Add generated children in bulk.
+    ///
+    /// This runs the given body against an empty staging
+    /// wrapper with the same name and generation options,
+    /// whose children are inserted in place, and then commits
+    /// all staged children to the receiver in a single update.
+    ///
+    /// - Parameter body: The body adding children to the staging wrapper.
+    /// - Returns: The result of the body.
+    @inlinable
+    public func buildFileWrappers<Result>(_ body: (MachineWrapper) throws -> Result) rethrows -> Result {
+        let staging = MachineWrapper(for: machine, named: preferredFilename)
+        staging.filename = filename
+        staging._preferredDirectoryName = _preferredDirectoryName
+        staging.language = language
+        staging.isSuspensible = isSuspensible
+        staging.isIntrospectable = isIntrospectable
+        staging.isTableDriven = isTableDriven
+        staging.isTraceable = isTraceable
+        staging.isInlined = isInlined
+        let result = try body(staging)
+        replaceFileWrappers(staging.fileWrappers ?? [:])
+        return result
+    }
 }
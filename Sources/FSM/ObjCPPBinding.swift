@@ -47,6 +47,19 @@ public struct ObjCPPBinding: LanguageBinding {
         targetOfObjCPPTransition(transitionNumber, state: stateName, for: machineWrapper, with: states)
     }
 
+    /// Objective-C++ binding from URL, states, and source state name to the targets of its transitions.
+    ///
+    /// - Parameters:
+    ///   - numberOfTransitions: The number of transitions to examine.
+    ///   - machineWrapper: The MachineWrapper to examine.
+    ///   - stateName: The name of the state to examine.
+    ///   - states: The states of the machine.
+    /// - Returns: The target state IDs of the transitions, in order.
+    @inlinable
+    public func targets(of numberOfTransitions: Int, for machineWrapper: MachineWrapper, stateName: StateName, with states: [State]) -> [StateID?] {
+        targetsOfObjCPPTransitions(numberOfTransitions, state: stateName, for: machineWrapper, with: states)
+    }
+
     /// Objective-C++ binding from URL, states to suspend state ID.
     ///
     /// - Parameters:
@@ -119,9 +132,7 @@ public struct ObjCPPBinding: LanguageBinding {
 /// - Returns: The number of transitions in the given state.
 @inlinable
 public func numberOfObjCPPTransitionsIn(header content: String) -> Int {
-    guard let numString = string(containedIn: content, matching: #/numberOfTransitions.*return[^0-9]*([0-9][0-9]*)/#),
-          let numberOfTransitions = Int(numString) else { return 0 }
-    return numberOfTransitions
+    integer(following: ["numberOfTransitions", "return"], in: content) ?? 0
 }
 
 
@@ -133,9 +144,7 @@ public func numberOfObjCPPTransitionsIn(header content: String) -> Int {
 /// - Returns:
 @inlinable
 public func targetStateIndexOfObjCPPTransition(_ i: Int, inHeader content: String) -> Int? {
-    guard let numString = string(containedIn: content, matching: try! Regex("Transition_\(i).*int.*toState.*=[^0-9]*([0-9]*)")),
-          let targetStateIndex = Int(numString) else { return nil }
-    return targetStateIndex
+    integer(following: ["Transition_\(i)", "int", "toState", "="], in: content)
 }
 
 
@@ -241,6 +250,24 @@ public func targetOfObjCPPTransitionFor(machine m: URL, states: [State], state n
     return targetState.id
 }
 
+/// Return the target state IDs for the first transitions of a given state
+///
+/// This reads and scans the `State.h` file only once.
+///
+/// - Parameters:
+///   - count: The number of transitions to examine.
+///   - name: The name of the state to search for.
+///   - machineWrapper: The MachineWrapper to examine.
+///   - states: Array of states to examine.
+/// - Returns: The State IDs (or `nil` for transitions without a valid target).
+@inlinable
+public func targetsOfObjCPPTransitions(_ count: Int, state name: StateName, for machineWrapper: MachineWrapper, with states: [State]) -> [StateID?] {
+    let indices = contentOfObjCPPState(for: machineWrapper, state: name).map { transitionTargetIndices(inHeader: $0) } ?? [:]
+    return (0..<count).map { number in
+        indices[number].flatMap { $0 >= 0 && $0 < states.count ? states[$0].id : nil }
+    }
+}
+
 /// Return the target state ID for a given transition
 /// - Parameters:
 ///   - number:The sequence number of the transition to examine.
@@ -113,6 +113,47 @@ public protocol OutputLanguage: LanguageBinding {
     ///   - wrapper: The `MachineWrapper` to add to.
     ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
     func addTransitionCode(for fsm: LLFSM, to wrapper: MachineWrapper, isSuspensible: Bool) throws
+    /// Write the files for the given states of an LLFSM.
+    ///
+    /// This method regenerates the state interface, state code,
+    /// and transition expressions of the given states only,
+    /// together with any machine-level code that depends on
+    /// their transitions or actions.  It is used for
+    /// incremental updates where state indices have not shifted,
+    /// i.e., the machine interface and code are unaffected.
+    ///
+    /// - Parameters:
+    ///   - stateIDs: The states whose files to regenerate.
+    ///   - llfsm: The finite-state machine containing the states.
+    ///   - wrapper: The `MachineWrapper` to add to.
+    ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+    ///   - transitionsChanged: Indicates whether any transition guards or targets were edited.
+    func addStateFiles(for stateIDs: [StateID], of fsm: LLFSM, to wrapper: MachineWrapper, isSuspensible: Bool, transitionsChanged: Bool) throws
+    /// Write the dynamically loadable module code for the given LLFSM.
+    ///
+    /// This method adds the code (if any) that allows
+    /// the given finite-state machine to be built as
+    /// a module that can be reloaded at runtime.
+    /// It gets called after all machine and state
+    /// boilerplate has been added.
+    ///
+    /// - Parameters:
+    ///   - llfsm: The finite-state machine to add.
+    ///   - wrapper: The `MachineWrapper` to add to.
+    ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+    func addModuleCode(for fsm: LLFSM, to wrapper: MachineWrapper, isSuspensible: Bool) throws
+    /// Write the batch executor code for the given LLFSM.
+    ///
+    /// This method adds the code (if any) that executes
+    /// many instances of the given finite-state machine
+    /// in lockstep.  It gets called after all machine and
+    /// state boilerplate has been added.
+    ///
+    /// - Parameters:
+    ///   - llfsm: The finite-state machine to add.
+    ///   - wrapper: The `MachineWrapper` to add to.
+    ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+    func addBatchCode(for fsm: LLFSM, to wrapper: MachineWrapper, isSuspensible: Bool) throws
     /// Write the arrangment implementation to the given URL.
     ///
     /// This method adds the arrangement code (if any)
@@ -224,6 +265,23 @@ public extension OutputLanguage {
         fileWrapper.preferredFilename = .states
         wrapper.replaceFileWrapper(fileWrapper)
     }
+    /// Default state file creator.
+    ///
+    /// This default implementation regenerates the
+    /// files for all states of the given LLFSM.
+    ///
+    /// - Parameters:
+    ///   - stateIDs: The states whose files to regenerate.
+    ///   - llfsm: The finite-state machine containing the states.
+    ///   - wrapper: The `MachineWrapper` to create the file wrapper at.
+    ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+    ///   - transitionsChanged: Indicates whether any transition guards or targets were edited.
+    @inlinable
+    func addStateFiles(for stateIDs: [StateID], of fsm: LLFSM, to wrapper: MachineWrapper, isSuspensible: Bool, transitionsChanged: Bool) throws {
+        try addStateInterface(for: fsm, to: wrapper, isSuspensible: isSuspensible)
+        try addStateCode(for: fsm, to: wrapper, isSuspensible: isSuspensible)
+        try addTransitionCode(for: fsm, to: wrapper, isSuspensible: isSuspensible)
+    }
     /// Default do-nothing CMakefile creator.
     ///
     /// - Parameters:
@@ -232,4 +290,20 @@ public extension OutputLanguage {
     ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
     @inlinable
     func addCMakeFile(for fsm: LLFSM, to wrapper: MachineWrapper, isSuspensible: Bool) throws {}
+    /// Default do-nothing module code creator.
+    ///
+    /// - Parameters:
+    ///   - llfsm: The finite-state machine to add.
+    ///   - wrapper: The `MachineWrapper` to create the file wrapper at.
+    ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+    @inlinable
+    func addModuleCode(for fsm: LLFSM, to wrapper: MachineWrapper, isSuspensible: Bool) throws {}
+    /// Default do-nothing batch executor creator.
+    ///
+    /// - Parameters:
+    ///   - llfsm: The finite-state machine to add.
+    ///   - wrapper: The `MachineWrapper` to create the file wrapper at.
+    ///   - isSuspensible: Indicates whether code for suspensible machines should be generated.
+    @inlinable
+    func addBatchCode(for fsm: LLFSM, to wrapper: MachineWrapper, isSuspensible: Bool) throws {}
 }
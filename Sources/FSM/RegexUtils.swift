@@ -17,3 +17,201 @@ import Foundation
 func string(containedIn content: String, matching expr: Regex<(Substring,Substring)>) -> Substring? {
     try? expr.firstMatch(in: content)?.1
 }
+
+#if DEBUG
+/// A thread-safe count of the bytes examined by the header scanners.
+///
+/// Tests compare the count for inputs of different sizes
+/// to check that scanning takes linear time, independent
+/// of the speed and load of the machine running them.
+/// The counter only exists in debug builds, so release
+/// builds do not take a global lock while parsing.
+final class ScanCounter {
+    /// Protects `total`.
+    private let lock = NSLock()
+    /// The number of bytes examined so far.
+    private var total = 0
+
+    /// The number of bytes examined so far.
+    var value: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return total
+    }
+
+    /// Record the given number of examined bytes.
+    ///
+    /// - Parameter count: The number of bytes examined.
+    func add(_ count: Int) {
+        lock.lock()
+        total += count
+        lock.unlock()
+    }
+}
+
+/// The number of bytes examined by the header scanners.
+let scannedBytes = ScanCounter()
+#endif
+
+/// Record the number of bytes examined by a header scanner.
+///
+/// This does nothing in release builds.
+///
+/// - Parameter count: The number of bytes examined.
+@inline(__always)
+func recordScannedBytes(_ count: Int) {
+#if DEBUG
+    scannedBytes.add(count)
+#endif
+}
+
+/// Return the integer following a sequence of keywords on a line.
+///
+/// This is a linear-time equivalent of matching the pattern
+/// `k1.*k2.*…kn[^0-9]*([0-9]+)` that does not backtrack
+/// on long lines: the keywords are searched left to right
+/// on each line, and the digits may follow on a later line.
+/// A keyword that ends in a digit must not be followed by
+/// another digit (so `Transition_1` does not match `Transition_12`).
+///
+/// - Parameters:
+///   - keywords: The keywords that need to occur in sequence on the same line.
+///   - content: The string to examine.
+/// - Returns: The first integer following the keywords, or `nil` if not found.
+@usableFromInline
+func integer(following keywords: [String], in content: String) -> Int? {
+    let bytes = Array(content.utf8)
+    let patterns = keywords.map { Array($0.utf8) }
+    var examined = 0
+    defer { recordScannedBytes(examined) }
+    var lineStart = 0
+    while lineStart < bytes.count {
+        let lineEnd = bytes[lineStart...].firstIndex(of: UInt8(ascii: "\n")) ?? bytes.count
+        examined += lineEnd - lineStart + 1
+        if let position = endOfSequence(of: patterns, in: bytes, from: lineStart, to: lineEnd, examined: &examined) {
+            let start = bytes[position...].firstIndex(where: isDigit) ?? bytes.count
+            let end = bytes[start...].firstIndex { !isDigit($0) } ?? bytes.count
+            examined += end - position
+            guard start < end else { return nil }
+            return Int(String(decoding: bytes[start..<end], as: UTF8.self))
+        }
+        lineStart = lineEnd + 1
+    }
+    return nil
+}
+
+/// Return the target state indices of all transitions in a state header.
+///
+/// This scans the header once for lines of the form
+/// `Transition_<i> … int … toState … = <target>`,
+/// where the first such line for each `i` wins.
+/// The occurrences of `int`, `toState`, and `=` are
+/// remembered per line, so many transitions declared
+/// on a single line do not cause repeated scans.
+///
+/// - Parameter content: The content of the `State.h` file.
+/// - Returns: The target state index by transition number.
+@usableFromInline
+func transitionTargetIndices(inHeader content: String) -> [Int : Int] {
+    let bytes = Array(content.utf8)
+    let transition = Array("Transition_".utf8)
+    let patterns = ["int", "toState", "="].map { Array($0.utf8) }
+    var targets = [Int : Int]()
+    var examined = 0
+    defer { recordScannedBytes(examined) }
+    var lineStart = 0
+    while lineStart < bytes.count {
+        let lineEnd = bytes[lineStart...].firstIndex(of: UInt8(ascii: "\n")) ?? bytes.count
+        examined += lineEnd - lineStart + 1
+        var found = [Range<Int>?](repeating: nil, count: patterns.count)
+        var value: (position: Int, target: Int)?
+        var position = lineStart
+        scan: while let numberStart = endOfOccurrence(of: transition, in: bytes, from: position, to: lineEnd, examined: &examined) {
+            let numberEnd = bytes[numberStart..<lineEnd].firstIndex { !isDigit($0) } ?? lineEnd
+            examined += numberEnd - numberStart
+            position = numberEnd
+            guard numberEnd > numberStart,
+                  let number = Int(String(decoding: bytes[numberStart..<numberEnd], as: UTF8.self)),
+                  targets[number] == nil else { continue }
+            var valueStart = numberEnd
+            for (k, pattern) in patterns.enumerated() {
+                if let range = found[k], range.lowerBound >= valueStart {
+                    valueStart = range.upperBound
+                    continue
+                }
+                guard let end = endOfOccurrence(of: pattern, in: bytes, from: valueStart, to: lineEnd, examined: &examined) else { break scan }
+                found[k] = (end - pattern.count)..<end
+                valueStart = end
+            }
+            if value?.position != valueStart {
+                let start = bytes[valueStart...].firstIndex(where: isDigit) ?? bytes.count
+                let end = bytes[start...].firstIndex { !isDigit($0) } ?? bytes.count
+                examined += end - valueStart
+                value = (valueStart, Int(String(decoding: bytes[start..<end], as: UTF8.self)) ?? -1)
+            }
+            targets[number] = value?.target
+        }
+        lineStart = lineEnd + 1
+    }
+    return targets
+}
+
+/// Return whether the given byte is an ASCII digit.
+///
+/// - Parameter byte: The byte to examine.
+/// - Returns: `true` iff the byte is in `0`...`9`.
+@usableFromInline
+func isDigit(_ byte: UInt8) -> Bool {
+    byte >= UInt8(ascii: "0") && byte <= UInt8(ascii: "9")
+}
+
+/// Return the position after a sequence of patterns within a range.
+///
+/// Each pattern is searched for after the end of the previous one.
+/// Because the leftmost occurrences leave the most room for the
+/// remaining patterns, this never needs to backtrack.
+///
+/// - Parameters:
+///   - patterns: The patterns to search for in sequence.
+///   - bytes: The bytes to search.
+///   - start: The position to start searching from.
+///   - end: The position to stop searching at.
+///   - examined: Incremented by the number of positions examined.
+/// - Returns: The position after the last pattern, or `nil` if not found.
+@usableFromInline
+func endOfSequence(of patterns: [[UInt8]], in bytes: [UInt8], from start: Int, to end: Int, examined: inout Int) -> Int? {
+    var position = start
+    for pattern in patterns {
+        guard let next = endOfOccurrence(of: pattern, in: bytes, from: position, to: end, examined: &examined) else { return nil }
+        position = next
+    }
+    return position
+}
+
+/// Return the position after the first occurrence of a pattern within a range.
+///
+/// A pattern ending in a digit only matches if it is
+/// not immediately followed by another digit.
+///
+/// - Parameters:
+///   - pattern: The non-empty pattern to search for.
+///   - bytes: The bytes to search.
+///   - start: The position to start searching from.
+///   - end: The position to stop searching at.
+///   - examined: Incremented by the number of positions examined.
+/// - Returns: The position after the pattern, or `nil` if not found.
+@usableFromInline
+func endOfOccurrence(of pattern: [UInt8], in bytes: [UInt8], from start: Int, to end: Int, examined: inout Int) -> Int? {
+    guard let first = pattern.first, end - start >= pattern.count else { return nil }
+    let needsBoundary = pattern.last.map(isDigit) ?? false
+    var i = start
+    while i <= end - pattern.count {
+        examined += 1
+        if bytes[i] == first && bytes[i..<(i + pattern.count)].elementsEqual(pattern) {
+            let after = i + pattern.count
+            if !needsBoundary || after >= end || !isDigit(bytes[after]) { return after }
+        }
+        i += 1
+    }
+    return nil
+}
@@ -0,0 +1,58 @@
+//
+//  SnapshotVariable.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+import Foundation
+
+/// Machine variable captured by `TAKE_SNAPSHOT()`.
+///
+/// Snapshot variables hold the external inputs of an
+/// arrangement instance.  Their values can be recorded
+/// after every snapshot and replayed later on.
+public struct SnapshotVariable: Equatable, Hashable {
+    /// The name of the arrangement instance.
+    public let instance: String
+    /// The name of the machine variable.
+    ///
+    /// This needs to be a valid C identifier
+    /// declared in the machine's `_Variables.h`.
+    public let name: String
+    /// The finite domain of input values to explore (if any).
+    public let domain: ClosedRange<Int>?
+
+    /// Designated initialiser for a snapshot variable.
+    ///
+    /// - Parameters:
+    ///   - instance: The name of the arrangement instance.
+    ///   - name: The name of the machine variable.
+    ///   - domain: The input values to explore.
+    @inlinable
+    public init(instance: String, name: String, domain: ClosedRange<Int>? = nil) {
+        self.instance = instance
+        self.name = name
+        self.domain = domain
+    }
+}
+
+public extension SnapshotVariable {
+    /// Create a snapshot variable from a textual description.
+    ///
+    /// The description has the form `instance.variable`,
+    /// optionally followed by an input domain `=min...max`.
+    ///
+    /// - Parameter description: The snapshot variable description.
+    init?(description: String) {
+        let definition = description.split(separator: "=", maxSplits: 1, omittingEmptySubsequences: false)
+        let components = definition[0].split(separator: ".", omittingEmptySubsequences: false).map { $0.trimmingCharacters(in: .whitespaces) }
+        guard components.count == 2, !components[0].isEmpty, !components[1].isEmpty else { return nil }
+        var domain: ClosedRange<Int>?
+        if definition.count > 1 {
+            let bounds = definition[1].components(separatedBy: "...").map { $0.trimmingCharacters(in: .whitespaces) }
+            guard bounds.count == 2, let lower = Int(bounds[0]), let upper = Int(bounds[1]), lower <= upper else { return nil }
+            domain = lower...upper
+        }
+        self.init(instance: components[0], name: components[1], domain: domain)
+    }
+}
@@ -35,6 +35,24 @@ extension StringProtocol {
         guard let dot = lastIndex(of: ".") else { return self[...] }
         return self[dot...]
     }
+
+    /// The string as a quoted C string literal
+    @usableFromInline var cStringLiteral: String {
+        "\"" + unicodeScalars.map { (c: Unicode.Scalar) -> String in
+            switch c {
+            case "\\": return "\\\\"
+            case "\"": return "\\\""
+            case "\n": return "\\n"
+            case "\r": return "\\r"
+            case "\t": return "\\t"
+            case "?": return "\\?"
+            case _ where c.value < 0x20:
+                let octal = String(c.value, radix: 8)
+                return "\\" + String(repeating: "0", count: 3 - octal.count) + octal
+            default: return String(c)
+            }
+        }.joined() + "\""
+    }
 }
 
 extension String {
@@ -7,6 +7,29 @@ struct FSMConvert: AsyncParsableCommand {
     @Flag(name: .shortAndLong, help: "Create an arrangement of a single FSM.")
     var arrangement = false
 
+    @Flag(help: "Print the read/write-set analysis and partition of the arrangement instances.")
+    var analyse = false
+
+    @Flag(help: "Generate an executor benchmark for the arrangement.")
+    var benchmark = false
+
+    @Option(name: .shortAndLong, help: ArgumentHelp("Add a channel between two arrangement instances.", valueName: "name:type:capacity:producer:consumer"), transform: {
+        guard let channel = Channel(description: $0) else {
+            throw ValidationError("Invalid channel '\($0)'")
+        }
+        return channel
+    })
+    var channel: [Channel] = []
+
+    @Flag(help: "Generate checkpoint and restore functions for the arrangement.")
+    var checkpoint = false
+
+    @Flag(help: "Generate a reachable-configuration explorer for the arrangement.")
+    var explore = false
+
+    @Flag(help: "Export the machine states of the arrangement to shared memory and generate a live monitor.")
+    var export = false
+
     @Option(name: .shortAndLong, help: "The output machine format.", transform: {
         if $0.isEmpty { return $0 }
         guard let format = Format(rawValue: $0.lowercased()) else {
@@ -16,24 +39,56 @@ struct FSMConvert: AsyncParsableCommand {
     })
     var format = ""
 
+    @Flag(help: "Inline guards and actions into the generated state code instead of including them.")
+    var inline = false
+
     @Flag(name: .shortAndLong, help: "Make the generated code introspectable.")
     var introspectable = false
 
     @Flag(name: .shortAndLong, help: "Make the generated machine non-suspensible.")
     var nonSuspensible = false
 
-    @Option(name: .shortAndLong, help: "The output machine/arrangement.")
+    @Flag(help: "Generate the instance partition of the read/write-set analysis for the arrangement.")
+    var partition = false
+
+    @Option(name: .shortAndLong, help: "The output machine/arrangement (a .tar, .tar.zst, or .tzst extension writes an archive).")
     var output = "fsm.out"
 
+    @Option(name: .shortAndLong, help: ArgumentHelp("Flatten the given machines into a single product machine.", valueName: "machine,machine,..."))
+    var product: [String] = []
+
+    @Option(help: "The maximum number of states of a product machine.")
+    var maxProductStates = defaultMaximumProductStates
+
+    @Option(name: .shortAndLong, help: ArgumentHelp("Record/replay (or explore the given domain of) a variable captured by TAKE_SNAPSHOT().", valueName: "instance.variable[=min...max]"), transform: {
+        guard let variable = SnapshotVariable(description: $0) else {
+            throw ValidationError("Invalid snapshot variable '\($0)'")
+        }
+        return variable
+    })
+    var record: [SnapshotVariable] = []
+
+    @Flag(help: "Allow the machines of the arrangement to be reloaded at runtime.")
+    var reloadable = false
+
+    @Flag(help: "Generate re-entrant arrangement contexts and a Monte-Carlo simulation driver.")
+    var simulate = false
+
+    @Flag(name: .shortAndLong, help: "Generate a compact, table-driven executor instead of functions for each state.")
+    var tableDriven = false
+
+    @Flag(help: "Place USDT probes for tracing with bpftrace or perf into the generated code.")
+    var traceable = false
+
     @Flag(name: .shortAndLong, help: "Turn on verbose output.")
     var verbose = false
 
-    @Argument(help: "The input machines to read.", completion: .directory)
+    @Argument(help: "The input machines (directories or .tar/.tar.zst/.tzst archives) to read.", completion: .directory)
     var inputMachines: [String]
 
     mutating func run() async throws {
         let fileManager = FileManager.default
-        let wrapperNames = try inputMachines.map {
+        var wrapperNames = try inputMachines.map {
             let path: String
             if fileManager.fileExists(atPath: $0) {
                 path = $0
@@ -45,23 +100,61 @@ struct FSMConvert: AsyncParsableCommand {
             }
             let machineURL = URL(fileURLWithPath: path)
             let wrapper = try MachineWrapper(url: machineURL)
-            return (machineURL.lastPathComponent, wrapper)
+            return (wrapper.preferredFilename ?? machineURL.lastPathComponent, wrapper)
+        }
+        for group in product {
+            let names = group.split(separator: ",").map { $0.trimmingCharacters(in: .whitespaces) }
+            let components = try names.map { name in
+                guard let component = wrapperNames.first(where: { $0.0 == name || $0.0 == name + ".machine" }) else {
+                    throw ValidationError("Unknown machine '\(name)' in product '\(group)'")
+                }
+                return (name: URL(fileURLWithPath: component.0).deletingPathExtension().lastPathComponent, machine: component.1.machine)
+            }
+            guard components.count > 1 else {
+                throw ValidationError("Product '\(group)' needs at least two machines")
+            }
+            let productName = components.map(\.name).joined(separator: "_")
+            let productMachine = try Machine(productOf: components, maxStates: maxProductStates)
+            wrapperNames.removeAll { wrapper in components.contains { $0.name + ".machine" == wrapper.0 || $0.name == wrapper.0 } }
+            wrapperNames.append((productName + ".machine", MachineWrapper(for: productMachine, named: productName + ".machine")))
         }
-        let machineArrangement = Arrangement(machines: wrapperNames.map { $0.1.machine })
+        let machineArrangement = Arrangement(machines: wrapperNames.map { $0.1.machine }, channels: channel, snapshotVariables: record)
         let outputFormat = format.isEmpty ? nil : Format(rawValue: format)
         guard let outputLanguage = outputLanguage(for: outputFormat, default: wrapperNames.first?.1.machine.language) else {
             FSMConvert.exit(withError: "No output language for format '\(format)'\n")
         }
         let outputURL = URL(fileURLWithPath: output)
         let wrapperMappings = Dictionary(wrapperNames, uniquingKeysWith: { a, _ in a })
-        let arrangementWrapper = ArrangementWrapper(directoryWithFileWrappers: wrapperMappings, for: machineArrangement, named: outputURL.lastPathComponent, language: outputLanguage)
+        let arrangementWrapper = ArrangementWrapper(directoryWithFileWrappers: wrapperMappings, for: machineArrangement, named: ArchiveFormat.directoryName(of: outputURL), language: outputLanguage)
+        arrangementWrapper.isIntrospectable = introspectable
+        arrangementWrapper.isTableDriven = tableDriven
+        arrangementWrapper.isTraceable = traceable
+        arrangementWrapper.isInlined = inline
+        arrangementWrapper.isExportable = export
+        arrangementWrapper.isReloadable = reloadable
+        arrangementWrapper.isCheckpointable = checkpoint
+        arrangementWrapper.isExplorable = explore
+        arrangementWrapper.isSimulatable = simulate
+        arrangementWrapper.isPartitioned = partition
+        arrangementWrapper.isBenchmarkable = benchmark
         if verbose {
             print("\(wrapperNames.count) FSMs with \(wrapperNames.reduce(0) { $0 + $1.1.machine.llfsm.states.count }) states and \(wrapperNames.reduce(0) { $0 + $1.1.machine.llfsm.transitions.count }) transitions\n")
         }
-        if arrangement || wrapperNames.count > 1 {
+        if analyse {
+            let analysis = AccessAnalysis(instances: wrapperNames.map {
+                (name: URL(fileURLWithPath: $0.0).deletingPathExtension().lastPathComponent, machine: $0.1.machine)
+            })
+            print(analysis.report)
+        }
+        let hasArrangementFeatures = export || reloadable || checkpoint || explore || simulate || partition || benchmark
+        if arrangement || hasArrangementFeatures || wrapperNames.count > 1 || !channel.isEmpty || !record.isEmpty || !product.isEmpty {
             try arrangementWrapper.write(to: outputURL)
         } else if let machineWrapper = wrapperNames.first?.1 {
             machineWrapper.language = outputLanguage
+            machineWrapper.isIntrospectable = introspectable
+            machineWrapper.isTableDriven = tableDriven
+            machineWrapper.isTraceable = traceable
+            machineWrapper.isInlined = inline
             try machineWrapper.write(to: outputURL)
         }
     }
@@ -0,0 +1,45 @@
+//
+//  fsmfuzz.swift
+//
+//  Created by Rene Hexel on 17/10/2026.
+//  Copyright © 2026 Rene Hexel. All rights reserved.
+//
+import Foundation
+import FSM
+
+/// libFuzzer entry point.
+///
+/// Build with
+/// `swift build --product fsmfuzz -Xswiftc -sanitize=fuzzer,address -Xswiftc -DFUZZING`
+/// and run the resulting binary with a corpus directory.
+///
+/// - Parameters:
+///   - data: The fuzzer-generated input.
+///   - size: The number of bytes in `data`.
+/// - Returns: `0` to keep the input in the corpus.
+@_cdecl("LLVMFuzzerTestOneInput")
+public func fuzzerTestOneInput(_ data: UnsafePointer<UInt8>, _ size: Int) -> CInt {
+    fuzzMachineWrapper(Data(bytes: data, count: size))
+    return 0
+}
+
+#if !FUZZING
+/// Replay the given fuzzer inputs without libFuzzer.
+@main
+struct FSMFuzz {
+    static func main() {
+        var status = EXIT_SUCCESS
+        for path in CommandLine.arguments.dropFirst() {
+            guard let data = FileManager.default.contents(atPath: path) else {
+                fputs("Cannot read '\(path)'\n", stderr)
+                status = EXIT_FAILURE
+                continue
+            }
+            let start = Date()
+            let machine = fuzzMachineWrapper(data)
+            print("\(path): \(machine.map { "\($0.llfsm.states.count) states" } ?? "error") in \(Date().timeIntervalSince(start))s")
+        }
+        exit(status)
+    }
+}
+#endif
@@ -0,0 +1,625 @@
+import XCTest
+@testable import FSM
+
+/// Tests that compile and run generated C code.
+///
+/// These tests get skipped if no C compiler is available.
+final class CompiledCodeTests: XCTestCase {
+    func testActiveMachineScheduler() throws {
+        let r = State(id: StateID(), name: "Running")
+        let s = State(id: StateID(), name: "Suspended")
+        let suspensible = LLFSM(states: [r, s], transitions: [], suspendState: s.id)
+        let plain = LLFSM(states: [r], transitions: [], suspendState: nil)
+        let instances = [Instance(name: "A", typeFile: "M.machine", fsm: suspensible), Instance(name: "B", typeFile: "N.machine", fsm: plain), Instance(name: "C", typeFile: "M.machine", fsm: suspensible)]
+        let output = try compileAndRun([
+            "Machine_Common.h": cArrangementMachineInterface(for: instances, named: "Test", isSuspensible: true),
+            "Machine_Macros.h": cArrangementMacroInterface(isSuspensible: true),
+            "Machine_Common.c": cArrangementMachineCode(for: instances, named: "Test", isSuspensible: true),
+            "main.c": schedulerDriver
+        ])
+        XCTAssertEqual(output, "running 2 2\nsuspended 2 6\nresumed 3 7\nwoken 1\nsuspended all 1\nringlets 3\n")
+    }
+
+    func testChannel() throws {
+        let fsm = LLFSM(states: [State(id: StateID(), name: "S")], transitions: [], suspendState: nil)
+        let instances = [Instance(name: "A", typeFile: "M.machine", fsm: fsm), Instance(name: "B", typeFile: "M.machine", fsm: fsm)]
+        let channels = [Channel(name: "events", elementType: "int", capacity: 3, producer: "A", consumer: "B")]
+        let output = try compileAndRun([
+            "Machine_Common.h": cArrangementMachineInterface(for: instances, named: "Test", isSuspensible: false, channels: channels),
+            "Machine_Macros.h": cArrangementMacroInterface(isSuspensible: false),
+            "Machine_Common.c": cArrangementMachineCode(for: instances, named: "Test", isSuspensible: false, channels: channels),
+            "main.c": channelDriver
+        ], flags: ["-pthread"])
+        XCTAssertEqual(output, "full 4 0 0\n0 1 2 3 empty 0\nseparate 1\nin order 1\n")
+    }
+
+    func testThreadLocalChannels() throws {
+        let fsm = LLFSM(states: [State(id: StateID(), name: "S")], transitions: [], suspendState: nil)
+        let instances = [Instance(name: "A", typeFile: "M.machine", fsm: fsm), Instance(name: "B", typeFile: "M.machine", fsm: fsm)]
+        let channels = [Channel(name: "events", elementType: "int", capacity: 4, producer: "A", consumer: "B")]
+        let files = [
+            "Machine_Common.h": cArrangementMachineInterface(for: instances, named: "Test", isSuspensible: true, channels: channels),
+            "Machine_Macros.h": cArrangementMacroInterface(isSuspensible: true),
+            "Machine_Common.c": cArrangementMachineCode(for: instances, named: "Test", isSuspensible: true, channels: channels),
+            "main.c": threadLocalChannelDriver
+        ]
+        XCTAssertEqual(try compileAndRun(files, flags: ["-pthread"]), "worker 2 42\nmain 2\n")
+        XCTAssertEqual(try compileAndRun(files, flags: ["-pthread", "-DLLFSM_EXPLORE"]), "worker 1 1\nmain 1\n")
+        XCTAssertEqual(try compileAndRun(files, flags: ["-pthread", "-DLLFSM_SIMULATE"]), "worker 1 1\nmain 1\n")
+    }
+
+    func testYieldingAction() throws {
+        let work = State(id: StateID(), name: "Work")
+        let done = State(id: StateID(), name: "Done")
+        let fsm = LLFSM(states: [work, done], transitions: [
+            Transition(label: "machine->ticks == 7", source: work.id, target: done.id),
+            Transition(label: "true", source: done.id, target: work.id)
+        ], suspendState: nil)
+        let sources = [
+            "State_Work_OnEntry.mm": "printf(\"entry \");",
+            "State_Work_OnExit.mm": "printf(\"exit \");",
+            "State_Work_Internal.mm": """
+            ACTION_BEGIN();
+            printf("a ");
+            YIELD();
+            printf("b ");
+            WAIT_UNTIL(machine->ticks % 4 == 0);
+            printf("c ");
+            ACTION_END();
+            """,
+            "State_Work_Transition_0.expr": "machine->ticks == 7",
+            "State_Done_OnEntry.mm": "printf(\"done \");",
+            "State_Done_Transition_0.expr": "true"
+        ]
+        var files = yieldingMachineFiles(for: fsm, sources: sources)
+        let output = try compileAndRun(files)
+        XCTAssertEqual(output, """
+        0: entry a 1
+        1: b 1
+        2: 1
+        3: 1
+        4: c 0
+        5: a 1
+        6: b 1
+        7: exit 0
+        8: done 0
+        9: entry a 1
+        10: b 1
+        11: 1
+
+        """)
+        var entryYielding = sources
+        entryYielding["State_Work_OnEntry.mm"] = "ACTION_BEGIN(); YIELD(); ACTION_END();"
+        files = yieldingMachineFiles(for: fsm, sources: entryYielding)
+        XCTAssertThrowsError(try compileAndRun(files)) { error in
+            XCTAssertTrue(error is CompilationError, "only internal actions should be able to yield")
+        }
+    }
+
+    func testCheckpointRoundTrip() throws {
+        let work = State(id: StateID(), name: "Work")
+        let done = State(id: StateID(), name: "Done")
+        let fsm = LLFSM(states: [work, done], transitions: [
+            Transition(label: "machine->ticks == 7", source: work.id, target: done.id),
+            Transition(label: "true", source: done.id, target: work.id)
+        ], suspendState: nil)
+        let instances = [Instance(name: "M", typeFile: "M.machine", fsm: fsm)]
+        var files = yieldingMachineFiles(for: fsm, sources: [
+            "State_Work_OnEntry.mm": "printf(\"entry \");",
+            "State_Work_Internal.mm": "ACTION_BEGIN(); printf(\"a \"); YIELD(); printf(\"b \"); ACTION_END();",
+            "State_Work_Transition_0.expr": "machine->ticks == 7",
+            "State_Done_OnEntry.mm": "printf(\"done \");",
+            "State_Done_Transition_0.expr": "true"
+        ])
+        for file in ["Machine_M.h", "State_Work.h", "State_Done.h"] {
+            files["M.machine/" + file] = files[file]
+        }
+        files["Machine_Common.h"] = cArrangementMachineInterface(for: instances, named: "Test", isSuspensible: false, isCheckpointable: true)
+        files["Arrangement_Test.h"] = cArrangementInterface(for: instances, named: "Test", isSuspensible: false)
+        files["Arrangement_Test_Checkpoint.c"] = cArrangementCheckpointCode(for: instances, named: "Test", isSuspensible: false, variables: ["M": "int ticks;"])
+        files["main.c"] = checkpointDriver
+        let output = try compileAndRun(files)
+        let runs = output.components(separatedBy: "restored 1\n")
+        XCTAssertEqual(runs.count, 2, output)
+        let continued = try XCTUnwrap(runs.first?.components(separatedBy: "| 3 0\n").last)
+        XCTAssertTrue(continued.contains("done"), "the ringlets after the checkpoint need to change state")
+        XCTAssertEqual(runs.last, continued + "stale 0\ntruncated 0\n", "the restored arrangement needs to repeat the same ringlets")
+        XCTAssertFalse(cArrangementMachineInterface(for: instances, named: "Test", isSuspensible: false).contains("fsm_arrangement_checkpoint"))
+    }
+
+    /// Return the files for compiling a single machine with the yielding action driver.
+    ///
+    /// - Parameters:
+    ///   - fsm: The machine with a `Work` and a `Done` state.
+    ///   - sources: The guard and action sources to inline.
+    /// - Returns: The files to compile.
+    private func yieldingMachineFiles(for fsm: LLFSM, sources: [String: String]) -> [String: String] {
+        let states = fsm.states.compactMap { fsm.stateMap[$0] }
+        var files = [
+            "Machine_Common.h": cArrangementMachineInterface(for: [Instance(name: "M", typeFile: "M.machine", fsm: fsm)], named: "Test", isSuspensible: false),
+            "Machine_Macros.h": cArrangementMacroInterface(isSuspensible: false),
+            "Machine_Common.c": cArrangementMachineCode(for: [Instance(name: "M", typeFile: "M.machine", fsm: fsm)], named: "Test", isSuspensible: false),
+            "Machine_M.h": cMachineInterface(for: fsm, named: "M", isSuspensible: false),
+            "Machine_M_Includes.h": "#include <stdio.h>\n",
+            "Machine_M_Variables.h": "int ticks;\n",
+            "main.c": yieldingActionDriver
+        ]
+        for state in states {
+            files["State_\(state.name).h"] = cStateInterface(for: state, llfsm: fsm, named: "M", isSuspensible: false)
+            files["State_\(state.name).c"] = cStateCode(for: state, llfsm: fsm, named: "M", isSuspensible: false, inlining: sources)
+            files["State_\(state.name)_Includes.h"] = ""
+            files["State_\(state.name)_Variables.h"] = ""
+        }
+        return files
+    }
+
+    func testIntrospection() throws {
+        let idle = State(id: StateID(), name: "Idle")
+        let busy = State(id: StateID(), name: "Busy")
+        let transitions = [
+            Transition(label: "start", source: idle.id, target: busy.id),
+            Transition(label: " done ", source: busy.id, target: idle.id),
+            Transition(label: "true", source: busy.id, target: busy.id)
+        ]
+        let fsm = LLFSM(states: [idle, busy], transitions: transitions, suspendState: nil)
+        let instances = [Instance(name: "A", typeFile: "M.machine", fsm: fsm), Instance(name: "B", typeFile: "M.machine", fsm: fsm)]
+        let output = try compileAndRun([
+            "M.machine/Machine_M_Introspection.h": cMachineIntrospectionInterface(for: fsm, named: "M", isSuspensible: false),
+            "M.machine/Machine_M_Introspection.c": cMachineIntrospectionCode(for: fsm, named: "M", isSuspensible: false),
+            "Arrangement_Test_Introspection.h": cArrangementIntrospectionInterface(for: instances, named: "Test", isSuspensible: false),
+            "Arrangement_Test_Introspection.c": cArrangementIntrospectionCode(for: instances, named: "Test", isSuspensible: false),
+            "main.c": introspectionDriver
+        ])
+        XCTAssertEqual(output, """
+        Idle 1: Idle->Busy [start] -
+        Busy 2: Busy->Idle [done] Busy->Busy [true] -
+        - 0: -
+        index 1 1
+        A M Busy
+        B M Busy
+        - - -
+
+        """)
+    }
+
+    func testTableDrivenGuards() throws {
+        let a = State(id: StateID(), name: "A")
+        let b = State(id: StateID(), name: "B")
+        let c = State(id: StateID(), name: "C")
+        let fsm = LLFSM(states: [a, b, c], transitions: [
+            Transition(label: "state->n > 0", source: a.id, target: c.id),
+            Transition(label: "machine->ticks % 2 == 0", source: a.id, target: b.id),
+            Transition(label: "state->n > 0", source: b.id, target: c.id),
+            Transition(label: " machine->ticks % 2 == 0 ", source: b.id, target: a.id),
+            Transition(label: "machine->ticks % 2 == 0", source: c.id, target: a.id)
+        ], suspendState: nil)
+        var sources = [String: String]()
+        for (state, guards) in [("A", ["state->n > 0", "machine->ticks % 2 == 0"]), ("B", ["state->n > 0", "machine->ticks % 2 == 0"]), ("C", ["machine->ticks % 2 == 0"])] {
+            sources["State_\(state)_OnEntry.mm"] = "printf(\"\(state):\");"
+            for (i, label) in guards.enumerated() {
+                sources["State_\(state)_Transition_\(i).expr"] = label
+            }
+        }
+        let table = cMachineTableCode(for: fsm, named: "M", isSuspensible: false, inlining: sources)
+        XCTAssertTrue(table.contains("fsm_m_transition_guard[5] = { 0, 1, 2, 1, 1 };"))
+        XCTAssertTrue(table.contains("case 2:"))
+        XCTAssertFalse(table.contains("case 3:"))
+        var files = [
+            "Machine_Common.h": cArrangementMachineInterface(for: [Instance(name: "M", typeFile: "M.machine", fsm: fsm)], named: "Test", isSuspensible: false),
+            "Machine_Macros.h": cArrangementMacroInterface(isSuspensible: false),
+            "Machine_Common.c": cArrangementMachineCode(for: [Instance(name: "M", typeFile: "M.machine", fsm: fsm)], named: "Test", isSuspensible: false),
+            "Machine_M.h": cMachineInterface(for: fsm, named: "M", isSuspensible: false),
+            "Machine_M_Includes.h": "#include <stdio.h>\n",
+            "Machine_M_Variables.h": "int ticks;\n",
+            "Machine_M_Table.c": table,
+            "State_A_Variables.h": "int n;\n",
+            "State_B_Variables.h": "int pad;\nint n;\n",
+            "State_C_Variables.h": "",
+            "main.c": tableDrivenDriver
+        ]
+        for state in [a, b, c] {
+            files["State_\(state.name).h"] = cStateInterface(for: state, llfsm: fsm, named: "M", isSuspensible: false, isTableDriven: true)
+            files["State_\(state.name)_Includes.h"] = ""
+        }
+        let output = try compileAndRun(files)
+        XCTAssertEqual(output, "A:1\nB:2\nC:0\nA:0\n1\nB:2\nC:0\nA:0\n", "each state needs to evaluate its own state->n guard")
+    }
+
+    func testMachinePackageHash() throws {
+        let path = ProcessInfo.processInfo.environment["PATH"] ?? "/usr/bin:/bin"
+        guard let cmake = path.split(separator: ":").map({ $0 + "/cmake" }).first(where: FileManager.default.isExecutableFile) else {
+            throw XCTSkip("no cmake available")
+        }
+        func machine(_ names: [String]) -> Machine {
+            let machine = Machine()
+            let states = names.map { State(id: StateID(), name: $0) }
+            machine.llfsm = LLFSM(states: states, transitions: [Transition(label: "true", source: states[0].id, target: states[1].id)], suspendState: nil)
+            return machine
+        }
+        let m = machine(["A", "B"])
+        let n = machine(["C", "D"])
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent("FSMTests-" + UUID().uuidString)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let standalone = MachineWrapper(for: m, named: "M.machine")
+        standalone.language = CBinding()
+        try standalone.write(to: directory.appendingPathComponent("M.machine"))
+        let small = ArrangementWrapper(directoryWithFileWrappers: ["M.machine": MachineWrapper(for: m, named: "M.machine")], for: Arrangement(machines: [m]), named: "Small.arrangement", language: CBinding())
+        try small.write(to: directory.appendingPathComponent("Small.arrangement"))
+        let large = ArrangementWrapper(directoryWithFileWrappers: ["M.machine": MachineWrapper(for: m, named: "M.machine"), "N.machine": MachineWrapper(for: n, named: "N.machine")], for: Arrangement(machines: [m, n]), named: "Large.arrangement", language: CBinding())
+        try large.write(to: directory.appendingPathComponent("Large.arrangement"))
+        let hook = directory.appendingPathComponent("hook.cmake")
+        try """
+        function(print_hash variable access value)
+          if(access STREQUAL "MODIFIED_ACCESS")
+            message(STATUS "HASH ${value}")
+          endif()
+        endfunction()
+        variable_watch(M_FSM_CONTENT_HASH print_hash)
+
+        """.write(to: hook, atomically: true, encoding: .utf8)
+        let hashes = try ["M.machine", "Small.arrangement", "Large.arrangement"].map { source -> String in
+            let output = try run(cmake, arguments: ["-S", directory.appendingPathComponent(source).path, "-B", directory.appendingPathComponent("build-" + source).path, "-DCMAKE_PROJECT_INCLUDE=" + hook.path])
+            return String(try XCTUnwrap(output.split(separator: "\n").last { $0.hasPrefix("-- HASH ") }))
+        }
+        XCTAssertEqual(hashes.count, 3)
+        XCTAssertEqual(Set(hashes).count, 1, "\(hashes)")
+    }
+}
+
+/// Driver running two mock machines through the arrangement scheduler.
+///
+/// Machine `a` gets suspended, resumed, and finally resumed
+/// behind the scheduler's back (without an activity change),
+/// which needs to get picked up by the periodic re-check.
+/// Machine `c` then gets resumed behind the scheduler's back,
+/// which `fsm_arrangement_suspend_all()` needs to pick up,
+/// and the ringlets following an activity change need to count.
+private let schedulerDriver = #"""
+#include <stdio.h>
+#include "Machine_Common.h"
+
+static int runs[3];
+
+static void nop(struct LLFSMachine *m, struct LLFSMState *s) { (void)m; (void)s; }
+static void run_a(struct LLFSMachine *m, struct LLFSMState *s) { (void)m; (void)s; runs[0]++; }
+static void run_b(struct LLFSMachine *m, struct LLFSMState *s) { (void)m; (void)s; runs[1]++; }
+static void run_c(struct LLFSMachine *m, struct LLFSMState *s) { (void)m; (void)s; runs[2]++; }
+static struct LLFSMState *stay(const struct LLFSMachine * const m, const struct LLFSMState * const s) { (void)m; (void)s; return NULL; }
+
+static struct LLFSMState running_a = { stay, nop, nop, run_a, nop, nop };
+static struct LLFSMState suspended_a = { stay, nop, nop, nop, nop, nop };
+static struct LLFSMState running_b = { stay, nop, nop, run_b, nop, nop };
+static struct LLFSMState running_c = { stay, nop, nop, run_c, nop, nop };
+static struct LLFSMState suspended_c = { stay, nop, nop, nop, nop, nop };
+
+struct test_machine
+{
+    struct LLFSMState *current_state;
+    struct LLFSMState *previous_state;
+    uintptr_t          state_time;
+    struct LLFSMState *suspend_state;
+    struct LLFSMState *resume_state;
+    struct LLFSMState * const states[2];
+};
+
+static struct test_machine a = { &running_a, NULL, 0, &suspended_a, NULL, { &running_a, &suspended_a } };
+static struct test_machine b = { &running_b, NULL, 0, NULL, NULL, { &running_b, NULL } };
+static struct test_machine c = { &running_c, NULL, 0, &suspended_c, NULL, { &running_c, &suspended_c } };
+
+static void run(struct LLFSMArrangement *arrangement, int n)
+{
+    while (n--) fsm_arrangement_execute_once(arrangement);
+}
+
+int main(void)
+{
+    struct LLFSMArrangement arrangement = {
+        .number_of_instances = 3,
+        .machines = { (struct LLFSMachine *)&a, (struct LLFSMachine *)&b, (struct LLFSMachine *)&c },
+        .activity_epoch = LLFSM_ACTIVITY_EPOCH_INVALID
+    };
+    struct LLFSMachine * const m = (struct LLFSMachine *)&a;
+    run(&arrangement, 2);
+    printf("running %d %d\n", runs[0], runs[1]);
+    SUSPEND(m);
+    run(&arrangement, 4);
+    printf("suspended %d %d\n", runs[0], runs[1]);
+    RESUME(m);
+    run(&arrangement, 1);
+    printf("resumed %d %d\n", runs[0], runs[1]);
+    SUSPEND(m);
+    run(&arrangement, 2);
+    runs[0] = 0;
+    a.current_state = &running_a; // resumed without an activity change
+    run(&arrangement, LLFSM_ACTIVITY_RESYNC_INTERVAL);
+    printf("woken %d\n", runs[0] > 0);
+    struct LLFSMachine * const n = (struct LLFSMachine *)&c;
+    SUSPEND(n);
+    run(&arrangement, 2);
+    c.current_state = &running_c; // resumed without an activity change
+    fsm_arrangement_suspend_all(&arrangement);
+    printf("suspended all %d\n", IS_SUSPENDED(n));
+    const uintptr_t ringlets = arrangement.ringlets;
+    RESUME(n);
+    run(&arrangement, 3);
+    printf("ringlets %d\n", (int)(arrangement.ringlets - ringlets));
+    return 0;
+}
+"""#
+
+/// Driver filling and draining a channel, then streaming through it across threads.
+private let channelDriver = #"""
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stddef.h>
+#include "Machine_Common.h"
+
+#define MESSAGES 100000
+
+static void *producer(void *arg)
+{
+    int i;
+    (void)arg;
+    for (i = 0; i < MESSAGES; i++) while (!CHANNEL_SEND(events, i)) sched_yield();
+    return NULL;
+}
+
+int main(void)
+{
+    pthread_t thread;
+    int i, value = -1, in_order = 1;
+    for (i = 0; i < LLFSM_CHANNEL_EVENTS_CAPACITY; i++) CHANNEL_SEND(events, i);
+    printf("full %d %d %d\n", (int)CHANNEL_COUNT(events), CHANNEL_CAN_SEND(events), CHANNEL_SEND(events, 99));
+    while (CHANNEL_RECEIVE(events, &value)) printf("%d ", value);
+    printf("empty %d\n", CHANNEL_CAN_RECEIVE(events));
+    printf("separate %d\n", offsetof(struct llfsm_channel_events, tail) - offsetof(struct llfsm_channel_events, head) >= LLFSM_CACHE_LINE_SIZE);
+    pthread_create(&thread, NULL, producer, NULL);
+    for (i = 0; i < MESSAGES; i++)
+    {
+        while (!CHANNEL_RECEIVE(events, &value)) sched_yield();
+        if (value != i) in_order = 0;
+    }
+    pthread_join(thread, NULL);
+    printf("in order %d\n", in_order);
+    return 0;
+}
+"""#
+
+/// Driver using a channel from a second thread.
+///
+/// The channel is shared between the threads, unless it is
+/// thread-local, as for the explorer and simulation drivers.
+private let threadLocalChannelDriver = #"""
+#include <pthread.h>
+#include <stdio.h>
+#include "Machine_Common.h"
+
+static void *worker(void *arg)
+{
+    int value = -1;
+    (void)arg;
+    CHANNEL_SEND(events, 1);
+    CHANNEL_SEND(events, 2);
+    CHANNEL_RECEIVE(events, &value);
+    printf("worker %d %d\n", (int)CHANNEL_COUNT(events), value);
+    return NULL;
+}
+
+int main(void)
+{
+    pthread_t thread;
+    CHANNEL_SEND(events, 42);
+    pthread_create(&thread, NULL, worker, NULL);
+    pthread_join(thread, NULL);
+    printf("main %d\n", (int)CHANNEL_COUNT(events));
+    return 0;
+}
+"""#
+
+/// Driver running a machine whose `Work` state yields in its internal action.
+///
+/// Each line shows the ringlet, the actions executed, and
+/// whether the `Work` state has a pending resumption point.
+private let yieldingActionDriver = #"""
+#include <stdio.h>
+#include "Machine_Common.h"
+#include "Machine_M.h"
+#include "State_Work.h"
+#include "State_Done.h"
+
+static struct FSMM_State_Work work;
+static struct FSMM_State_Done done;
+static struct Machine_M m = { .states = { (struct LLFSMState *)&work, (struct LLFSMState *)&done } };
+
+int main(void)
+{
+    fsm_m_work_init(&work);
+    fsm_m_done_init(&done);
+    m.current_state = m.states[0];
+    for (m.ticks = 0; m.ticks < 12; m.ticks++)
+    {
+        printf("%d: ", m.ticks);
+        llfsm_execute_once((struct LLFSMachine *)&m);
+        printf("%d\n", work.pt_resume != 0);
+    }
+    return 0;
+}
+"""#
+
+/// Driver checkpointing a yielding machine, then restoring it.
+///
+/// The ringlets after the checkpoint are run twice, before and
+/// after restoring it, followed by restore attempts using a
+/// checkpoint with a mismatched layout hash and a truncated one.
+private let checkpointDriver = #"""
+#include <stdio.h>
+#include <string.h>
+#include "Machine_Common.h"
+#include "Arrangement_Test.h"
+#include "Machine_M.h"
+#include "State_Work.h"
+#include "State_Done.h"
+
+static struct FSMM_State_Work work;
+static struct FSMM_State_Done done;
+static struct Machine_M m = { .states = { (struct LLFSMState *)&work, (struct LLFSMState *)&done } };
+
+static void run(struct LLFSMArrangement * const arrangement, int n)
+{
+    while (n--)
+    {
+        fsm_arrangement_execute_once(arrangement);
+        m.ticks++;
+    }
+    printf("| %d %d\n", m.ticks, (int)(m.current_state == m.states[1]));
+}
+
+int main(void)
+{
+    static unsigned char checkpoint[4096], stale[4096];
+    struct Arrangement_Test test = { .number_of_instances = 1, .fsm_m = &m };
+    struct LLFSMArrangement * const arrangement = (struct LLFSMArrangement *)&test;
+    const size_t size = fsm_arrangement_checkpoint_size();
+    fsm_m_work_init(&work);
+    fsm_m_done_init(&done);
+    m.current_state = m.states[0];
+    run(arrangement, 3);
+    if (size > sizeof(checkpoint) || fsm_arrangement_checkpoint(arrangement, checkpoint, sizeof(checkpoint)) != size) return 1;
+    run(arrangement, 6);
+    printf("restored %d\n", fsm_arrangement_restore(arrangement, checkpoint, size));
+    run(arrangement, 6);
+    memcpy(stale, checkpoint, size);
+    stale[8] ^= 1; // layout hash
+    printf("stale %d\n", fsm_arrangement_restore(arrangement, stale, size));
+    printf("truncated %d\n", fsm_arrangement_restore(arrangement, checkpoint, size - 1));
+    return 0;
+}
+"""#
+
+/// Driver running a table-driven machine whose states share guards.
+///
+/// `B` has its `n` at a different offset than `A`,
+/// so its `state->n > 0` guard must not be shared with `A`.
+private let tableDrivenDriver = #"""
+#include <stdio.h>
+#include "Machine_Common.h"
+#include "Machine_M.h"
+#include "State_A.h"
+#include "State_B.h"
+#include "State_C.h"
+
+static struct FSMM_State_A a;
+static struct FSMM_State_B b;
+static struct FSMM_State_C c;
+static struct Machine_M m = { .states = { (struct LLFSMState *)&a, (struct LLFSMState *)&b, (struct LLFSMState *)&c } };
+
+int main(void)
+{
+    fsm_m_a_init(&a);
+    fsm_m_b_init(&b);
+    fsm_m_c_init(&c);
+    b.n = 1;
+    m.current_state = m.states[0];
+    for (m.ticks = 0; m.ticks < 8; m.ticks++)
+    {
+        llfsm_execute_once((struct LLFSMachine *)&m);
+        printf("%d\n", (int)((struct FSMM_State_C *)m.current_state)->state_index);
+    }
+    return 0;
+}
+"""#
+
+/// Driver printing the introspection tables of a machine and an arrangement,
+/// including out of range lookups.
+private let introspectionDriver = #"""
+#include <stdio.h>
+#include "Arrangement_Test_Introspection.h"
+#include "M.machine/Machine_M_Introspection.h"
+
+int main(void)
+{
+    uintptr_t s, t;
+    for (s = 0; s < 3; s++)
+    {
+        const char *name = fsm_m_state_name(s);
+        printf("%s %d:", name ? name : "-", (int)fsm_m_transition_count(s));
+        for (t = 0; t <= fsm_m_transition_count(s); t++)
+        {
+            const struct FSMM_Transition_Info *info = fsm_m_transition(s, t);
+            if (info) printf(" %s->%s [%s]", fsm_m_state_names[info->source], fsm_m_state_names[info->target], info->expression);
+            else printf(" -");
+        }
+        printf("\n");
+    }
+    printf("index %d %d\n", (int)fsm_m_state_index("Busy"), fsm_m_state_index("None") == MACHINE_M_NO_STATE);
+    for (s = 0; s < 3; s++)
+    {
+        const char *name = arrangement_test_instance_name(s);
+        const char *type = arrangement_test_instance_type(s);
+        const char *state = arrangement_test_state_name(s, 1);
+        printf("%s %s %s\n", name ? name : "-", type ? type : "-", state ? state : "-");
+    }
+    return 0;
+}
+"""#
+
+/// Error thrown when compiling or running C code fails.
+struct CompilationError: Error, CustomStringConvertible {
+    /// The command that failed.
+    let command: String
+    /// The output of the failed command.
+    let output: String
+
+    var description: String { command + ":\n" + output }
+}
+
+/// Compile the given C files and run the resulting program.
+///
+/// - Parameters:
+///   - files: The content of the files to compile, by (relative) file path.
+///   - flags: Additional compiler flags.
+/// - Returns: The standard output of the program.
+/// - Throws: `XCTSkip` if there is no C compiler, `CompilationError` if compiling or running fails.
+func compileAndRun(_ files: [String: String], flags: [String] = []) throws -> String {
+    let path = ProcessInfo.processInfo.environment["PATH"] ?? "/usr/bin:/bin"
+    guard let cc = path.split(separator: ":").map({ $0 + "/cc" }).first(where: FileManager.default.isExecutableFile) else {
+        throw XCTSkip("no C compiler available")
+    }
+    let directory = FileManager.default.temporaryDirectory.appendingPathComponent("FSMTests-" + UUID().uuidString)
+    try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    defer { try? FileManager.default.removeItem(at: directory) }
+    for (name, content) in files {
+        let file = directory.appendingPathComponent(name)
+        try FileManager.default.createDirectory(at: file.deletingLastPathComponent(), withIntermediateDirectories: true)
+        try content.write(to: file, atomically: true, encoding: .utf8)
+    }
+    let sources = files.keys.filter { $0.hasSuffix(".c") }.sorted().map { directory.appendingPathComponent($0).path }
+    let executable = directory.appendingPathComponent("a.out").path
+    _ = try run(cc, arguments: ["-std=gnu11", "-I", directory.path, "-o", executable] + flags + sources)
+    return try run(executable)
+}
+
+/// Run a program and return its output.
+///
+/// - Parameters:
+///   - program: The path of the program to run.
+///   - arguments: The command line arguments.
+/// - Returns: The standard output (and error) of the program.
+/// - Throws: `CompilationError` if the program fails.
+func run(_ program: String, arguments: [String] = []) throws -> String {
+    let process = Process()
+    let pipe = Pipe()
+    process.executableURL = URL(fileURLWithPath: program)
+    process.arguments = arguments
+    process.standardOutput = pipe
+    process.standardError = pipe
+    try process.run()
+    let output = String(decoding: pipe.fileHandleForReading.readDataToEndOfFile(), as: UTF8.self)
+    process.waitUntilExit()
+    guard process.terminationStatus == 0 else {
+        throw CompilationError(command: ([program] + arguments).joined(separator: " "), output: output)
+    }
+    return output
+}
@@ -0,0 +1,21 @@
+import XCTest
+@testable import FSM
+
+/// Benchmarks for executing machines in-process.
+final class ExecutionPerformanceTests: XCTestCase {
+    func testRingletsPerSecond() throws {
+        let machine = largeMachine(states: 1000)
+        var executor = try LLFSMExecutor(compiling: machine.llfsm, context: 0, actions: { _ in
+            LLFSMStateActions(onEntry: { $0 &+= 1 })
+        }, guards: { _ in { $0 & 1 == 1 } })
+        let ringlets = 1_000_000
+        measure {
+            let start = DispatchTime.now().uptimeNanoseconds
+            executor.execute(ringlets: ringlets)
+            let elapsed = max(1, DispatchTime.now().uptimeNanoseconds - start)
+            print("\(UInt64(ringlets) * 1_000_000_000 / elapsed) ringlets/s")
+        }
+        XCTAssertEqual(executor.ringlets % ringlets, 0)
+        XCTAssertGreaterThan(executor.context, 0)
+    }
+}
@@ -50,4 +50,558 @@ final class FSMTests: XCTestCase {
         XCTAssertNotEqual(fsm.suspendState, t.id)
         XCTAssertEqual(fsm.suspendState, s.id)
     }
+
+    func testProduct() throws {
+        let a0 = State(id: StateID(), name: "A0")
+        let a1 = State(id: StateID(), name: "A1")
+        let b0 = State(id: StateID(), name: "B0")
+        let b1 = State(id: StateID(), name: "B1")
+        let a = LLFSM(states: [a0, a1], transitions: [
+            Transition(label: "x", source: a0.id, target: a1.id),
+            Transition(label: "true", source: a1.id, target: a0.id)
+        ], suspendState: nil)
+        let b = LLFSM(states: [b0, b1], transitions: [
+            Transition(label: "y", source: b0.id, target: b1.id)
+        ], suspendState: nil)
+        let product = try LLFSM.product(of: [a, b])
+        let fsm = product.fsm
+        XCTAssertEqual(fsm.states.compactMap { fsm.stateMap[$0]?.name }, ["A0__B0", "A1__B1", "A1__B0", "A0__B1"])
+        XCTAssertEqual(fsm.transitions.count, 7)
+        XCTAssertEqual(product.components[fsm.initialState], [0, 0])
+        let labels = fsm.transitionsFrom(fsm.initialState).compactMap { fsm.transitionMap[$0]?.label }
+        XCTAssertEqual(labels, ["(x) && (y)", "(x) && !(y)", "!(x) && (y)"])
+        XCTAssertNil(fsm.suspendState)
+        XCTAssertThrowsError(try LLFSM.product(of: [a, b], maxStates: 3))
+    }
+
+    func testLayeredLayout() {
+        let a = State(id: StateID(), name: "A")
+        let b = State(id: StateID(), name: "B")
+        let c = State(id: StateID(), name: "C")
+        let d = State(id: StateID(), name: "D")
+        let fsm = LLFSM(states: [a, b, c, d], transitions: [
+            Transition(label: "x", source: a.id, target: b.id),
+            Transition(label: "y", source: a.id, target: c.id),
+            Transition(label: "true", source: b.id, target: b.id),
+            Transition(label: "true", source: c.id, target: a.id)
+        ], suspendState: nil)
+        let layout = fsm.layeredLayout()
+        let centres = [a, b, c, d].compactMap { layout.states[$0.id]?.closedLayout }
+        XCTAssertEqual(centres.count, 4)
+        XCTAssertLessThan(centres[0].y, centres[1].y)
+        XCTAssertEqual(centres[1].y, centres[2].y)
+        XCTAssertNotEqual(centres[1].x, centres[2].x)
+        XCTAssertGreaterThan(centres[3].y, centres[1].y, "unreachable states need to be in a trailing layer")
+        XCTAssertEqual(layout.transitions.count, 4)
+        XCTAssertTrue(layout.transitions.values.allSatisfy { $0.points.count == 4 })
+        let below = fsm.layeredLayout(top: 1000)
+        XCTAssertEqual(below.states[a.id]?.closedLayout.y, centres[0].y + 1000)
+    }
+
+    func testEditing() throws {
+        let machine = Machine()
+        let a = try machine.addState(named: "A")
+        let b = try machine.addState(named: "B")
+        XCTAssertThrowsError(try machine.addState(named: "A"))
+        let t = try machine.addTransition(label: "x", from: a, to: b)
+        let u = try machine.addTransition(label: "z", from: a, to: a)
+        machine.boilerplate.setSection(named: "variables", to: "int count;")
+        XCTAssertTrue(machine.isStructureDirty)
+        let wrapper = MachineWrapper(for: machine, named: "M.machine")
+        try machine.update(wrapper, isSuspensible: false)
+        XCTAssertFalse(machine.isStructureDirty)
+        XCTAssertTrue(machine.dirtyStates.isEmpty)
+        XCTAssertNil(wrapper.fileWrappers?["Machine_M_Batch.c"])
+        try machine.relabelTransition(t, to: "machine->count > 1")
+        try machine.removeTransition(u)
+        XCTAssertEqual(machine.dirtyStates, [a])
+        XCTAssertFalse(machine.isStructureDirty)
+        try machine.update(wrapper, isSuspensible: false)
+        XCTAssertEqual(wrapper.stringContents(of: "State_A_Transition_0.expr"), "machine->count > 1\n")
+        XCTAssertNil(wrapper.fileWrappers?["State_A_Transition_1.expr"], "removed transitions must not leave stale guards")
+        XCTAssertNotNil(wrapper.fileWrappers?["Machine_M_Batch.c"], "the machine has become batchable")
+        XCTAssertTrue(wrapper.stringContents(of: "CMakeLists.txt")?.contains("Machine_M_Batch.c") ?? false)
+        try machine.setAction("puts(\"B\");", for: .onEntry, of: b)
+        try machine.update(wrapper, isSuspensible: false)
+        XCTAssertNil(wrapper.fileWrappers?["Machine_M_Batch.c"], "the machine is no longer batchable")
+        XCTAssertNil(wrapper.fileWrappers?["Machine_M_Batch.h"])
+        XCTAssertFalse(wrapper.stringContents(of: "CMakeLists.txt")?.contains("Machine_M_Batch.c") ?? true)
+        XCTAssertTrue(machine.dirtyStates.isEmpty)
+        try machine.removeState(b)
+        XCTAssertTrue(machine.llfsm.transitions.isEmpty)
+        XCTAssertTrue(machine.isStructureDirty)
+        XCTAssertThrowsError(try machine.removeTransition(t))
+    }
+
+    func testIncrementalUpdateScaling() throws {
+        func machine(states count: Int) throws -> (Machine, MachineWrapper, [StateID]) {
+            let machine = Machine()
+            machine.boilerplate.setSection(named: "variables", to: "int count;")
+            let states = try (0..<count).map { try machine.addState(named: "S\($0)") }
+            for (i, state) in states.enumerated() {
+                try machine.addTransition(label: "machine->count > \(i)", from: state, to: states[(i + 1) % count])
+            }
+            try machine.setAction("puts(\"S1\");", for: .onEntry, of: states[1])
+            let wrapper = MachineWrapper(for: machine, named: "M.machine")
+            wrapper.isIntrospectable = true
+            wrapper.isTableDriven = true
+            try machine.update(wrapper, isSuspensible: false)
+            return (machine, wrapper, states)
+        }
+        func regeneratedFiles(in wrapper: MachineWrapper, by edit: () throws -> Void) rethrows -> Set<Filename> {
+            let before = wrapper.fileWrappers ?? [:]
+            try edit()
+            return Set((wrapper.fileWrappers ?? [:]).filter { before[$0.key] !== $0.value }.keys)
+        }
+        let (small, smallWrapper, smallStates) = try machine(states: 4)
+        let (large, largeWrapper, largeStates) = try machine(states: 256)
+        let edited = try regeneratedFiles(in: smallWrapper) {
+            try small.setAction("machine->count++;", for: .onEntry, of: smallStates[0])
+            try small.update(smallWrapper, isSuspensible: false)
+        }
+        XCTAssertEqual(edited, try regeneratedFiles(in: largeWrapper) {
+            try large.setAction("machine->count++;", for: .onEntry, of: largeStates[0])
+            try large.update(largeWrapper, isSuspensible: false)
+        }, "a one-state edit must not regenerate more files in a larger machine")
+        XCTAssertFalse(edited.contains("Machine_M_Table.c") || edited.contains("Machine_M_Introspection.c"), "actions are not part of the tables")
+        XCTAssertEqual(largeWrapper.batchAnalysis?.unbatchableStates, [largeStates[1]], "only the edited state gets re-examined")
+        let relabelled = try regeneratedFiles(in: largeWrapper) {
+            try large.relabelTransition(large.llfsm.transitionsFrom(largeStates[0])[0], to: "machine->count < 0")
+            try large.update(largeWrapper, isSuspensible: false)
+        }
+        XCTAssertTrue(relabelled.isSuperset(of: ["Machine_M_Table.c", "Machine_M_Introspection.c"]))
+        XCTAssertFalse(large.isTransitionDirty)
+    }
+
+    func testCMakePackage() throws {
+        let fsm = LLFSM(states: [State(id: StateID(), name: "A")], transitions: [], suspendState: nil)
+        let fragment = cMakeFragment(for: fsm, named: "M", isSuspensible: false)
+        XCTAssertTrue(fragment.contains("string(SHA256 M_FSM_CONTENT_HASH \"${M_FSM_HASH_INPUT}\")"))
+        XCTAssertTrue(fragment.contains("  file(SHA256 ${CMAKE_CURRENT_LIST_DIR}/../Machine_Macros.h M_FSM_FILE_HASH)"))
+        XCTAssertFalse(fragment.contains("Machine_Common.h"))
+        XCTAssertTrue(fragment.contains("get_directory_property(M_FSM_DEFINITIONS COMPILE_DEFINITIONS)"))
+        XCTAssertFalse(fragment.contains("LLFSM_DYNAMIC"))
+        let macros = cArrangementMacroInterface(isSuspensible: true)
+        XCTAssertFalse(macros.contains("LLFSM_ARRANGEMENT_ACTIVE_WORDS") || macros.contains("struct LLFSMArrangement"))
+        XCTAssertTrue(cArrangementMachineInterface(for: [Instance(name: "A", typeFile: "M.machine", fsm: fsm)], named: "T", isSuspensible: true).contains("#include \"Machine_Macros.h\""))
+        XCTAssertTrue(cMakeLists(for: fsm, named: "M", boilerplate: CBoilerplate(), isSuspensible: false).contains("install(EXPORT MTargets"))
+        XCTAssertTrue(cMakePackageConfig(named: "M").contains("set(M_FSM_PACKAGE_HASH \"@M_FSM_CONTENT_HASH@\")"))
+        let instances = [Instance(name: "A", typeFile: "M.machine", fsm: fsm)]
+        let arrangement = cArrangementCMakeLists(for: instances, named: "T", isSuspensible: false, isTraceable: true)
+        let definitions = try XCTUnwrap(arrangement.range(of: "add_compile_definitions(LLFSM_NO_USDT)"))
+        let include = try XCTUnwrap(arrangement.range(of: "include(project.cmake)"))
+        XCTAssertLessThan(definitions.lowerBound, include.lowerBound, "definitions are part of the machine content hashes")
+    }
+
+    func testArrangementInstances() throws {
+        let arrangement = Arrangement(machines: [Machine(), Machine()])
+        let instances = try arrangement.instances(machineNames: ["A.machine", "B"])
+        XCTAssertEqual(instances.map(\.name), ["A", "B"])
+        XCTAssertEqual(arrangement.machineFilenames(of: instances), ["A.machine", "B.machine"])
+        let error = ArrangementError(errors: [(filename: "B.machine", error: FSMError.unsupportedOutputFormat)])
+        XCTAssertEqual(error.description, "B.machine: unsupportedOutputFormat")
+    }
+
+    func testChannel() {
+        let c = Channel(description: "events:int32_t:6:Producer:Consumer")
+        XCTAssertEqual(c?.name, "events")
+        XCTAssertEqual(c?.elementType, "int32_t")
+        XCTAssertEqual(c?.capacity, 8)
+        XCTAssertEqual(c?.producer, "Producer")
+        XCTAssertEqual(c?.consumer, "Consumer")
+        XCTAssertEqual(Channel(name: "c", elementType: "int", capacity: 16, producer: "a", consumer: "b").capacity, 16)
+        XCTAssertNil(Channel(description: "events:int32_t:0:Producer:Consumer"))
+        XCTAssertNil(Channel(description: "events:int32_t:4:Producer"))
+    }
+
+    func testSnapshotVariable() {
+        let v = SnapshotVariable(description: "Sensor.distance")
+        XCTAssertEqual(v?.instance, "Sensor")
+        XCTAssertEqual(v?.name, "distance")
+        XCTAssertNil(SnapshotVariable(description: "distance"))
+        XCTAssertNil(SnapshotVariable(description: "Sensor."))
+        XCTAssertNil(SnapshotVariable(description: "a.b.c"))
+        XCTAssertNil(v?.domain)
+        XCTAssertEqual(SnapshotVariable(description: "Sensor.distance=-1...3")?.domain, -1...3)
+        XCTAssertNil(SnapshotVariable(description: "Sensor.distance=3...1"))
+        XCTAssertNil(SnapshotVariable(description: "Sensor.distance=1..3"))
+    }
+
+    func testRecordCode() throws {
+        let fsm = LLFSM(states: [State(id: StateID(), name: "S")], transitions: [], suspendState: nil)
+        let instances = [Instance(name: "Sensor", typeFile: "M.machine", fsm: fsm)]
+        let variable = try XCTUnwrap(SnapshotVariable(description: "Sensor.distance"))
+        let code = cArrangementRecordCode(for: instances, named: "A", isSuspensible: false, variables: [variable])
+        let lines = code.split(separator: "\n").map { $0.trimmingCharacters(in: .whitespaces) }
+        let buffered = lines.indices.filter { lines[$0].hasPrefix("setvbuf(snapshot_log") }
+        XCTAssertEqual(buffered.count, 2)
+        for i in buffered {
+            XCTAssertTrue(lines[i - 2].hasPrefix("snapshot_log = fopen(path"))
+            XCTAssertEqual(lines[i - 1], "if (!snapshot_log) return false;")
+        }
+    }
+
+    func testAccesses() {
+        XCTAssertEqual(declaredIdentifiers(in: "int a, b[4] = {1, 2};\nstruct foo *c; // comment"), ["a", "b", "c"])
+        let code = "int i = 0; total += i; shared = limit > 0 ? state->x : 0; /* other = 1; */ puts(\"x = y\"); memset(&buffer, 0, 4); a[i] = MAX;"
+        let access = accesses(in: code, locals: ["a"])
+        XCTAssertEqual(access.writes, ["total", "shared", "buffer"])
+        XCTAssertEqual(access.reads, ["total", "limit", "buffer"])
+        XCTAssertEqual(access.calls, ["puts", "memset"])
+        let control = accesses(in: "if (!IS_SUSPENDED(arrangement->fsm_pump)) SUSPEND(&static_fsm_motor); RESTART(machine); static_fsm_motor.speed = 0;", locals: [])
+        XCTAssertEqual(control.writes, ["fsm_motor"])
+        XCTAssertEqual(control.reads, ["arrangement", "fsm_pump", "fsm_motor"])
+        XCTAssertTrue(control.calls.isEmpty)
+        XCTAssertEqual(accesses(in: "RESUME_ALL(); SUSPEND(m);", locals: []).writes, [anyMachine])
+        XCTAssertEqual(MachineAccesses(writes: ["x"]).conflicts(with: MachineAccesses(reads: ["x", "y"])), ["x"])
+        XCTAssertTrue(MachineAccesses(reads: ["x"]).conflicts(with: MachineAccesses(reads: ["x"])).isEmpty)
+    }
+
+    func testBatchable() {
+        XCTAssertEqual(batchVariables(in: "int\tcounter; ///< count\nunsigned long a, b;"), [
+            BatchVariable(type: "int", name: "counter"),
+            BatchVariable(type: "unsigned long", name: "a"),
+            BatchVariable(type: "unsigned long", name: "b")
+        ])
+        XCTAssertNil(batchVariables(in: "const char *machine_name;"))
+        XCTAssertNil(batchVariables(in: "int samples[4];"))
+        let variables: Set<String> = ["counter", "limit"]
+        XCTAssertTrue(isBatchable("machine->counter += 2 * machine->limit;", variables: variables))
+        XCTAssertTrue(isBatchable("machine->counter >= machine->limit", variables: variables, isGuard: true))
+        XCTAssertFalse(isBatchable("machine->counter++", variables: variables, isGuard: true))
+        XCTAssertFalse(isBatchable("printf(\"%d\", machine->counter);", variables: variables))
+        XCTAssertFalse(isBatchable("machine->other = 0;", variables: variables))
+        XCTAssertEqual(batchCode(for: "machine->counter = machine -> limit;"), "counter[i] = limit[i];")
+    }
+
+    func testTableCode() {
+        let r = State(id: StateID(), name: "R")
+        let s = State(id: StateID(), name: "S")
+        let fsm = LLFSM(states: [r, s], transitions: [
+            Transition(label: "done", source: r.id, target: s.id),
+            Transition(label: "true", source: r.id, target: r.id),
+            Transition(label: " done", source: s.id, target: r.id)
+        ], suspendState: nil)
+        let code = cMachineTableCode(for: fsm, named: "M", isSuspensible: false)
+        XCTAssertTrue(code.contains("fsm_m_transition_start[3] = { 0, 2, 3 };"))
+        XCTAssertTrue(code.contains("fsm_m_transition_guard[3] = { 0, 1, 0 };"))
+        XCTAssertTrue(code.contains("fsm_m_transition_target[3] = { 1, 0, 0 };"))
+        XCTAssertFalse(code.contains("State_S_Transition_0.expr"))
+    }
+
+    func testSimulateCode() {
+        let r = State(id: StateID(), name: "R")
+        let s = State(id: StateID(), name: "S")
+        let fsm = LLFSM(states: [r, s], transitions: [Transition(label: "true", source: r.id, target: s.id)], suspendState: nil)
+        let instances = [Instance(name: "Sensor", typeFile: "M.machine", fsm: fsm)]
+        let context = cArrangementContextCode(for: instances, named: "A", isSuspensible: false)
+        XCTAssertTrue(context.contains("void arrangement_a_context_init(struct Arrangement_A_Context * const context)"))
+        XCTAssertTrue(context.contains("states[1] = (struct LLFSMState *)&context->sensor_state_S;"))
+        let channels = [Channel(name: "events", elementType: "int", capacity: 4, producer: "Sensor", consumer: "Sensor")]
+        let replica = cArrangementContextCode(for: instances, named: "A", isSuspensible: true, channels: channels)
+        XCTAssertTrue(replica.contains("atomic_store_explicit(&llfsm_channel_events.head, 0, memory_order_relaxed);"))
+        XCTAssertTrue(replica.contains("atomic_store_explicit(&llfsm_channel_events.tail, 0, memory_order_relaxed);"))
+        XCTAssertTrue(replica.contains("llfsm_activity_epoch = 0;"))
+        XCTAssertFalse(context.contains("llfsm_channel_"))
+        let inputs = [SnapshotVariable(instance: "Sensor", name: "distance", domain: -1...3)]
+        let code = cArrangementSimulateCode(for: instances, named: "A", isSuspensible: false, inputs: inputs)
+        XCTAssertTrue(code.contains("#define SIMULATE_NUMBER_OF_STATES 2"))
+        XCTAssertTrue(code.contains("context->fsm_sensor.distance = -1 + (long long)(simulate_random(rng) % UINT64_C(5));"))
+        XCTAssertTrue(code.contains("\"Sensor.S\""))
+    }
+
+    func testUnrolledCode() {
+        let r = State(id: StateID(), name: "R")
+        let s = State(id: StateID(), name: "S")
+        let fsm = LLFSM(states: [r, s], transitions: [
+            Transition(label: "true", source: r.id, target: s.id),
+            Transition(label: "resume", source: s.id, target: r.id)
+        ], suspendState: s.id)
+        let instances = [Instance(name: "Sensor", typeFile: "M.machine", fsm: fsm)]
+        let code = cStaticArrangementExecuteCode(for: instances, named: "A", isSuspensible: true)
+        XCTAssertTrue(code.contains("void arrangement_a_execute_once(void)"))
+        XCTAssertTrue(code.contains("if (current_state == (struct LLFSMState *)&static_sensor_state_R)"))
+        XCTAssertTrue(code.contains("fsm_m_r_on_entry(machine, state);"))
+        XCTAssertTrue(code.contains("target_state = fsm_m_s_check_transitions(machine, state);"))
+        XCTAssertTrue(code.contains("if (!IS_IDLE(&static_fsm_sensor)) static_sensor_execute_once();"))
+        XCTAssertTrue(code.contains("#if LLFSM_POLL_SUSPENDED"))
+        let table = cStaticArrangementExecuteCode(for: instances, named: "A", isSuspensible: false, isTableDriven: true)
+        XCTAssertTrue(table.contains("fsm_m_r_internal(machine, current_state);"))
+        XCTAssertFalse(table.contains("IS_IDLE"))
+        let benchmark = cStaticArrangementBenchmarkCode(for: instances, named: "A", isSuspensible: false)
+        XCTAssertTrue(benchmark.contains("for (i = 0; i < ringlets; i++) arrangement_a_execute_once();"))
+    }
+
+    func testTraceCode() {
+        let r = State(id: StateID(), name: "R")
+        let s = State(id: StateID(), name: "S")
+        let fsm = LLFSM(states: [r, s], transitions: [Transition(label: "true", source: r.id, target: s.id)], suspendState: s.id)
+        let state = cStateCode(for: r, llfsm: fsm, named: "M", isSuspensible: true, isTraceable: true)
+        XCTAssertTrue(state.contains(") { LLFSM_PROBE_TRANSITION(machine, 0, 1, 0); return machine->states[1]; }"))
+        XCTAssertFalse(cStateCode(for: r, llfsm: fsm, named: "M", isSuspensible: true).contains("LLFSM_PROBE"))
+        let instances = [Instance(name: "Sensor", typeFile: "M.machine", fsm: fsm)]
+        XCTAssertTrue(cArrangementMacroInterface(isSuspensible: true, isTraceable: true).contains("#include <sys/sdt.h>"))
+        let common = cArrangementMachineCode(for: instances, named: "A", isSuspensible: true, isTraceable: true)
+        XCTAssertTrue(common.contains("LLFSM_PROBE_RINGLET_START(machine, current_state);"))
+        XCTAssertTrue(common.contains("LLFSM_PROBE_SUSPEND(machine, machine->previous_state);"))
+        let script = cArrangementTransitionsScript(for: instances, named: "A", isSuspensible: true)
+        XCTAssertTrue(script.contains("usdt:./run_A_arrangement:llfsm:transition"))
+    }
+
+    func testInlineCode() {
+        let r = State(id: StateID(), name: "R")
+        let s = State(id: StateID(), name: "S")
+        let fsm = LLFSM(states: [r, s], transitions: [Transition(label: "x > 0", source: r.id, target: s.id)], suspendState: nil)
+        let sources = ["State_R_OnEntry.mm": "x = 1;\ny = 2;\n", "State_R_Transition_0.expr": "x > 0\n"]
+        let code = cStateCode(for: r, llfsm: fsm, named: "M", isSuspensible: false, inlining: sources)
+        XCTAssertFalse(code.contains("#include \"State_R_OnEntry.mm\""))
+        XCTAssertTrue(code.contains("#line 1 \"State_R_OnEntry.mm\"\nx = 1;\ny = 2;\n#line "))
+        XCTAssertTrue(code.contains("#line 1 \"State_R_Transition_0.expr\"\nx > 0\n"))
+        XCTAssertTrue(code.contains("#line 1 \"State_R_OnExit.mm\"\n#line "))
+        let lines = code.split(separator: "\n", omittingEmptySubsequences: false)
+        let restores = lines.enumerated().filter { $0.element.hasSuffix("\"State_R.c\"") }
+        XCTAssertEqual(restores.count, 4)
+        for (i, line) in restores {
+            XCTAssertEqual(line.trimmingCharacters(in: .whitespaces), "#line \(i + 2) \"State_R.c\"")
+        }
+        XCTAssertTrue(cStateCode(for: r, llfsm: fsm, named: "M", isSuspensible: false).contains("#   include \"State_R_OnEntry.mm\""))
+    }
+
+    func testArrangementOptions() throws {
+        let machine = Machine()
+        machine.llfsm = LLFSM(states: [State(id: StateID(), name: "S")], transitions: [], suspendState: nil)
+        let arrangement = Arrangement(machines: [machine])
+        let instances = try arrangement.instances(machineNames: ["M"])
+        let optional = ["Arrangement_A_Dynamic.c", "Arrangement_A_Export.c", "monitor_main.c", "Arrangement_A_Checkpoint.c", "Arrangement_A_Context.c", "explore_main.c", "simulate_main.c", "Arrangement_A_Partition.h", "benchmark_main.c"]
+        let plain = ArrangementWrapper(for: arrangement, named: "A.arrangement", language: CBinding())
+        try arrangement.add(instances: instances, to: plain, language: CBinding())
+        XCTAssertNotNil(plain.fileWrappers?["Machine_Common.c"])
+        XCTAssertTrue(optional.allSatisfy { plain.fileWrappers?[$0] == nil })
+        let cmake = try XCTUnwrap(plain.stringContents(of: "CMakeLists.txt"))
+        XCTAssertFalse(cmake.contains("LLFSM_DYNAMIC") || cmake.contains("SHM_EXPORT") || cmake.contains("A_EXPLORE") || cmake.contains("A_SIMULATE") || cmake.contains("A_BENCHMARK"))
+        XCTAssertFalse(try XCTUnwrap(plain.stringContents(of: "project.cmake")).contains("Arrangement_A_Checkpoint.c"))
+        XCTAssertFalse(try XCTUnwrap(plain.stringContents(of: "Machine_Common.h")).contains("fsm_arrangement_checkpoint"))
+        let explorable = ArrangementWrapper(for: arrangement, named: "A.arrangement", language: CBinding())
+        explorable.isExplorable = true
+        try arrangement.add(instances: instances, to: explorable, language: CBinding())
+        XCTAssertEqual(optional.filter { explorable.fileWrappers?[$0] != nil }, ["Arrangement_A_Checkpoint.c", "Arrangement_A_Context.c", "explore_main.c"])
+        XCTAssertTrue(try XCTUnwrap(explorable.stringContents(of: "CMakeLists.txt")).contains("option(A_EXPLORE \"Build the reachable-configuration explorer for A\" ON)"))
+        XCTAssertTrue(try XCTUnwrap(explorable.stringContents(of: "project.cmake")).contains("    Arrangement_A_Context.c"))
+        XCTAssertTrue(try XCTUnwrap(explorable.stringContents(of: "Machine_Common.h")).contains("bool fsm_arrangement_restore("))
+        let full = ArrangementWrapper(for: arrangement, named: "A.arrangement", language: CBinding())
+        full.isReloadable = true
+        full.isExportable = true
+        full.isCheckpointable = true
+        full.isSimulatable = true
+        full.isPartitioned = true
+        full.isBenchmarkable = true
+        try arrangement.add(instances: instances, to: full, language: CBinding())
+        XCTAssertEqual(optional.filter { full.fileWrappers?[$0] == nil }, ["explore_main.c"])
+        XCTAssertTrue(try XCTUnwrap(full.stringContents(of: "CMakeLists.txt")).contains("if(A_SHM_EXPORT)"))
+    }
+
+    func testExportCode() {
+        let fsm = LLFSM(states: [State(id: StateID(), name: "R"), State(id: StateID(), name: "S")], transitions: [], suspendState: nil)
+        let instances = [Instance(name: "Sensor", typeFile: "M.machine", fsm: fsm)]
+        let interface = cArrangementExportInterface(for: instances, named: "A", isSuspensible: false)
+        XCTAssertTrue(interface.contains("#define ARRANGEMENT_A_SHM_NAME \"/llfsm_a\""))
+        XCTAssertTrue(interface.contains("struct Arrangement_A_Exported_Machine machines[ARRANGEMENT_A_SHM_INSTANCES];"))
+        let code = cArrangementExportCode(for: instances, named: "A", isSuspensible: false)
+        XCTAssertTrue(code.contains("atomic_store_explicit(&exported->sequence, sequence + 1, memory_order_relaxed);"))
+        XCTAssertTrue(code.contains("atomic_store_explicit(&exported->sequence, sequence + 2, memory_order_release);"))
+        let monitor = cArrangementMonitorCode(for: instances, named: "A", isSuspensible: false)
+        XCTAssertTrue(monitor.contains("static const char * const sensor_states[] ="))
+        XCTAssertTrue(monitor.contains("while ((before & 1) || before != after);"))
+    }
+
+    func testReloadCode() {
+        let fsm = LLFSM(states: [State(id: StateID(), name: "S")], transitions: [], suspendState: nil)
+        let instances = [Instance(name: "Sensor", typeFile: "M.machine", fsm: fsm), Instance(name: "Other", typeFile: "N.machine", fsm: fsm)]
+        XCTAssertTrue(cArrangementDynamicInterface(for: instances, named: "A", isSuspensible: true).contains("bool arrangement_a_reload(struct Arrangement_A * const arrangement, uintptr_t instance, const char * const path);"))
+        let code = cArrangementDynamicCode(for: instances, named: "A", isSuspensible: true)
+        XCTAssertTrue(code.contains("extern const struct LLFSMModule llfsm_module_m;"))
+        XCTAssertTrue(code.contains("\"llfsm_module_n\""))
+        XCTAssertTrue(code.contains("extern struct Arrangement_A static_arrangement_a __attribute__((weak));"))
+        XCTAssertTrue(code.contains("|| arrangement == &static_arrangement_a) return false;"))
+        XCTAssertTrue(code.contains("module && module != loaded_modules[instance] && module->abi_version"), "reloading the running module must fail")
+        XCTAssertTrue(code.contains("machine->resume_state = resume != UINT32_MAX ? machine->states[resume] : NULL;"))
+        XCTAssertFalse(cArrangementDynamicCode(for: instances, named: "A", isSuspensible: false).contains("resume_state"))
+    }
+
+    func testCheckpointCode() {
+        let fsm = LLFSM(states: [State(id: StateID(), name: "R"), State(id: StateID(), name: "S")], transitions: [], suspendState: nil)
+        let instances = [Instance(name: "Sensor", typeFile: "M.machine", fsm: fsm), Instance(name: "Other", typeFile: "M.machine", fsm: fsm)]
+        let code = cArrangementCheckpointCode(for: instances, named: "A", isSuspensible: true)
+        XCTAssertTrue(code.contains("#include \"M.machine/State_S.h\""))
+        XCTAssertTrue(code.contains("#define CHECKPOINT_SIZE_M (sizeof(uint32_t[4]) + sizeof(uint64_t) + VARIABLES_SIZE(struct Machine_M, states) \\"))
+        XCTAssertTrue(code.contains("    + VARIABLES_SIZE(struct FSMM_State_R, on_resume) \\"))
+        XCTAssertEqual(code.components(separatedBy: "    + CHECKPOINT_SIZE_M\n").count, 3)
+        XCTAssertTrue(cArrangementCheckpointCode(for: instances, named: "A", isSuspensible: false).contains("VARIABLES_SIZE(struct FSMM_State_R, internal)"))
+    }
+
+    func testCheckpointHash() throws {
+        let machine = Machine()
+        let s = try machine.addState(named: "S")
+        machine.boilerplate.setSection(named: "variables", to: "int count;")
+        let instances = [Instance(name: "Counter", typeFile: "M.machine", fsm: machine.llfsm)]
+        let arrangement = Arrangement(machines: [machine])
+        let hash = {
+            cArrangementCheckpointCode(for: instances, named: "A", isSuspensible: false, variables: ["M": variableDeclarations(of: arrangement.machineTypes(of: instances)["M.machine"]!)])
+                .split(separator: "\n").first { $0.hasPrefix("#define CHECKPOINT_STRUCTURE_HASH") }
+        }
+        let initial = hash()
+        XCTAssertNotNil(initial)
+        XCTAssertEqual(hash(), initial)
+        machine.boilerplate.setSection(named: "variables", to: "long count;")
+        let machineChanged = hash()
+        XCTAssertNotEqual(machineChanged, initial)
+        machine.stateBoilerplate[s]?.setSection(named: "variables", to: "int n;")
+        XCTAssertNotEqual(hash(), machineChanged)
+    }
+
+    func testPartitionCode() throws {
+        let fsm = LLFSM(states: [State(id: StateID(), name: "S")], transitions: [], suspendState: nil)
+        let instances = [Instance(name: "Sensor", typeFile: "M.machine", fsm: fsm), Instance(name: "Other", typeFile: "M.machine", fsm: fsm)]
+        let analysis = AccessAnalysis(instances: [(name: "Sensor", machine: Machine()), (name: "Other", machine: Machine())])
+        let code = cArrangementPartitionInterface(for: instances, named: "A", isSuspensible: false, analysis: analysis)
+        XCTAssertTrue(code.contains("#define ARRANGEMENT_A_NUMBER_OF_PARTITIONS 2"))
+        XCTAssertTrue(code.contains("#define ARRANGEMENT_A_PARTITIONS { 0, 1 }"))
+        XCTAssertTrue(code.contains("#define ARRANGEMENT_A_PARTITION_OTHER 1"))
+        XCTAssertTrue(code.contains("// No conflicts between instances."))
+        XCTAssertTrue(code.contains("static inline void arrangement_a_execute_partition(struct Arrangement_A * const arrangement, const unsigned partition)"))
+        XCTAssertTrue(code.contains("if (partitions[i] == partition) llfsm_execute_once(arrangement->machines[i]);"))
+        let controller = Machine()
+        let s = try controller.addState(named: "S")
+        controller.stateBoilerplate[s]?.setSection(named: "onEntry", to: "SUSPEND(&static_fsm_other);")
+        let controlled = AccessAnalysis(instances: [(name: "Sensor", machine: controller), (name: "Other", machine: Machine())])
+        XCTAssertEqual(controlled.partitions, [0, 0])
+        XCTAssertEqual(controlled.conflicts.first?.identifiers, ["fsm_other"])
+    }
+
+    func testExploreCode() {
+        let fsm = LLFSM(states: [State(id: StateID(), name: "R"), State(id: StateID(), name: "S")], transitions: [], suspendState: nil)
+        let instances = [Instance(name: "Sensor", typeFile: "M.machine", fsm: fsm)]
+        let inputs = [SnapshotVariable(instance: "Sensor", name: "distance", domain: 0...1)]
+        let code = cArrangementExploreCode(for: instances, named: "A", isSuspensible: false, inputs: inputs)
+        XCTAssertTrue(code.contains("#include \"Arrangement_A_Context.h\""))
+        XCTAssertTrue(code.contains("configuration_size = fsm_arrangement_checkpoint_size();"))
+        XCTAssertTrue(code.contains("fsm_arrangement_restore(arrangement, frontier + i * configuration_size, configuration_size);"))
+        XCTAssertTrue(code.contains("maximum BFS depth %ju"))
+        let channels = [Channel(name: "events", elementType: "int", capacity: 4, producer: "Sensor", consumer: "Sensor")]
+        let checkpoint = cArrangementCheckpointCode(for: instances, named: "A", isSuspensible: false, channels: channels)
+        XCTAssertTrue(checkpoint.contains("    + sizeof(uint64_t) + sizeof(llfsm_channel_events.buffer) \\"))
+        XCTAssertTrue(checkpoint.contains("p = checkpoint_channel_events(p);"))
+        XCTAssertTrue(checkpoint.contains("p = restore_channel_events(p);"))
+        XCTAssertTrue(checkpoint.contains("&llfsm_channel_events.buffer[(head + i) & 3]"))
+        XCTAssertNotEqual(checkpoint.split(separator: "\n").first { $0.contains("CHECKPOINT_STRUCTURE_HASH UINT64_C") },
+                          cArrangementCheckpointCode(for: instances, named: "A", isSuspensible: false).split(separator: "\n").first { $0.contains("CHECKPOINT_STRUCTURE_HASH UINT64_C") })
+    }
+
+    func testArrangementWrite() throws {
+        let machine = Machine()
+        machine.llfsm = LLFSM(states: [State(id: StateID(), name: "S")], transitions: [], suspendState: nil)
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString, isDirectory: true)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let wrapper = ArrangementWrapper(directoryWithFileWrappers: ["M.machine": MachineWrapper(for: machine, named: "M.machine")], for: Arrangement(machines: [machine]), named: "A.arrangement", language: CBinding())
+        try wrapper.write(to: directory.appendingPathComponent("B.arrangement"), options: .withNameUpdating)
+        XCTAssertEqual(wrapper.filename, "B.arrangement")
+        XCTAssertEqual(wrapper.fileWrappers?["M.machine"]?.filename, "M.machine")
+        XCTAssertEqual(wrapper.fileWrappers?["CMakeLists.txt"]?.filename, "CMakeLists.txt")
+        for file in ["C.arrangement", "C.arrangement.tar"] {
+            let extra = ArrangementWrapper(directoryWithFileWrappers: ["M.machine": MachineWrapper(for: machine, named: "M.machine"), "N.machine": MachineWrapper(for: machine, named: "N.machine")], for: Arrangement(machines: [machine]), named: "C.arrangement", language: CBinding())
+            XCTAssertThrowsError(try extra.write(to: directory.appendingPathComponent(file)), file) {
+                XCTAssertEqual(($0 as? ArrangementError)?.errors.map { $0.error as? FSMError }, [.unknownMachine])
+            }
+        }
+    }
+
+    func testArchive() throws {
+        let longName = String(repeating: "d", count: 120)
+        let nested = FileWrapper(directoryWithFileWrappers: ["State_\(longName).c": fileWrapper(named: "State_\(longName).c", from: "long\n")])
+        nested.preferredFilename = longName
+        let tree = FileWrapper(directoryWithFileWrappers: ["M.h": fileWrapper(named: "M.h", from: "#define M\n"), longName: nested])
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString, isDirectory: true)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: directory) }
+        for file in ["M.machine.tar"] + (ArchiveFormat.isCompressionAvailable ? ["M.machine.tar.zst"] : []) {
+            let url = directory.appendingPathComponent(file)
+            let format = try XCTUnwrap(ArchiveFormat(url: url))
+            try tree.writeArchive(to: url, format: format, named: "M.machine")
+            let (name, children) = try directoryContents(at: url)
+            XCTAssertEqual(name, "M.machine")
+            XCTAssertEqual(children["M.h"]?.regularFileContents, Data("#define M\n".utf8))
+            XCTAssertEqual(children[longName]?.fileWrappers?["State_\(longName).c"]?.regularFileContents, Data("long\n".utf8))
+        }
+        let compressed = directory.appendingPathComponent("T.machine.tzst")
+        if ArchiveFormat.isCompressionAvailable {
+            try tree.writeArchive(to: compressed, format: .tzst, named: "T.machine")
+            let data = try Data(contentsOf: compressed)
+            try data.dropLast(4).write(to: compressed)
+            XCTAssertThrowsError(try directoryContents(at: compressed), "truncated frame")
+        } else {
+            XCTAssertThrowsError(try tree.writeArchive(to: compressed, format: .tzst, named: "T.machine"))
+            XCTAssertFalse(FileManager.default.fileExists(atPath: compressed.path), "no empty archive must be left behind")
+        }
+        XCTAssertEqual(TarWriter.suffix(of: "aé", length: 2), "é")
+        XCTAssertEqual(TarWriter.suffix(of: "éa", length: 2), "a")
+        var archive = Data()
+        var writer = TarWriter { archive.append($0) }
+        try writer.append(file: "M.h", contents: Data("#define M\n".utf8))
+        try writer.finish()
+        var gnu = archive
+        gnu.replaceSubrange(257..<265, with: Data("ustar  \0".utf8))
+        gnu.replaceSubrange(345..<349, with: Data("1234".utf8))
+        XCTAssertNotNil(try tarFileWrappers(from: gnu)["M.h"], "GNU headers store the access time instead of a prefix")
+        var link = archive
+        link[156] = UInt8(ascii: "2")
+        XCTAssertThrowsError(try tarFileWrappers(from: link), "symbolic links must not be dropped silently")
+        XCTAssertNil(ArchiveFormat(url: URL(fileURLWithPath: "M.machine")))
+        XCTAssertEqual(ArchiveFormat.directoryName(of: URL(fileURLWithPath: "out.tzst")), "out")
+    }
+
+    func testExecutor() throws {
+        let a = State(id: StateID(), name: "A")
+        let b = State(id: StateID(), name: "B")
+        let suspended = State(id: StateID(), name: "Suspended")
+        let fsm = LLFSM(states: [a, b, suspended], transitions: [Transition(label: "n >= 2", source: a.id, target: b.id)], suspendState: suspended.id)
+        var executor = try LLFSMExecutor(compiling: fsm, context: [String](), actions: { state in
+            LLFSMStateActions(onEntry: { $0.append("entry " + state.name) }, onExit: { $0.append("exit " + state.name) }, internal: { $0.append("internal " + state.name) }, onSuspend: { $0.append("suspend " + state.name) }, onResume: { $0.append("resume " + state.name) })
+        }, guards: { _ in { $0.filter { $0.hasPrefix("internal") }.count >= 2 } })
+        executor.execute(ringlets: 3)
+        XCTAssertEqual(executor.currentStateName, "B")
+        XCTAssertEqual(executor.context, ["entry A", "internal A", "internal A", "exit A"])
+        executor.context = []
+        XCTAssertTrue(executor.suspend())
+        executor.executeOnce()
+        XCTAssertTrue(executor.isIdle)
+        XCTAssertTrue(executor.resume())
+        executor.executeOnce()
+        XCTAssertEqual(executor.context, ["suspend B", "suspend Suspended", "entry Suspended", "internal Suspended", "resume Suspended", "resume B", "entry B", "internal B"])
+        var arrangement = LLFSMArrangementExecutor(machines: [executor, executor])
+        arrangement.suspendAll()
+        arrangement.execute(ringlets: 2)
+        XCTAssertFalse(arrangement.machines[0].isSuspended)
+        XCTAssertTrue(arrangement.machines[1].isIdle)
+        XCTAssertEqual(arrangement.machines[1].ringlets, executor.ringlets + 1)
+        arrangement.machines[0].suspend()
+        arrangement.resumeAll()
+        XCTAssertTrue(arrangement.machines[0].isSuspended, "the first machine is excepted by default")
+        XCTAssertFalse(arrangement.machines[1].isSuspended)
+        arrangement.restartAll(except: 1)
+        XCTAssertEqual(arrangement.machines[0].currentStateName, "A")
+        XCTAssertEqual(arrangement.machines[1].currentStateName, "B")
+    }
+
+    func testCStringLiteral() {
+        XCTAssertEqual("x > 0".cStringLiteral, "\"x > 0\"")
+        XCTAssertEqual("a\"b\\c\nd".cStringLiteral, "\"a\\\"b\\\\c\\nd\"")
+        XCTAssertEqual("\u{1}".cStringLiteral, "\"\\001\"")
+    }
+
+    func testFNV1aHash() {
+        XCTAssertEqual(fnv1aHash(of: ""), 0xcbf29ce484222325)
+        XCTAssertEqual(fnv1aHash(of: "a"), 0xaf63dc4c8601ec8c)
+        XCTAssertNotEqual(fnv1aHash(of: "Counter:A"), fnv1aHash(of: "Counter:B"))
+    }
 }
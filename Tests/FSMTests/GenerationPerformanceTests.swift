@@ -0,0 +1,58 @@
+import XCTest
+@testable import FSM
+
+/// Benchmarks for generating the files of large machines.
+final class GenerationPerformanceTests: XCTestCase {
+    func testBulkFileWrappers() throws {
+        let machine = Machine()
+        try machine.addState(named: "A")
+        let wrapper = MachineWrapper(for: machine, named: "M.machine")
+        wrapper.replaceFileWrapper(fileWrapper(named: "Extra.txt", from: "kept"))
+        try machine.add(to: wrapper, isSuspensible: false)
+        XCTAssertEqual(wrapper.stringContents(of: "Extra.txt"), "kept")
+        XCTAssertNotNil(wrapper.fileWrappers?["State_A.h"])
+        XCTAssertNotNil(wrapper.fileWrappers?["Machine_M.c"])
+    }
+
+    func testGenerate5kStates() throws {
+        let machine = largeMachine(states: 5000)
+        measure {
+            let wrapper = MachineWrapper(for: machine, named: "Large.machine")
+            XCTAssertNoThrow(try machine.add(to: wrapper, isSuspensible: false))
+            XCTAssertNotNil(wrapper.fileWrappers?["State_S4999.h"])
+        }
+    }
+
+    func testLayout10kStates() {
+        let count = 10_000
+        let states = (0..<count).map { State(id: StateID(), name: "S\($0)") }
+        let transitions = states.indices.flatMap { i in [
+            Transition(label: "true", source: states[i].id, target: states[(i + 1) % count].id),
+            Transition(label: "x", source: states[i].id, target: states[(7 * i + 3) % count].id)
+        ] }
+        let fsm = LLFSM(states: states, transitions: transitions, suspendState: nil)
+        measure {
+            let layout = fsm.layeredLayout()
+            XCTAssertEqual(layout.states.count, count)
+            XCTAssertEqual(layout.transitions.count, 2 * count)
+        }
+    }
+}
+
+/// Return a machine with a ring of states.
+///
+/// - Parameter count: The number of states.
+/// - Returns: A machine where each state transitions to the next.
+func largeMachine(states count: Int) -> Machine {
+    let machine = Machine()
+    let states = (0..<count).map { State(id: StateID(), name: "S\($0)") }
+    let transitions = states.indices.map {
+        Transition(label: "true", source: states[$0].id, target: states[($0 + 1) % count].id)
+    }
+    machine.llfsm = LLFSM(states: states, transitions: transitions, suspendState: nil)
+    for (i, state) in states.enumerated() {
+        machine.stateLayout[state.id] = StateLayout(index: i)
+        machine.stateBoilerplate[state.id] = CBoilerplate()
+    }
+    return machine
+}
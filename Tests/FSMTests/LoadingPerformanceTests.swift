@@ -0,0 +1,151 @@
+import XCTest
+@testable import FSM
+
+/// Regression tests loading machines from pathological inputs.
+///
+/// Each test runs a generated adversarial input at a base size
+/// and at eight times that size, and checks that the number of
+/// bytes examined while loading grows no more than linearly.
+final class LoadingPerformanceTests: XCTestCase {
+    func testLongTransitionCountLine() {
+        assertLinear(base: 1 << 17) { n in
+            let header = "numberOfTransitions" + String(repeating: " ret", count: n) + "\nvirtual int numberOfTransitions() const { return 3; }\n"
+            XCTAssertEqual(numberOfCTransitionsIn(header: header), 3)
+            XCTAssertEqual(numberOfObjCPPTransitionsIn(header: header), 3)
+        }
+    }
+
+    func testLongTransitionTargetLine() {
+        assertLinear(base: 1 << 15) { n in
+            let header = String(repeating: "Transition_0 int toState ", count: n) + "\nState_S_Transition_0(int toState = 2): CLTransition(toState) {}\n"
+            XCTAssertEqual(targetStateIndexOfCTransition(0, inHeader: header), 2)
+            XCTAssertEqual(targetStateIndexOfObjCPPTransition(0, inHeader: header), 2)
+            XCTAssertEqual(transitionTargetIndices(inHeader: header)[0], 2)
+        }
+    }
+
+    func testTransitionNumberBoundary() {
+        let header = "State_S_Transition_12(int toState = 3)\nState_S_Transition_1(int toState = 1)\n"
+        XCTAssertEqual(targetStateIndexOfCTransition(1, inHeader: header), 1)
+        XCTAssertEqual(transitionTargetIndices(inHeader: header), [12: 3, 1: 1])
+    }
+
+    func testManyTransitions() {
+        assertLinear(base: 500) { n in
+            let machine = fuzzMachineWrapper(fuzzInput(states: 8, transitions: n))
+            XCTAssertEqual(machine?.llfsm.transitions.count, n)
+            let targets = machine.map { m in m.llfsm.transitions.compactMap { m.llfsm.transitionMap[$0]?.target } }
+            XCTAssertEqual(targets?.last, machine?.llfsm.states[(n - 1) % 8])
+        }
+    }
+
+    func testHugeTransitionCount() {
+        let machine = fuzzMachineWrapper(fuzzInput(files: [
+            ("States", "S\n"),
+            ("State_S.h", "int numberOfTransitions() { return 999999999999; }\n")
+        ]))
+        XCTAssertEqual(machine?.llfsm.states.count, 1)
+        XCTAssertLessThanOrEqual(machine?.llfsm.transitions.count ?? 0, 2)
+    }
+
+    func testDeepBoilerplate() {
+        assertLinear(base: 1 << 14) { n in
+            let deep = String(repeating: "{", count: n) + String(repeating: "}", count: n)
+            let lines = String(repeating: "x++;\n", count: n)
+            let machine = fuzzMachineWrapper(fuzzInput(files: [
+                ("Language", "c\n"),
+                ("States", "S\n"),
+                ("State_S.h", lines + "numberOfTransitions return 0\n"),
+                ("State_S_OnEntry.mm", deep),
+                ("State_S_Internal.mm", lines)
+            ]))
+            XCTAssertEqual(machine?.llfsm.states.count, 1)
+        }
+    }
+
+    func testRandomInputs() {
+        var rng = UInt64(1)
+        for _ in 0..<200 {
+            let bytes = (0..<Int(splitMix64(&rng) % 4096)).map { _ -> UInt8 in
+                let r = splitMix64(&rng)
+                return r % 8 == 0 ? 0 : UInt8(truncatingIfNeeded: r >> 8)
+            }
+            let prefix = Data("States\0S\nT\0State_S.h\0".utf8)
+            fuzzMachineWrapper(Data(bytes))
+            fuzzMachineWrapper(prefix + Data(bytes))
+        }
+    }
+}
+
+/// Assert that the given body runs in linear time.
+///
+/// This counts the bytes examined by the header scanners
+/// rather than measuring time, so the result does not depend
+/// on the load of the machine running the tests.  Eight times
+/// the input may examine at most sixteen times as many bytes,
+/// whereas a quadratic scan would examine about 64 times as many.
+/// Bytes are only counted in debug builds, so release builds
+/// merely run the body for both sizes.
+///
+/// - Parameters:
+///   - base: The base input size.
+///   - body: The body to run for a given input size.
+func assertLinear(base: Int, file: StaticString = #filePath, line: UInt = #line, _ body: (Int) -> Void) {
+#if DEBUG
+    let small = examinedBytes { body(base) }
+    let large = examinedBytes { body(8 * base) }
+    XCTAssertGreaterThan(small, 0, "nothing was scanned for \(base)", file: file, line: line)
+    XCTAssertLessThanOrEqual(large, 16 * small, "\(8 * base) examined \(large) bytes vs. \(small) for \(base)", file: file, line: line)
+#else
+    body(base)
+    body(8 * base)
+#endif
+}
+
+#if DEBUG
+/// Return the number of bytes examined by the header scanners.
+///
+/// - Parameter block: The block to run.
+/// - Returns: The number of bytes the block examined.
+func examinedBytes(_ block: () -> Void) -> Int {
+    let start = scannedBytes.value
+    block()
+    return scannedBytes.value - start
+}
+#endif
+
+/// Return the fuzzer input for a machine with many transitions.
+///
+/// - Parameters:
+///   - states: The number of states.
+///   - transitions: The number of transitions leaving the first state.
+/// - Returns: The input for `MachineWrapper(fuzzInput:)`.
+func fuzzInput(states: Int, transitions: Int) -> Data {
+    let names = (0..<states).map { "S\($0)" }
+    let header = "int numberOfTransitions() { return \(transitions); }\n" + (0..<transitions).map {
+        "State_S0_Transition_\($0)(int toState = \($0 % states)): CLTransition(toState) {}\n"
+    }.joined()
+    return fuzzInput(files: [("States", names.joined(separator: "\n")), ("State_S0.h", header)] + (0..<transitions).map {
+        ("State_S0_Transition_\($0).expr", "x == \($0)")
+    })
+}
+
+/// Return the fuzzer input for the given files.
+///
+/// - Parameter files: The names and contents of the files.
+/// - Returns: The input for `MachineWrapper(fuzzInput:)`.
+func fuzzInput(files: [(String, String)]) -> Data {
+    Data(files.map { name, contents in name + "\0" + contents + "\0" }.joined().utf8)
+}
+
+/// Return the next SplitMix64 pseudo-random number.
+///
+/// - Parameter state: The state of the generator.
+/// - Returns: A pseudo-random number.
+func splitMix64(_ state: inout UInt64) -> UInt64 {
+    state &+= 0x9e3779b97f4a7c15
+    var z = state
+    z = (z ^ (z >> 30)) &* 0xbf58476d1ce4e5b9
+    z = (z ^ (z >> 27)) &* 0x94d049bb133111eb
+    return z ^ (z >> 31)
+}